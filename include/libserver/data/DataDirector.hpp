@@ -64,6 +64,16 @@ public:
 
   //! Ticks the director.
   void Tick();
+  //! Returns the time point of the next scheduled job, the storages wake the director up.
+  //! @returns Time point of the next tick.
+  [[nodiscard]] Scheduler::Clock::time_point GetNextTickTime();
+  //! Sets the handler called when work is queued for the director,
+  //! so that it can be ticked right away instead of in its next periodic tick.
+  //! @param wakeHandler Wake handler.
+  void SetWakeHandler(const Scheduler::WakeHandler& wakeHandler);
+  //! Returns the retrieve epoch, which advances whenever the retrievals of any of the storages complete.
+  //! @returns Retrieve epoch.
+  [[nodiscard]] uint64_t GetRetrieveEpoch() const noexcept;
 
   //! Requests a load of user data.
   //! @param userName Name of the user.
@@ -267,26 +267,47 @@ public:
     ProcessDeleteQueue();
   }
 
+  //! Returns the retrieve epoch, which advances whenever queued retrievals complete.
+  //! @returns Retrieve epoch.
+  [[nodiscard]] uint64_t GetRetrieveEpoch() const noexcept
+  {
+    return _retrieveEpoch.load(std::memory_order::acquire);
+  }
+
+  //! Sets the handler called when an operation is requested, so that the owner
+  //! can tick the storage right away. Must be set before the operations are requested.
+  //! @param wakeHandler Wake handler.
+  void SetWakeHandler(std::function<void()> wakeHandler)
+  {
+    _wakeHandler = std::move(wakeHandler);
+  }
+
 private:
   void RequestRetrieve(const Key& key)
   {
-    std::scoped_lock lock(_retrieveQueue.mutex);
-    _retrieveQueue.data.insert(key);
-    _retrieveQueue.dataFlag.store(true, std::memory_order::relaxed);
+    Request(_retrieveQueue, key);
   }
 
   void RequestStore(const Key& key)
   {
-    std::scoped_lock lock(_storeQueue.mutex);
-    _storeQueue.data.insert(key);
-    _storeQueue.dataFlag.store(true, std::memory_order::relaxed);
+    Request(_storeQueue, key);
   }
 
   void RequestDelete(const Key& key)
   {
-    std::scoped_lock lock(_deleteQueue.mutex);
-    _deleteQueue.data.insert(key);
-    _deleteQueue.dataFlag.store(true, std::memory_order::relaxed);
+    Request(_deleteQueue, key);
+  }
+
+  void Request(auto& queue, const Key& key)
+  {
+    {
+      std::scoped_lock lock(queue.mutex);
+      queue.data.insert(key);
+      queue.dataFlag.store(true, std::memory_order::relaxed);
+    }
+
+    if (_wakeHandler)
+      _wakeHandler();
   }
 
   void ProcessRetrieveQueue()
@@ -316,6 +337,8 @@ private:
       }
     }
     _retrieveQueue.data.clear();
+
+    _retrieveEpoch.fetch_add(1, std::memory_order::release);
   }
 
   void ProcessStoreQueue()
@@ -376,6 +399,8 @@ private:
   };
 
   Queue _retrieveQueue;
+  //! Count of the processed batches of the retrieve queue.
+  std::atomic<uint64_t> _retrieveEpoch{0};
   Queue _storeQueue;
   Queue _deleteQueue;
 
@@ -385,6 +410,9 @@ private:
   DataSourceRetrieveListener _dataSourceRetrieveListener;
   DataSourceStoreListener _dataSourceStoreListener;
   DataSourceDeleteListener _dataSourceDeleteListener;
+
+  //! A handler called when an operation is requested.
+  std::function<void()> _wakeHandler;
 };
 
 } // namespace server
@@ -0,0 +1,456 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#ifndef FRAMED_TRANSPORT_HPP
+#define FRAMED_TRANSPORT_HPP
+
+#include "libserver/Constants.hpp"
+#include "libserver/network/Server.hpp"
+#include "libserver/network/TrafficCapture.hpp"
+#include "libserver/util/Stream.hpp"
+#include "libserver/util/Util.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <format>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace server::network
+{
+
+//! A raw handler of the frames of a command.
+using RawFrameHandler = std::function<void(ClientId, SourceStream&)>;
+
+//! A writer of the command data of a frame.
+using FrameWriter = std::function<void(SinkStream&)>;
+
+//! A decoded header of a frame.
+struct FrameHeader
+{
+  //! ID of the command.
+  uint16_t commandId{};
+  //! Size of the whole frame, including the header.
+  std::size_t frameSize{};
+};
+
+//! Commands decoded from the received data of a client, waiting to be dispatched.
+struct DecodedCommands
+{
+  //! A decoded command.
+  struct Command
+  {
+    //! ID of the command.
+    uint16_t commandId{};
+    //! Offset of the command data within the data of the commands.
+    std::size_t offset{};
+    //! Size of the command data.
+    std::size_t size{};
+  };
+
+  //! Commands in the order they were received.
+  std::vector<Command> commands;
+  //! Data of the commands, one after another.
+  std::vector<std::byte> data;
+};
+
+//! Policy describing the framing and the obfuscation of a protocol.
+//!
+//! The policy declares the per-client obfuscation state, the size of the header,
+//! the max size of a frame and the count of the commands, and it implements
+//! the coding of the headers and the obfuscation of the frames.
+template <typename T>
+concept FramingPolicy = requires(
+  typename T::ClientState& state,
+  std::span<const std::byte> header,
+  std::span<std::byte> bytes,
+  const FrameHeader& frameHeader,
+  uint16_t commandId)
+{
+  { T::Name } -> std::convertible_to<std::string_view>;
+  { T::HeaderSize } -> std::convertible_to<std::size_t>;
+  { T::MaxFrameSize } -> std::convertible_to<std::size_t>;
+  { T::CommandCount } -> std::convertible_to<std::size_t>;
+  // Decodes and validates a header, throws if the header is malformed.
+  { T::ReadHeader(header) } -> std::same_as<FrameHeader>;
+  // Encodes a header of an outgoing frame.
+  { T::WriteHeader(bytes, frameHeader) };
+  // Decodes the data of an incoming frame in place and returns the command data.
+  { T::DecodeData(state, commandId, bytes) } -> std::same_as<std::span<std::byte>>;
+  // Obfuscates an outgoing frame in place.
+  { T::EncodeFrame(bytes) };
+  { T::GetCommandName(commandId) } -> std::convertible_to<std::string_view>;
+  // Whether the debug logs of the command are muted.
+  { T::IsMuted(commandId) } -> std::convertible_to<bool>;
+  // Whether the command carries credentials, which are not to be captured.
+  { T::HasCredentials(commandId) } -> std::convertible_to<bool>;
+  // Redacts the credentials of a copy of the command data and returns the redacted data.
+  { T::RedactCredentials(commandId, bytes) } -> std::same_as<std::span<std::byte>>;
+};
+
+//! A framed transport of commands.
+//!
+//! Implements the framing shared by the command protocols on top of the `network::Server`,
+//! that is the reassembly of the frames from the received data, their in-place decoding,
+//! the capture of the decoded commands, the dispatch of the commands to their handlers
+//! and the encoding of the outgoing frames. The protocols differ only by their policy.
+//!
+//! The frames are read and decoded on the strand of the client, while the decoded commands
+//! are dispatched on the event strand of the server, so that the handlers run one at a time.
+//!
+//! @tparam Policy Framing policy of the protocol.
+template <FramingPolicy Policy>
+class FramedTransport
+{
+public:
+  using ClientState = typename Policy::ClientState;
+
+  FramedTransport()
+    : _commands(Policy::CommandCount)
+  {
+    for (std::size_t index = 0; index < _commands.size(); ++index)
+    {
+      const auto commandId = static_cast<uint16_t>(index);
+      auto& command = _commands[index];
+      command.name = Policy::GetCommandName(commandId);
+      command.isMuted = Policy::IsMuted(commandId);
+      command.hasCredentials = Policy::HasCredentials(commandId);
+    }
+  }
+
+  //! Registers a raw handler of a command.
+  //! @param commandId ID of the command.
+  //! @param handler Handler of the command.
+  //! @throws std::runtime_error If the command ID is out of the range of the handler table.
+  void RegisterHandler(
+    const uint16_t commandId,
+    RawFrameHandler handler)
+  {
+    if (commandId >= _commands.size())
+    {
+      throw std::runtime_error(
+        std::format(
+          "The {} command ID {} is out of the range of the handler table",
+          Policy::Name,
+          commandId));
+    }
+
+    _commands[commandId].handler = std::move(handler);
+  }
+
+  //! Reads the frames buffered whole, decodes them in place and appends their commands
+  //! to the decoded commands. A frame which is not buffered whole is left in the data
+  //! until more data arrive.
+  //! @param state Obfuscation state of the client.
+  //! @param data Received data.
+  //! @param decoded Decoded commands, appended to.
+  //! @returns Count of the bytes consumed from the data.
+  //! @throws std::runtime_error If a frame is malformed.
+  std::size_t ReadFrames(
+    ClientState& state,
+    const std::span<std::byte> data,
+    DecodedCommands& decoded)
+  {
+    std::size_t cursor = 0;
+
+    // Do not continue if the buffered data do not contain a whole header.
+    while (data.size() - cursor >= Policy::HeaderSize)
+    {
+      const auto header = Policy::ReadHeader(
+        std::span<const std::byte>(data.subspan(cursor, Policy::HeaderSize)));
+
+      // The frame must be at least the size of the header and at most the max size.
+      if (header.frameSize < Policy::HeaderSize || header.frameSize > Policy::MaxFrameSize)
+      {
+        throw std::runtime_error(
+          std::format(
+            "Invalid {} frame: Bad frame size '{}'",
+            Policy::Name,
+            header.frameSize));
+      }
+
+      // If the frame is not buffered whole, wait for the rest of it to arrive.
+      if (data.size() - cursor < header.frameSize)
+        break;
+
+      // The frame data, processed in place within the received data.
+      const auto frameData = data.subspan(
+        cursor + Policy::HeaderSize,
+        header.frameSize - Policy::HeaderSize);
+      cursor += header.frameSize;
+
+      const auto commandData = Policy::DecodeData(state, header.commandId, frameData);
+
+      if (debugIncomingCommandData
+        && not GetCommand(header.commandId).isMuted)
+      {
+        spdlog::debug("Read data for {} command '{}' (0x{:X}),\n\n"
+          "Frame data size: {},\n"
+          "Command data size: {}\n"
+          "Processed data dump: \n\n{}\n",
+          Policy::Name,
+          GetCommand(header.commandId).name,
+          header.commandId,
+          frameData.size(),
+          commandData.size(),
+          util::GenerateByteDump(commandData));
+      }
+
+      // The command data are copied out, as the received data are reused by the next read.
+      decoded.commands.emplace_back(DecodedCommands::Command{
+        .commandId = header.commandId,
+        .offset = decoded.data.size(),
+        .size = commandData.size()});
+      decoded.data.insert(decoded.data.end(), commandData.begin(), commandData.end());
+    }
+
+    return cursor;
+  }
+
+  //! Captures the decoded commands and dispatches them to their handlers,
+  //! in the order they were received. The commands are captured in the order
+  //! they are handled, along with the connection events of the clients.
+  //! @param clientId ID of the client which sent the commands.
+  //! @param decoded Decoded commands.
+  void Dispatch(
+    const ClientId clientId,
+    const DecodedCommands& decoded)
+  {
+    for (const auto& command : decoded.commands)
+    {
+      const auto commandData = std::span(decoded.data).subspan(command.offset, command.size);
+
+      // Capture the decoded command, without the credentials it carries.
+      if (_trafficRecorder.IsRecording())
+      {
+        if (GetCommand(command.commandId).hasCredentials)
+        {
+          std::vector<std::byte> redactedData(commandData.begin(), commandData.end());
+          _trafficRecorder.Record(
+            clientId,
+            command.commandId,
+            Policy::RedactCredentials(command.commandId, redactedData));
+        }
+        else
+        {
+          _trafficRecorder.Record(clientId, command.commandId, commandData);
+        }
+      }
+
+      SourceStream commandDataSource(commandData);
+      Dispatch(clientId, command.commandId, commandDataSource);
+    }
+  }
+
+  //! Dispatches the command to its handler.
+  //! @param clientId ID of the client which sent the command.
+  //! @param commandId ID of the command.
+  //! @param commandDataSource Stream of the decoded command data.
+  void Dispatch(
+    const ClientId clientId,
+    const uint16_t commandId,
+    SourceStream& commandDataSource)
+  {
+    const auto& command = GetCommand(commandId);
+
+    if (not command.handler)
+    {
+      if (debugCommands
+        && not command.isMuted)
+      {
+        spdlog::warn(
+          "Unhandled {} command '{}' (0x{:x})",
+          Policy::Name,
+          command.name,
+          commandId);
+      }
+
+      return;
+    }
+
+    try
+    {
+      command.handler(clientId, commandDataSource);
+    }
+    catch (const std::exception& x)
+    {
+      spdlog::error(
+        "Unhandled exception handling {} command '{}' (0x{:x}): {}",
+        Policy::Name,
+        command.name,
+        commandId,
+        x.what());
+    }
+
+    // There shouldn't be any left-over data in the stream.
+    assert(commandDataSource.GetCursor() == commandDataSource.Size());
+
+    if (debugCommands
+      && not command.isMuted)
+    {
+      spdlog::debug(
+        "Handled {} command '{}' (0x{:x})",
+        Policy::Name,
+        command.name,
+        commandId);
+    }
+  }
+
+  //! Encodes a command to a frame.
+  //! The commands of a known size are written directly to a frame of the exact size,
+  //! the other commands are written to a scratch buffer and copied to a frame.
+  //! @param commandId ID of the command.
+  //! @param writer Writer of the command data.
+  //! @param commandDataSize Size of the command data, if known.
+  //! @returns Encoded frame.
+  //! @throws std::exception If the writer fails or writes other than the known size.
+  [[nodiscard]] WriteBuffer EncodeFrame(
+    const uint16_t commandId,
+    const FrameWriter& writer,
+    const std::optional<std::size_t> commandDataSize) const
+  {
+    WriteBuffer frame;
+
+    if (commandDataSize)
+    {
+      const std::size_t frameSize = Policy::HeaderSize + *commandDataSize;
+      if (frameSize > Policy::MaxFrameSize)
+      {
+        throw std::overflow_error(
+          std::format(
+            "The {} command '{}' of size {} is over the size limit",
+            Policy::Name,
+            GetCommand(commandId).name,
+            frameSize));
+      }
+
+      frame.resize(frameSize);
+
+      SinkStream frameSink(frame);
+      frameSink.Seek(Policy::HeaderSize);
+
+      // Write the command data.
+      writer(frameSink);
+
+      if (frameSink.GetCursor() != frameSize)
+      {
+        throw std::runtime_error(
+          std::format(
+            "The {} command '{}' wrote {} bytes instead of the reported {} bytes",
+            Policy::Name,
+            GetCommand(commandId).name,
+            frameSink.GetCursor() - Policy::HeaderSize,
+            *commandDataSize));
+      }
+    }
+    else
+    {
+      // Scratch buffer the command is encoded to,
+      // before it is copied to a frame of the exact size.
+      thread_local std::array<std::byte, Policy::MaxFrameSize> scratchBuffer;
+
+      SinkStream scratchSink(scratchBuffer);
+      scratchSink.Seek(Policy::HeaderSize);
+
+      // Write the command data.
+      writer(scratchSink);
+
+      frame.assign(
+        scratchBuffer.begin(),
+        scratchBuffer.begin() + scratchSink.GetCursor());
+    }
+
+    if (debugOutgoingCommandData
+      && not GetCommand(commandId).isMuted)
+    {
+      spdlog::debug("Write data for {} command '{}' (0x{:X}),\n\n"
+        "Command data size: {} \n"
+        "Data dump: \n\n{}\n",
+        Policy::Name,
+        GetCommand(commandId).name,
+        commandId,
+        frame.size() - Policy::HeaderSize,
+        util::GenerateByteDump(
+          std::span(frame).subspan(Policy::HeaderSize)));
+    }
+
+    Policy::WriteHeader(
+      std::span(frame).first(Policy::HeaderSize),
+      FrameHeader{
+        .commandId = commandId,
+        .frameSize = frame.size()});
+    Policy::EncodeFrame(frame);
+
+    return frame;
+  }
+
+  //! Returns the recorder of the inbound traffic.
+  //! @returns Traffic recorder.
+  [[nodiscard]] TrafficRecorder& GetTrafficRecorder() noexcept
+  {
+    return _trafficRecorder;
+  }
+
+  bool debugIncomingCommandData = constants::DebugCommands;
+  bool debugOutgoingCommandData = constants::DebugCommands;
+  bool debugCommands = constants::DebugCommands;
+
+private:
+  //! A command of the protocol.
+  struct Command
+  {
+    //! Name of the command.
+    std::string_view name{"n/a"};
+    //! Whether the debug logs of the command are muted.
+    bool isMuted{false};
+    //! Whether the command carries credentials, which are not to be captured.
+    bool hasCredentials{false};
+    //! Handler of the command, if registered.
+    RawFrameHandler handler;
+  };
+
+  //! Returns the command from its ID.
+  //! @param commandId ID of the command.
+  //! @returns Command, or the unknown command if the ID is out of the range of the table.
+  [[nodiscard]] const Command& GetCommand(const uint16_t commandId) const noexcept
+  {
+    static const Command UnknownCommand{};
+    return commandId < _commands.size()
+      ? _commands[commandId]
+      : UnknownCommand;
+  }
+
+  //! Commands of the protocol indexed by the command IDs.
+  //! The traits of a command are copied from the policy on construction,
+  //! so that its dispatch looks up a single entry along with its handler.
+  std::vector<Command> _commands;
+  //! Recorder of the inbound traffic.
+  TrafficRecorder _trafficRecorder;
+};
+
+} // namespace server::network
+
+#endif // FRAMED_TRANSPORT_HPP
@@ -27,9 +27,12 @@
 #include <cstdint>
 #include <deque>
 #include <functional>
-#include <queue>
+#include <memory>
+#include <mutex>
 #include <span>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <boost/asio.hpp>
 
@@ -38,10 +41,56 @@ namespace server::network
 
 namespace asio = boost::asio;
 
-//! A write handler.
-using WriteSupplier = std::function<size_t(asio::streambuf&)>;
+//! A buffer of encoded data to write.
+using WriteBuffer = std::vector<std::byte>;
+//! An immutable buffer of encoded data to write,
+//! which may be shared by writes of multiple clients.
+using SharedWriteBuffer = std::shared_ptr<const WriteBuffer>;
 
+//! Priority of a write, decides which writes are dropped
+//! when the client does not keep up with the written data.
+enum class WritePriority
+{
+  //! The write is always delivered.
+  Reliable,
+  //! The write may be dropped under backpressure,
+  //! for example a stale state snapshot superseded by the next one.
+  Droppable,
+};
+
+//! Limits of the outbound write queue of a client.
+struct WriteQueueLimits
+{
+  //! High-water mark of queued bytes.
+  //! Above it, droppable writes are dropped.
+  std::size_t highWaterBytes = 256 * 1024;
+  //! High-water mark of queued messages.
+  //! Above it, droppable writes are dropped.
+  std::size_t highWaterMessages = 512;
+  //! Max queued bytes. Above it, the client is disconnected.
+  std::size_t maxBytes = 1024 * 1024;
+  //! Max queued messages. Above it, the client is disconnected.
+  std::size_t maxMessages = 2048;
+};
+
+//! Statistics of the outbound write queue.
+struct WriteQueueStats
+{
+  //! Bytes queued and being written.
+  std::size_t queuedBytes{};
+  //! Messages queued and being written.
+  std::size_t queuedMessages{};
+  //! Count of writes dropped under backpressure.
+  std::size_t droppedMessages{};
+  //! Bytes queued and being written by the single slowest client.
+  std::size_t maxQueuedBytes{};
+};
+
+//! Handler of the network events of a server.
 //!
+//! The network ticks and the connection events are handled on the event strand
+//! of the server, one at a time. The data of a client are handled on the strand
+//! of the client, so the data of different clients might be handled concurrently.
 class EventHandlerInterface
 {
 public:
@@ -59,32 +108,56 @@ public:
   virtual void OnClientDisconnected(ClientId clientId) = 0;
 
   //! Handler of client data event.
+  //! The handler may modify the data in place, for example to decode it,
+  //! and posts the handling of the decoded data to the event strand of the server.
   //! @param clientId ID of the client that sent the data.
   //! @param data Byte buffer of the data sent.
   //! @returns Count of bytes consumed from the byte buffer.
   virtual size_t OnClientData(
     ClientId clientId,
-    const std::span<const std::byte>& data) = 0;
+    const std::span<std::byte>& data) = 0;
 };
 
 //! Client with event driven reads and writes
 //! to the underlying socket connection.
+//! All the asynchronous operations of the client are serialized
+//! on the strand of its socket, so the order of reads and writes
+//! of a connection is kept even when the server runs multiple I/O threads.
 class Client : public std::enable_shared_from_this<Client>
 {
 public:
   //! Default constructor.
   //! @param socket Underlying socket (remote address is read from it).
+  //!               The executor of the socket is expected to be a strand.
+  //! @param writeQueueLimits Limits of the outbound write queue.
   explicit Client(
     ClientId clientId,
     asio::ip::tcp::socket&& socket,
-    EventHandlerInterface& networkEventHandler) noexcept;
+    EventHandlerInterface& networkEventHandler,
+    const WriteQueueLimits& writeQueueLimits = {}) noexcept;
 
   //! Begins the client's asynchronous read loop.
   void Begin();
   //! Ends the client's asynchronous read loop.
   void End();
-  //! Queues a write.
-  void QueueWrite(WriteSupplier writeSupplier);
+  //! Queues a write of encoded data.
+  //! Queued buffers are gathered and written to the socket together.
+  //! Above the high-water marks of the write queue, droppable writes are dropped
+  //! and above the max limits the client is disconnected.
+  //! @param writeBuffer Buffer with the data to write.
+  //! @param priority Priority of the write.
+  void QueueWrite(
+    WriteBuffer writeBuffer,
+    WritePriority priority = WritePriority::Reliable);
+  //! Queues a write of encoded data shared with other writes.
+  //! The buffer is kept alive until it is written to the socket.
+  //! @param writeBuffer Shared buffer with the data to write.
+  //! @param priority Priority of the write.
+  void QueueWrite(
+    SharedWriteBuffer writeBuffer,
+    WritePriority priority = WritePriority::Reliable);
+  //! Returns statistics of the outbound write queue.
+  [[nodiscard]] WriteQueueStats GetWriteQueueStats();
   //!
   asio::ip::address_v4 GetAddress() const noexcept;
   //!
@@ -97,18 +170,44 @@ private:
 
   //! Indicates whether the client should process I/O.
   std::atomic<bool> _shouldRun = false;
+  //! Indicates whether an eviction of the client over the write queue limit is posted.
+  std::atomic<bool> _isEvictionPending = false;
 
-  //! A mutex for write buffer.
+  //! A queued write.
+  struct QueuedWrite
+  {
+    SharedWriteBuffer buffer;
+    WritePriority priority;
+  };
+
+  //! Limits of the outbound write queue.
+  const WriteQueueLimits _writeQueueLimits;
+
+  //! A mutex for the write queue and its statistics.
   std::mutex _writeMutex;
-  //! A queue of write suppliers.
-  std::queue<WriteSupplier> _writeQueue{};
-  std::condition_variable _writeCv{};
-  //! A write buffer.
-  asio::streambuf _writeBuffer{};
-  std::atomic<bool> _isSending = false;
+  //! A queue of buffers waiting to be written.
+  std::vector<QueuedWrite> _writeQueue{};
+  //! Statistics of the write queue, including the write in progress.
+  WriteQueueStats _writeQueueStats{};
+  //! Buffers of the write in progress.
+  //! Accessed only from the strand of the client.
+  std::vector<QueuedWrite> _writeBatch{};
+  //! Size of the write in progress.
+  //! Accessed only from the strand of the client.
+  std::size_t _writeBatchBytes{};
+  //! Buffer sequence of the write in progress.
+  //! Accessed only from the strand of the client.
+  std::vector<asio::const_buffer> _writeBufferSequence{};
+  //! Indicates whether a write is in progress.
+  //! Accessed only from the strand of the client.
+  bool _isSending = false;
 
   //! A read buffer.
-  asio::streambuf _readBuffer{};
+  std::vector<std::byte> _readBuffer{};
+  //! Size of the data in the read buffer.
+  std::size_t _readBufferSize{};
+  //! Size of the next read, grows with the size of the received data.
+  std::size_t _readSize;
 
   //! A unique-identifier of the client.
   ClientId _clientId;
@@ -140,10 +239,13 @@ public:
   //!
   //! @param address Address of the interface to bind to.
   //! @param port Port to bind to.
+  //! @param ioThreadCount Count of threads running the I/O context,
+  //!                      including the current thread.
   //! @throw std::runtime_error
   void Begin(
     const asio::ip::address& address,
-    uint16_t port);
+    uint16_t port,
+    uint32_t ioThreadCount = 1);
 
   //! Ends the server.
   void End();
@@ -151,10 +253,30 @@ public:
   //! Get client.
   std::shared_ptr<Client> GetClient(ClientId clientId);
 
+  //! Finds a client.
+  //! @returns Client, or `nullptr` if the client is not connected.
+  std::shared_ptr<Client> FindClient(ClientId clientId);
+
+  //! Sets the interval of the network ticks, must be set before the server begins.
+  //! @param tickInterval Interval of the network ticks.
+  void SetTickInterval(std::chrono::steady_clock::duration tickInterval);
+
+  //! Sets the limits of the outbound write queue of newly accepted clients.
+  //! @param writeQueueLimits Limits.
+  void SetWriteQueueLimits(const WriteQueueLimits& writeQueueLimits);
+
+  //! Returns the statistics of the outbound write queues summed over all the clients.
+  [[nodiscard]] WriteQueueStats GetWriteQueueStats();
+
+  //! Posts a task to the event strand of the server,
+  //! which serializes it with the network ticks and the connection events.
+  //! @param task Task to post.
+  void PostEvent(std::function<void()> task);
+
   void HandleNetworkTick() override;
   void OnClientConnected(ClientId clientId) override;
   void OnClientDisconnected(ClientId clientId) override;
-  size_t OnClientData(ClientId clientId, const std::span<const std::byte>& data) override;
+  size_t OnClientData(ClientId clientId, const std::span<std::byte>& data) override;
 
 private:
   struct AddressState
@@ -169,15 +291,25 @@ private:
   void OnThrottleDisconnect(const asio::ip::address_v4& address) noexcept;
 
   asio::io_context _io_ctx;
+  //! A strand of the network ticks, the connection events and the handling of the data.
+  asio::strand<asio::io_context::executor_type> _eventStrand;
   asio::ip::tcp::acceptor _acceptor;
   asio::steady_timer _timer;
+  //! Interval of the network ticks.
+  std::chrono::steady_clock::duration _tickInterval = std::chrono::seconds(1);
+  //! Additional threads running the I/O context.
+  std::vector<std::thread> _ioThreads;
 
+  //! A mutex for the clients and the address states.
+  std::mutex _clientsMutex;
   //! Sequential client ID.
   ClientId _client_id = 0;
   //! Map of clients.
   std::unordered_map<ClientId, std::shared_ptr<Client>> _clients;
   //! Per-address state for connection throttling.
   std::unordered_map<asio::ip::address_v4, AddressState> _addressStates;
+  //! Limits of the outbound write queue of the clients.
+  WriteQueueLimits _writeQueueLimits{};
 
   //! A network event handler.
   EventHandlerInterface& _networkEventHandler;
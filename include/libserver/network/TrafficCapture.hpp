@@ -0,0 +1,175 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#ifndef ALICIA_SERVER_TRAFFICCAPTURE_HPP
+#define ALICIA_SERVER_TRAFFICCAPTURE_HPP
+
+#include "libserver/network/NetworkDefinitions.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace server::network
+{
+
+//! Kind of the protocol of a traffic capture.
+enum class TrafficProtocol : uint8_t
+{
+  Command = 0,
+  Chatter = 1,
+};
+
+//! Header of a traffic capture file.
+struct TrafficCaptureHeader
+{
+  //! Protocol of the captured traffic.
+  TrafficProtocol protocol{TrafficProtocol::Command};
+  //! Name of the captured server, e.g. "lobby".
+  std::string source;
+  //! Time the capture started at, in microseconds since the UNIX epoch.
+  uint64_t startTime{};
+};
+
+//! Kind of a traffic record.
+enum class TrafficRecordKind : uint8_t
+{
+  //! An inbound command.
+  Command = 0,
+  //! A connection of a client.
+  Connect = 1,
+  //! A disconnection of a client.
+  Disconnect = 2,
+};
+
+//! A captured inbound command, or a connection event of a client.
+struct TrafficRecord
+{
+  //! Time of the record, in microseconds since the start of the capture.
+  uint64_t timestamp{};
+  //! ID of the client.
+  ClientId clientId{};
+  //! Kind of the record.
+  TrafficRecordKind kind{TrafficRecordKind::Command};
+  //! ID of the command.
+  uint16_t commandId{};
+  //! Decoded payload of the command.
+  std::vector<std::byte> payload;
+};
+
+//! Records decoded inbound commands and the connection events of the clients
+//! to a binary capture file.
+//!
+//! The file begins with the magic "ACAP", 16-bit version, protocol, source name and start time.
+//! Each record consists of the 64-bit timestamp, 64-bit client ID, 8-bit kind, 16-bit command ID,
+//! 32-bit payload size and the payload. The connection events have no command and no payload.
+//! Values are stored in the host byte order. Records may be written from any thread.
+//!
+//! The captures contain personal data of the players, for example the names of their
+//! characters and the messages of their private chats, and are to be handled accordingly.
+//! The credentials of the login commands are redacted before they are recorded.
+class TrafficRecorder
+{
+public:
+  //! Starts recording to the file, the file is truncated.
+  //! @param path Path of the capture file.
+  //! @param protocol Protocol of the captured traffic.
+  //! @param source Name of the captured server.
+  //! @throws std::runtime_error If the file can't be opened.
+  void Start(
+    const std::filesystem::path& path,
+    TrafficProtocol protocol,
+    const std::string& source);
+
+  //! Stops recording and flushes the file.
+  void Stop();
+
+  //! Returns whether the recorder is recording.
+  [[nodiscard]] bool IsRecording() const noexcept
+  {
+    return _isRecording.load(std::memory_order::relaxed);
+  }
+
+  //! Records a command, if the recorder is recording.
+  //! @param clientId ID of the client which sent the command.
+  //! @param commandId ID of the command.
+  //! @param payload Decoded payload of the command.
+  void Record(
+    ClientId clientId,
+    uint16_t commandId,
+    std::span<const std::byte> payload) noexcept;
+
+  //! Records a connection of a client, if the recorder is recording.
+  //! @param clientId ID of the client.
+  void RecordConnect(ClientId clientId) noexcept;
+
+  //! Records a disconnection of a client, if the recorder is recording.
+  //! @param clientId ID of the client.
+  void RecordDisconnect(ClientId clientId) noexcept;
+
+private:
+  //! Writes a record, if the recorder is recording.
+  void WriteRecord(
+    ClientId clientId,
+    TrafficRecordKind kind,
+    uint16_t commandId,
+    std::span<const std::byte> payload) noexcept;
+
+  //! Indicates whether the recorder is recording.
+  std::atomic<bool> _isRecording{false};
+  //! A mutex for the capture file.
+  std::mutex _mutex;
+  //! Capture file.
+  std::ofstream _file;
+  //! Time point the capture started at.
+  std::chrono::steady_clock::time_point _startTimePoint;
+};
+
+//! Reads the records of a traffic capture file.
+class TrafficCaptureReader
+{
+public:
+  //! Opens the capture file and reads its header.
+  //! @param path Path of the capture file.
+  //! @throws std::runtime_error If the file can't be opened or is not a capture.
+  explicit TrafficCaptureReader(const std::filesystem::path& path);
+
+  //! Returns the header of the capture.
+  [[nodiscard]] const TrafficCaptureHeader& GetHeader() const noexcept;
+
+  //! Reads the next record.
+  //! @returns The record, or empty if there are no more records.
+  //! @throws std::runtime_error If the record is truncated.
+  [[nodiscard]] std::optional<TrafficRecord> Next();
+
+private:
+  std::ifstream _file;
+  TrafficCaptureHeader _header;
+};
+
+} // namespace server::network
+
+#endif // ALICIA_SERVER_TRAFFICCAPTURE_HPP
@@ -0,0 +1,223 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#ifndef UDPRELAY_HPP
+#define UDPRELAY_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+namespace server::network
+{
+
+namespace asio = boost::asio;
+
+//! ID of a relay session, the P2dId the race server assigned to the racer.
+using RelaySessionId = uint16_t;
+//! ID of a relay room, the UID of the room of the race.
+using RelayRoomId = uint32_t;
+//! Token binding the endpoint of a relay session, the race OTP of the racer.
+using RelaySessionToken = uint32_t;
+
+//! Header every relayed datagram starts with.
+//! The datagrams are forwarded unchanged, header included.
+//!
+//! The header and the binding datagrams are a framing of the relay itself,
+//! not the framing of the client, so the relay is an inert prototype
+//! until the datagrams of the client are known.
+struct RelayDatagramHeader
+{
+  //! Session of the sender.
+  RelaySessionId source{};
+  //! Session of the recipient, or `BroadcastSession` for the whole room.
+  RelaySessionId target{};
+
+  //! Target of the datagrams sent to every other session of the room.
+  static constexpr RelaySessionId BroadcastSession = 0xFFFF;
+  //! Size of the header in the datagram.
+  static constexpr std::size_t Size = sizeof(source) + sizeof(target);
+
+  //! Reads the little-endian header of a datagram.
+  //! @param datagram Datagram.
+  //! @returns Header, or an empty optional if the datagram is too short.
+  [[nodiscard]] static std::optional<RelayDatagramHeader> Read(
+    std::span<const std::byte> datagram) noexcept;
+
+  //! Reads the little-endian session token following the header of a binding datagram.
+  //! @param datagram Datagram.
+  //! @returns Token, or an empty optional if the datagram is too short.
+  [[nodiscard]] static std::optional<RelaySessionToken> ReadToken(
+    std::span<const std::byte> datagram) noexcept;
+};
+
+//! Statistics of the relay.
+struct UdpRelayStats
+{
+  //! Count of the datagrams received.
+  uint64_t received{};
+  //! Count of the datagrams sent to the recipients.
+  uint64_t forwarded{};
+  //! Count of the received datagrams which were dropped.
+  uint64_t dropped{};
+};
+
+//! Forwarding tables of the relay.
+//!
+//! A session is registered by the race server with the address of the TCP
+//! connection of its racer and a token known only to the racer. The session is
+//! bound to the endpoint of a binding datagram, which is sent from that address
+//! and carries the token after the header. Datagrams from endpoints other than
+//! the bound one are accepted only as binding datagrams, so the hosts sharing
+//! the address, for example behind a NAT, can not take over the sessions of each
+//! other. The binding datagrams are not forwarded.
+class UdpRelayTable
+{
+public:
+  //! Registers a session in a room, replacing its previous registration.
+  //! @param sessionId ID of the session.
+  //! @param roomId ID of the room.
+  //! @param address Address the datagrams of the session are accepted from,
+  //!                an unspecified address accepts any.
+  //! @param token Token the session is bound with.
+  //! @returns `true` if registered, `false` if the ID is reserved.
+  bool RegisterSession(
+    RelaySessionId sessionId,
+    RelayRoomId roomId,
+    const asio::ip::address_v4& address,
+    RelaySessionToken token);
+
+  //! Unregisters a session.
+  //! @param sessionId ID of the session.
+  void UnregisterSession(RelaySessionId sessionId);
+
+  //! Unregisters all the sessions of a room.
+  //! @param roomId ID of the room.
+  void UnregisterRoom(RelayRoomId roomId);
+
+  //! Routes a datagram, or binds its session if it is a binding datagram.
+  //! @param sender Endpoint the datagram was received from.
+  //! @param header Header of the datagram.
+  //! @param token Token following the header, if the datagram is long enough.
+  //! @param recipients Endpoints to forward the datagram to, appended to.
+  //! @returns `true` if the datagram is routed, `false` if it is to be dropped.
+  bool Route(
+    const asio::ip::udp::endpoint& sender,
+    const RelayDatagramHeader& header,
+    std::optional<RelaySessionToken> token,
+    std::vector<asio::ip::udp::endpoint>& recipients);
+
+  //! Returns the count of the registered sessions.
+  [[nodiscard]] std::size_t GetSessionCount() const;
+
+private:
+  struct Session
+  {
+    RelayRoomId roomId{};
+    asio::ip::address_v4 address;
+    RelaySessionToken token{};
+    std::optional<asio::ip::udp::endpoint> endpoint;
+  };
+
+  //! Erases the session from the members of its room.
+  //! Expects the unique lock to be held.
+  void EraseRoomMember(RelaySessionId sessionId, RelayRoomId roomId);
+
+  //! Appends the endpoints of the recipients of a datagram of the session.
+  //! Expects a lock to be held.
+  //! @returns `true` if there is any recipient, `false` otherwise.
+  bool CollectRecipients(
+    const Session& session,
+    const RelayDatagramHeader& header,
+    std::vector<asio::ip::udp::endpoint>& recipients) const;
+
+  mutable std::shared_mutex _mutex;
+  //! Sessions indexed by their IDs.
+  std::unordered_map<RelaySessionId, Session> _sessions;
+  //! Sessions of the rooms indexed by the room IDs.
+  std::unordered_map<RelayRoomId, std::vector<RelaySessionId>> _rooms;
+};
+
+//! UDP relay forwarding the datagrams of the racers to the other racers of their rooms.
+//!
+//! A single thread receives the datagrams and forwards them. On Linux the
+//! datagrams are received and sent in batches with `recvmmsg` and `sendmmsg`,
+//! on the other platforms one at a time.
+class UdpRelay
+{
+public:
+  UdpRelay();
+  ~UdpRelay();
+
+  UdpRelay(const UdpRelay&) = delete;
+  UdpRelay& operator=(const UdpRelay&) = delete;
+
+  //! Begins the relay on its own thread.
+  //! @param address Address of the interface to bind to.
+  //! @param port Port to bind to, zero for any.
+  //! @throw std::runtime_error
+  void Begin(const asio::ip::address_v4& address, uint16_t port);
+
+  //! Ends the relay, blocks until its thread stops.
+  void End();
+
+  //! Returns the port the relay is bound to.
+  [[nodiscard]] uint16_t GetPort() const;
+
+  //! Returns the forwarding tables.
+  [[nodiscard]] UdpRelayTable& GetTable();
+
+  //! Returns the statistics of the relay.
+  [[nodiscard]] UdpRelayStats GetStats() const;
+
+private:
+  //! Relay loop, receives and forwards datagrams until ended.
+  void RelayLoop() noexcept;
+  //! Receives and forwards a batch of datagrams.
+  void RelayBatch();
+
+  //! Buffers of a batch, defined by the platform.
+  struct Batch;
+
+  asio::io_context _ioContext;
+  asio::ip::udp::socket _socket;
+  std::thread _thread;
+  std::atomic<bool> _shouldRun{false};
+
+  UdpRelayTable _table;
+
+  //! Buffers of the batch, reused between the batches.
+  std::unique_ptr<Batch> _batch;
+
+  std::atomic<uint64_t> _received{};
+  std::atomic<uint64_t> _forwarded{};
+  std::atomic<uint64_t> _dropped{};
+};
+
+} // namespace server::network
+
+#endif // UDPRELAY_HPP
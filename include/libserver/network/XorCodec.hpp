@@ -0,0 +1,73 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#ifndef ALICIA_SERVER_XORCODEC_HPP
+#define ALICIA_SERVER_XORCODEC_HPP
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+namespace server::network
+{
+
+//! A 4-byte XOR key.
+using XorKey = std::array<std::byte, 4>;
+
+//! Kernels of the XOR codec.
+enum class XorKernel
+{
+  //! Byte by byte.
+  Byte,
+  //! 8 bytes at a time.
+  Scalar64,
+  //! 16 bytes at a time.
+  Sse2,
+  //! 32 bytes at a time.
+  Avx2,
+};
+
+//! Returns whether the kernel is supported by the CPU.
+//! @param kernel Kernel.
+//! @returns `true` if the kernel is supported, `false` otherwise.
+[[nodiscard]] bool IsXorKernelSupported(XorKernel kernel) noexcept;
+
+//! Returns the fastest kernel supported by the CPU.
+//! @returns Kernel.
+[[nodiscard]] XorKernel GetBestXorKernel() noexcept;
+
+//! Performs XOR operation on every byte of the data with the repeating key, in place.
+//! The first byte of the data is XORed with the first byte of the key.
+//! Uses the fastest kernel supported by the CPU.
+//!
+//! @param data Data.
+//! @param key Key.
+void XorInPlace(std::span<std::byte> data, const XorKey& key) noexcept;
+
+//! Performs XOR operation on every byte of the data with the repeating key, in place,
+//! using the specified kernel. The kernel must be supported by the CPU.
+//!
+//! @param data Data.
+//! @param key Key.
+//! @param kernel Kernel.
+void XorInPlace(std::span<std::byte> data, const XorKey& key, XorKernel kernel) noexcept;
+
+} // namespace server::network
+
+#endif // ALICIA_SERVER_XORCODEC_HPP
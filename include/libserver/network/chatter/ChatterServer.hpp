@@ -20,17 +20,18 @@
 #ifndef CHATTER_SERVER_HPP
 #define CHATTER_SERVER_HPP
 
+#include "libserver/network/FramedTransport.hpp"
 #include "libserver/network/Server.hpp"
+#include "libserver/network/TrafficCapture.hpp"
 #include "libserver/util/Stream.hpp"
-#include "libserver/Constants.hpp"
-#include "libserver/util/Util.hpp"
 
 #include "proto/ChatterMessageDefinitions.hpp"
 
 #include <spdlog/spdlog.h>
 
 #include <functional>
-#include <unordered_map>
+#include <optional>
+#include <type_traits>
 
 namespace server
 {
@@ -46,7 +47,37 @@ public:
 };
 
 //! A raw command handler.
-using RawChatterCommandHandler = std::function<void(network::ClientId, SourceStream&)>;
+using RawChatterCommandHandler = network::RawFrameHandler;
+
+//! Framing of the chatter protocol.
+//! The frames begin with a header of the frame length and the command ID.
+//! The whole frames are scrambled with a constant code.
+struct ChatterFraming
+{
+  //! The code does not roll, the clients have no state.
+  struct ClientState
+  {
+  };
+
+  static constexpr std::string_view Name = "chatter";
+  static constexpr std::size_t HeaderSize = sizeof(protocol::ChatterCommandHeader);
+  static constexpr std::size_t MaxFrameSize = 4092;
+  //! Count of the commands, the ID of the last command + 1.
+  static constexpr std::size_t CommandCount =
+    static_cast<std::size_t>(protocol::ChatterCommand::ChatCmdChangeLetterOptionAckOk) + 1;
+
+  static network::FrameHeader ReadHeader(std::span<const std::byte> header);
+  static void WriteHeader(std::span<std::byte> header, const network::FrameHeader& frameHeader);
+  static std::span<std::byte> DecodeData(
+    ClientState& state,
+    uint16_t commandId,
+    std::span<std::byte> data);
+  static void EncodeFrame(std::span<std::byte> frame);
+  static std::string_view GetCommandName(uint16_t commandId);
+  static bool IsMuted(uint16_t) noexcept { return false; }
+  static bool HasCredentials(uint16_t) noexcept { return false; }
+  static std::span<std::byte> RedactCredentials(uint16_t, std::span<std::byte> data) noexcept { return data; }
+};
 
 //! Concept for readable command structs.
 template <typename T>
@@ -62,7 +93,10 @@ public:
   explicit ChatterServer(IChatterServerEventsHandler& chatterServerEventsHandler);
   ~ChatterServer();
 
-  void BeginHost(network::asio::ip::address_v4 address, uint16_t port);
+  void BeginHost(
+    network::asio::ip::address_v4 address,
+    uint16_t port,
+    uint32_t ioThreadCount = 1);
   void EndHost();
 
   [[nodiscard]] network::asio::ip::address_v4 GetClientAddress(const network::ClientId clientId) noexcept;
@@ -74,107 +108,95 @@ public:
   void RegisterCommandHandler(
     std::function<void(network::ClientId clientId, const C& command)> handler)
   {
-    _handlers[static_cast<uint16_t>(C::GetCommand())] = 
+    _transport.RegisterHandler(
+      static_cast<uint16_t>(C::GetCommand()),
       [handler](network::ClientId clientId, SourceStream& source)
       {
         C command;
         C::Read(command, source);
         handler(clientId, command);
-      };
+      });
   }
 
-  template<typename T>
-  void QueueCommand(network::ClientId clientId, std::function<T()> commandSupplier)
+  //! Queues a command for sending.
+  //! The command is encoded immediately. The commands reporting their size
+  //! are encoded directly to a frame of the exact size.
+  //! @param clientId ID of the client to send the command to.
+  //! @param commandSupplier Supplier of the command.
+  template <typename T, typename Supplier>
+    requires std::is_invocable_r_v<T, Supplier>
+  void QueueCommand(network::ClientId clientId, const Supplier& commandSupplier)
   {
-    _server.GetClient(clientId)->QueueWrite([this, commandSupplier = std::move(commandSupplier)](
-      network::asio::streambuf& buf)
+    if constexpr (SizedStruct<T>)
     {
-      // todo: this templated function should just write the bytes to the buffer,
-      //       rest of the logic should be moved to non-templated function which deals with buffer directly.
+      const T command = commandSupplier();
+      SendCommand(
+        clientId,
+        static_cast<uint16_t>(T::GetCommand()),
+        [&command](SinkStream& sink)
+        {
+          sink.Write(command);
+        },
+        T::GetEncodedSize(command));
+    }
+    else
+    {
+      SendCommand(
+        clientId,
+        static_cast<uint16_t>(T::GetCommand()),
+        [&commandSupplier](SinkStream& sink)
+        {
+          sink.Write(commandSupplier());
+        });
+    }
+  }
 
-      const auto buffer = buf.prepare(4092);
-      SinkStream bufferSink({
-        static_cast<std::byte*>(buffer.data()),
-        buffer.size()});
+  //! Returns the recorder of the inbound traffic.
+  //! @returns Traffic recorder.
+  [[nodiscard]] network::TrafficRecorder& GetTrafficRecorder() noexcept;
 
-      // reserve the space for the header
-      bufferSink.Write(0);
+  //! Notifies the event handler of a connection of a replayed client.
+  //! @param clientId ID of the replayed client.
+  void ReplayClientConnected(network::ClientId clientId);
 
-      // write the command data
-      T command = commandSupplier();
-      bufferSink.Write(command);
+  //! Notifies the event handler of a disconnection of a replayed client.
+  //! @param clientId ID of the replayed client.
+  void ReplayClientDisconnected(network::ClientId clientId);
 
-      const protocol::ChatterCommandHeader header {
-        .length = static_cast<uint16_t>(bufferSink.GetCursor()),
-        .commandId = static_cast<uint16_t>(T::GetCommand()),};
-
-      if (debugOutgoingCommandData)
-      {
-        spdlog::debug("Write data for command '{}' (0x{:X}),\n\n"
-          "Command data size: {} \n"
-          "Data dump: \n\n{}\n",
-          GetChatterCommandName(T::GetCommand()),
-          static_cast<uint16_t>(T::GetCommand()),
-          header.length,
-          util::GenerateByteDump(
-            std::span(
-              static_cast<std::byte*>(buffer.data()) + sizeof(protocol::ChatterCommandHeader),
-              header.length - sizeof(protocol::ChatterCommandHeader))));
-      }
-
-      bufferSink.Seek(0);
-      bufferSink.Write(header.length)
-        .Write(header.commandId);
-
-      // scramble the message
-      SourceStream bufferSource({
-        static_cast<std::byte*>(buffer.data()),
-        header.length});
-
-      bufferSink.Seek(0);
-
-      constexpr std::array XorCode{
-        static_cast<std::byte>(0x2B),
-        static_cast<std::byte>(0xFE),
-        static_cast<std::byte>(0xB8),
-        static_cast<std::byte>(0x02)};
-
-      while (bufferSource.GetCursor() != bufferSource.Size())
-      {
-        std::byte val;
-        bufferSource.Read(val);
-        val ^= XorCode[(bufferSource.GetCursor() - 1) % 4];
-        bufferSink.Write(val);
-      }
-      
-      if (debugCommands)
-      {
-        spdlog::debug("Sent chatter command message '{}' (0x{:X})",
-          GetChatterCommandName(T::GetCommand()),
-          static_cast<uint16_t>(T::GetCommand()));
-      }
-
-      buf.commit(bufferSource.GetCursor());
-      return bufferSource.GetCursor();
-    });
-  }
+  //! Dispatches a decoded command to its handler, as if it was received from the client.
+  //! Used to replay traffic captures, the responses to replayed clients are discarded.
+  //! @param clientId ID of the replayed client.
+  //! @param commandId ID of the command.
+  //! @param commandData Decoded command data.
+  void ReplayCommand(
+    network::ClientId clientId,
+    uint16_t commandId,
+    std::span<const std::byte> commandData);
 
 private:
   void HandleNetworkTick() override;
   void OnClientConnected(network::ClientId clientId) override;
   void OnClientDisconnected(network::ClientId clientId) override;
-  size_t OnClientData(network::ClientId clientId, const std::span<const std::byte>& data) override;
+  size_t OnClientData(network::ClientId clientId, const std::span<std::byte>& data) override;
+
+  //! Encodes the command and queues it for write to the client.
+  //! @param clientId ID of the client to send the command to.
+  //! @param commandId ID of the command.
+  //! @param writer Writer of the command data.
+  //! @param commandDataSize Size of the command data, if known.
+  void SendCommand(
+    network::ClientId clientId,
+    uint16_t commandId,
+    const std::function<void(SinkStream&)>& writer,
+    std::optional<std::size_t> commandDataSize = std::nullopt);
 
   IChatterServerEventsHandler& _chatterServerEventsHandler;
-  std::unordered_map<uint16_t, RawChatterCommandHandler> _handlers{};
+
+  //! Transport of the chatter frames.
+  network::FramedTransport<ChatterFraming> _transport;
 
   network::Server _server;
   std::thread _serverThread;
-
-  // Debug flags for logging command handling
-  bool debugIncomingCommandData = constants::DebugCommands;
-  bool debugOutgoingCommandData = constants::DebugCommands;
-  bool debugCommands = constants::DebugCommands;
 };
 
 } // namespace server
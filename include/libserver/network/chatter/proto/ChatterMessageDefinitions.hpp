@@ -1273,6 +1273,12 @@ struct ChatCmdChannelChatTrs
     const ChatCmdChannelChatTrs& command,
     SinkStream& stream);
 
+  //! Returns the size of the command in the stream.
+  //! @param command Command.
+  //! @returns Size of the command.
+  static std::size_t GetEncodedSize(
+    const ChatCmdChannelChatTrs& command);
+
   static void Read(
     ChatCmdChannelChatTrs& command,
     SourceStream& stream);
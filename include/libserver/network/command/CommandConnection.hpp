@@ -0,0 +1,146 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#ifndef ALICIA_SERVER_COMMANDCONNECTION_HPP
+#define ALICIA_SERVER_COMMANDCONNECTION_HPP
+
+#include "libserver/network/command/CommandServer.hpp"
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace server
+{
+
+//! Encodes a command frame as sent by a client.
+//! The code is rolled for every command with a payload, the payload is padded
+//! by the amount given by the rolled code and scrambled with it.
+//!
+//! @param commandId ID of the command.
+//! @param payload Payload of the command.
+//! @param code Rolling code of the connection.
+//! @returns Encoded frame.
+[[nodiscard]] std::vector<std::byte> EncodeClientCommand(
+  protocol::Command commandId,
+  std::span<const std::byte> payload,
+  CommandClient& code);
+
+//! A client side connection to a command server.
+//! Handlers are called on the strand of the connection.
+class CommandConnection final
+  : public std::enable_shared_from_this<CommandConnection>
+{
+public:
+  //! A handler of the connection result.
+  using ConnectHandler = std::function<void(bool isConnected)>;
+  //! A handler of the disconnection.
+  using DisconnectHandler = std::function<void()>;
+
+  //! Constructor.
+  //! @param ioContext I/O context the connection runs on.
+  explicit CommandConnection(asio::io_context& ioContext);
+
+  CommandConnection(const CommandConnection&) = delete;
+  CommandConnection& operator=(const CommandConnection&) = delete;
+
+  //! Connects to the command server.
+  //! @param endpoint Endpoint of the command server.
+  //! @param handler Handler of the connection result.
+  void Connect(
+    const asio::ip::tcp::endpoint& endpoint,
+    ConnectHandler handler);
+
+  //! Closes the connection. The disconnect handler is not called.
+  void Close();
+
+  //! Sets the disconnect handler.
+  //! @param handler Handler of the disconnection.
+  void SetDisconnectHandler(DisconnectHandler handler);
+
+  //! Resets the rolling code, as the server does after a successful login.
+  void ResetCode();
+
+  //! Returns the strand of the connection.
+  //! @returns Strand.
+  [[nodiscard]] asio::strand<asio::io_context::executor_type>& GetStrand() noexcept;
+
+  //! Registers a handler of the raw data of a command.
+  //! @param commandId ID of the command.
+  //! @param handler Handler of the command data.
+  void RegisterCommandHandler(
+    protocol::Command commandId,
+    std::function<void(SourceStream& source)> handler);
+
+  //! Registers a command handler.
+  //! @param handler Handler of the command.
+  template <ReadableCommandStruct C>
+  void RegisterCommandHandler(std::function<void(const C& command)> handler)
+  {
+    RegisterCommandHandler(C::GetCommand(), [handler](SourceStream& source)
+    {
+      C command;
+      C::Read(command, source);
+      handler(command);
+    });
+  }
+
+  //! Sends a command.
+  //! The command is encoded and scrambled on the strand of the connection.
+  //! @param command Command.
+  template <WritableCommandStruct C>
+  void Send(const C& command)
+  {
+    SendCommand(C::GetCommand(), [command](SinkStream& sink)
+    {
+      C::Write(command, sink);
+    });
+  }
+
+private:
+  void SendCommand(protocol::Command commandId, CommandWriter writer);
+  void ReadLoop();
+  void WriteLoop();
+  void ProcessReadBuffer();
+  void HandleDisconnect();
+
+  asio::ip::tcp::socket _socket;
+  asio::strand<asio::io_context::executor_type> _strand;
+
+  //! Rolling code of the connection.
+  CommandClient _code;
+  //! Handlers indexed by the command ID.
+  std::vector<std::function<void(SourceStream&)>> _handlers;
+  DisconnectHandler _disconnectHandler;
+
+  //! Received data which were not processed yet.
+  std::vector<std::byte> _readBuffer;
+  std::size_t _readBufferSize{0};
+
+  //! Encoded frames waiting to be written.
+  std::deque<std::vector<std::byte>> _writeQueue;
+  bool _isWriting{false};
+  bool _isClosed{false};
+};
+
+} // namespace server
+
+#endif // ALICIA_SERVER_COMMANDCONNECTION_HPP
@@ -21,25 +21,73 @@
 #define ALICIA_SERVER_COMMANDDEFERRER_HPP
 
 #include "libserver/network/NetworkDefinitions.hpp"
+#include "libserver/util/LatencyHistogram.hpp"
+#include "libserver/util/TickProfile.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <functional>
-#include <list>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <typeinfo>
+#include <unordered_set>
+#include <vector>
+
+#include <spdlog/spdlog.h>
 
 namespace server
 {
 
+//! Metrics of a command deferrer.
+struct CommandDeferrerMetrics
+{
+  //! Count of the deferred commands.
+  std::size_t depth{};
+  //! Count of the resumptions of the commands.
+  uint64_t resumedCount{};
+  //! Time from the deferral of the commands to their completion.
+  LatencyHistogram::Summary waitTime{};
+};
+
 //! Class providing command deferring capability.
+//!
+//! Deferred commands are parked until the data they wait on might have become
+//! available, which is signalled by an advance of the readiness epoch, and are then
+//! resumed in bulk. A command which is still not ready after the max wait is passed
+//! to the expiry handler instead. Commands may be deferred and discarded from any thread,
+//! the deferrer is expected to be ticked from a single thread.
 template <typename C>
 class CommandDeferrer
 {
 public:
-  using Handler = std::function<void(network::ClientId, const C&)>;
+  using Clock = std::chrono::steady_clock;
+
+  //! Handler of a deferred command.
+  //! Returns `true` if the command is still not ready and should stay deferred.
+  using Handler = std::function<bool(network::ClientId, const C&)>;
+  //! Handler of a deferred command which is still not ready after the max wait.
+  using ExpiryHandler = std::function<void(network::ClientId, const C&)>;
+  //! Supplier of the readiness epoch.
+  //! The epoch advances whenever the data the commands wait on might have become available.
+  using ReadinessSupplier = std::function<uint64_t()>;
+
+  //! Default time budget of a tick.
+  static constexpr Clock::duration DefaultTickBudget = std::chrono::milliseconds(5);
+  //! Default interval after which a parked command is resumed even
+  //! if the readiness epoch did not advance.
+  static constexpr Clock::duration DefaultRetryInterval = std::chrono::seconds(1);
 
   //! Default constructor.
-  explicit CommandDeferrer(Handler handler) noexcept
-    : _handler(handler)
+  //! @param handler Handler of the deferred commands.
+  //! @param readinessSupplier Supplier of the readiness epoch.
+  //!                          Without it, the commands are resumed every tick.
+  explicit CommandDeferrer(
+    Handler handler,
+    ReadinessSupplier readinessSupplier = {}) noexcept
+    : _handler(std::move(handler))
+    , _readinessSupplier(std::move(readinessSupplier))
   {
-    _command = _commands.cend();
   }
 
   //! Default destructor
@@ -51,35 +99,185 @@ public:
   CommandDeferrer(CommandDeferrer&&) = delete;
   CommandDeferrer& operator=(CommandDeferrer&&) = delete;
 
+  //! Sets the time budget of a tick. At least one command is resumed per tick.
+  //! @param budget Time budget, zero for unlimited.
+  void SetTickBudget(const Clock::duration budget) noexcept
+  {
+    _tickBudget = budget;
+  }
+
+  //! Sets the interval after which a parked command is resumed even
+  //! if the readiness epoch did not advance.
+  //! @param interval Retry interval.
+  void SetRetryInterval(const Clock::duration interval) noexcept
+  {
+    _retryInterval = interval;
+  }
+
+  //! Sets the max wait of a command since its deferral. A command the handler
+  //! defers again after the max wait is passed to the expiry handler instead.
+  //! @param maxWait Max wait.
+  //! @param expiryHandler Handler of the expired commands.
+  void SetMaxWait(const Clock::duration maxWait, ExpiryHandler expiryHandler) noexcept
+  {
+    _maxWait = maxWait;
+    _expiryHandler = std::move(expiryHandler);
+  }
+
+  //! Resumes the ready commands within the time budget of the tick.
+  //! Exceptions of the handlers are logged and the command is dropped.
   void Tick()
   {
-    // If there's no commands skip.
-    if (_commands.empty())
-      return;
+    std::vector<CommandContext> commands;
+    {
+      std::scoped_lock lock(_commandsMutex);
+      if (_commands.empty())
+        return;
+      commands.swap(_commands);
+      _isTicking = true;
+    }
+
+    const auto tickBegin = Clock::now();
+    const uint64_t epoch = _readinessSupplier ? _readinessSupplier() : 0;
 
-    // If at the end of the commands list
-    // loop back to the beginning.
-    if (_command == _commands.cend())
-      _command = _commands.cbegin();
+    std::vector<CommandContext> parkedCommands;
+    std::size_t resumedCount = 0;
+    const bool isProfiled = TickProfile::IsActive();
+    bool isBudgetSpent = false;
 
-    try
+    for (auto& context : commands)
     {
-      // Call the handler.
-      _handler(_command->clientId, _command->command);
-      _command = _commands.erase(_command);
+      const auto now = Clock::now();
+      if (not isBudgetSpent && _tickBudget != Clock::duration::zero())
+        isBudgetSpent = now - tickBegin >= _tickBudget && resumedCount > 0;
+
+      const bool isReady = not _readinessSupplier
+        || not context.parkedEpoch
+        || *context.parkedEpoch != epoch
+        || now - context.parkedAt >= _retryInterval;
+
+      if (isBudgetSpent || not isReady)
+      {
+        parkedCommands.emplace_back(std::move(context));
+        continue;
+      }
+
+      ++resumedCount;
+      _resumedCount.fetch_add(1, std::memory_order::relaxed);
+
+      bool deferAgain = false;
+      try
+      {
+        deferAgain = _handler(context.clientId, context.command);
+      }
+      catch (const std::exception& x)
+      {
+        spdlog::error(
+          "Exception in a deferred command handler of client {}: {}",
+          context.clientId,
+          x.what());
+      }
+
+      if (deferAgain
+        && _expiryHandler
+        && Clock::now() - context.deferredAt >= _maxWait)
+      {
+        deferAgain = false;
+        try
+        {
+          _expiryHandler(context.clientId, context.command);
+        }
+        catch (const std::exception& x)
+        {
+          spdlog::error(
+            "Exception in a deferred command expiry handler of client {}: {}",
+            context.clientId,
+            x.what());
+        }
+      }
+
+      if (isProfiled)
+        TickProfile::Record("deferred command", typeid(C), Clock::now() - now);
+
+      if (deferAgain)
+      {
+        context.parkedEpoch = epoch;
+        context.parkedAt = Clock::now();
+        parkedCommands.emplace_back(std::move(context));
+        continue;
+      }
+
+      _waitTime.Record(Clock::now() - context.deferredAt);
+      _depth.fetch_sub(1, std::memory_order::relaxed);
     }
-    catch (const std::exception& x)
+
+    std::scoped_lock lock(_commandsMutex);
+    _isTicking = false;
+
+    // The clients discarded during the tick might have had their commands parked again.
+    if (not _discardedClients.empty())
     {
-      _command = _commands.erase(_command);
-      throw x;
+      const auto discardedCount = std::erase_if(
+        parkedCommands,
+        [this](const CommandContext& context)
+        {
+          return _discardedClients.contains(context.clientId);
+        });
+      _depth.fetch_sub(discardedCount, std::memory_order::relaxed);
+      _discardedClients.clear();
     }
+
+    // The commands deferred during the tick are kept after the parked ones.
+    parkedCommands.insert(
+      parkedCommands.end(),
+      std::make_move_iterator(_commands.begin()),
+      std::make_move_iterator(_commands.end()));
+    _commands.swap(parkedCommands);
   }
 
-  void Defer(const network::ClientId clientId, C command) noexcept
+  //! Defers a command, it is resumed in the next tick.
+  //! @param clientId ID of the client.
+  //! @param command Command.
+  void Defer(const network::ClientId clientId, C command)
   {
+    const auto now = Clock::now();
+
+    std::scoped_lock lock(_commandsMutex);
     _commands.emplace_back(CommandContext{
       .clientId = clientId,
-      .command = std::move(command)});
+      .command = std::move(command),
+      .deferredAt = now,
+      .parkedAt = now,
+      .parkedEpoch = std::nullopt});
+    _depth.fetch_add(1, std::memory_order::relaxed);
+  }
+
+  //! Discards the deferred commands of a client, for example when it disconnects.
+  //! The commands taken by a tick in progress are discarded once the tick parks them again.
+  //! @param clientId ID of the client.
+  void Discard(const network::ClientId clientId)
+  {
+    std::scoped_lock lock(_commandsMutex);
+    const auto discardedCount = std::erase_if(
+      _commands,
+      [clientId](const CommandContext& context)
+      {
+        return context.clientId == clientId;
+      });
+    _depth.fetch_sub(discardedCount, std::memory_order::relaxed);
+
+    if (_isTicking)
+      _discardedClients.emplace(clientId);
+  }
+
+  //! Returns the metrics of the deferrer.
+  //! @returns Metrics.
+  [[nodiscard]] CommandDeferrerMetrics GetMetrics() const noexcept
+  {
+    return CommandDeferrerMetrics{
+      .depth = _depth.load(std::memory_order::relaxed),
+      .resumedCount = _resumedCount.load(std::memory_order::relaxed),
+      .waitTime = _waitTime.Summarize()};
   }
 
 private:
@@ -87,11 +285,33 @@ private:
   {
     network::ClientId clientId;
     C command;
+    //! Time point of the deferral of the command.
+    Clock::time_point deferredAt;
+    //! Time point of the last parking of the command.
+    Clock::time_point parkedAt;
+    //! Readiness epoch the command was parked at,
+    //! empty until the command is resumed for the first time.
+    std::optional<uint64_t> parkedEpoch;
   };
 
   Handler _handler;
-  std::list<CommandContext> _commands;
-  decltype(_commands)::const_iterator _command;
+  ReadinessSupplier _readinessSupplier;
+
+  Clock::duration _tickBudget = DefaultTickBudget;
+  Clock::duration _retryInterval = DefaultRetryInterval;
+  Clock::duration _maxWait = Clock::duration::max();
+  ExpiryHandler _expiryHandler;
+
+  std::mutex _commandsMutex;
+  std::vector<CommandContext> _commands;
+  //! Whether a tick is in progress, guarded by the commands mutex.
+  bool _isTicking{false};
+  //! Clients discarded during the tick in progress, guarded by the commands mutex.
+  std::unordered_set<network::ClientId> _discardedClients;
+
+  std::atomic<std::size_t> _depth{};
+  std::atomic<uint64_t> _resumedCount{};
+  LatencyHistogram _waitTime;
 };
 
 } // namespace server
@@ -0,0 +1,124 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#ifndef ALICIA_SERVER_COMMANDMETRICS_HPP
+#define ALICIA_SERVER_COMMANDMETRICS_HPP
+
+#include "libserver/network/command/CommandProtocol.hpp"
+#include "libserver/util/LatencyHistogram.hpp"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace server
+{
+
+//! Per-command metrics of a command server.
+//! Metrics may be recorded from any thread.
+class CommandMetrics
+{
+public:
+  //! Stage of the processing of a command.
+  enum class Stage
+  {
+    //! Reading of the incoming command.
+    Decode,
+    //! Execution of the handler of the incoming command.
+    Handle,
+    //! Writing of the outgoing command.
+    Encode,
+    Count
+  };
+
+  //! Summary of a stage of a command.
+  struct StageSummary
+  {
+    //! Processed bytes.
+    uint64_t bytes{};
+    //! Latency of the stage.
+    LatencyHistogram::Summary latency{};
+  };
+
+  //! Summary of a command.
+  struct CommandSummary
+  {
+    //! ID of the command.
+    protocol::Command command{};
+    //! Summaries of the stages.
+    std::array<StageSummary, static_cast<std::size_t>(Stage::Count)> stages{};
+
+    //! Returns the summary of the stage.
+    [[nodiscard]] const StageSummary& Get(Stage stage) const noexcept
+    {
+      return stages[static_cast<std::size_t>(stage)];
+    }
+  };
+
+  CommandMetrics();
+  ~CommandMetrics();
+
+  CommandMetrics(const CommandMetrics&) = delete;
+  CommandMetrics& operator=(const CommandMetrics&) = delete;
+
+  //! Records a sample of a stage of a command.
+  //! @param command ID of the command.
+  //! @param stage Stage of the processing.
+  //! @param bytes Processed bytes.
+  //! @param duration Duration of the stage.
+  void Record(
+    protocol::Command command,
+    Stage stage,
+    std::size_t bytes,
+    LatencyHistogram::Duration duration) noexcept;
+
+  //! Summarizes the commands with recorded samples.
+  //! @returns Summaries of the commands,
+  //!          ordered by the total time spent in the commands, descending.
+  [[nodiscard]] std::vector<CommandSummary> Summarize() const;
+
+  //! Formats the summaries of the commands to human-readable lines.
+  //! @param limit Max count of the commands.
+  //! @returns Lines with the summaries.
+  [[nodiscard]] std::vector<std::string> Format(std::size_t limit) const;
+
+  //! Resets the recorded samples.
+  void Reset() noexcept;
+
+private:
+  //! Metrics of a stage.
+  struct StageMetrics
+  {
+    std::atomic<uint64_t> bytes{};
+    LatencyHistogram latency;
+  };
+
+  //! Metrics of a command.
+  using Metrics = std::array<StageMetrics, static_cast<std::size_t>(Stage::Count)>;
+
+  //! Metrics of the commands indexed by the command IDs,
+  //! allocated when the first sample of the command is recorded.
+  std::unique_ptr<std::atomic<Metrics*>[]> _metrics;
+};
+
+} // namespace server
+
+#endif // ALICIA_SERVER_COMMANDMETRICS_HPP
@@ -21,6 +21,7 @@
 #define COMMAND_PROTOCOL_HPP
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <string_view>
 
@@ -724,6 +725,47 @@ enum class Command : uint16_t
   Count = 0x10a4,
 };
 
+//! Count of the command IDs, all the command IDs are lower than it.
+constexpr std::size_t CommandCount = static_cast<std::size_t>(Command::Count);
+
+//! Priority of the delivery of a command.
+enum class CommandPriority : uint8_t
+{
+  //! The command is always delivered.
+  Reliable,
+  //! The command may be dropped when the client falls behind,
+  //! as it is superseded by the next one.
+  Droppable,
+};
+
+//! Rate class of a command.
+enum class CommandRateClass : uint8_t
+{
+  //! The command is sent on events.
+  Event,
+  //! The command is streamed at a high rate, e.g. state updates and heartbeats.
+  Stream,
+};
+
+//! Traits of a command.
+struct CommandTraits
+{
+  //! Name of the command.
+  std::string_view name{"n/a"};
+  //! Whether the command is excluded from the debug logs.
+  bool isMuted{false};
+  //! Priority of the delivery of the command.
+  CommandPriority priority{CommandPriority::Reliable};
+  //! Rate class of the command.
+  CommandRateClass rateClass{CommandRateClass::Event};
+};
+
+//! Get the traits of the command from its ID.
+//! @param command ID of the command to retrieve the traits for.
+//! @returns Traits of the command.
+//!          Traits of unknown commands have the name "n/a".
+const CommandTraits& GetCommandTraits(Command command) noexcept;
+
 //! Get the name of the command from its ID.
 //! @param command ID of the command to retrieve the name for.
 //! @returns If command is registered, name of the command.
@@ -20,13 +20,20 @@
 #ifndef COMMAND_SERVER_HPP
 #define COMMAND_SERVER_HPP
 
+#include "CommandMetrics.hpp"
 #include "CommandProtocol.hpp"
-#include "libserver/Constants.hpp"
+#include "libserver/network/FramedTransport.hpp"
 #include "libserver/network/Server.hpp"
+#include "libserver/network/TrafficCapture.hpp"
+#include "libserver/util/Deferred.hpp"
 #include "libserver/util/Stream.hpp"
 
-#include <queue>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <unordered_map>
+#include <vector>
 
 namespace server
 {
@@ -35,10 +42,10 @@ namespace asio = network::asio;
 using ClientId = network::ClientId;
 
 //! A command handler.
-using RawCommandHandler = std::function<void(ClientId, SourceStream&)>;
+using RawCommandHandler = network::RawFrameHandler;
 
-//! A command supplier.
-using CommandSupplier = std::function<void(SinkStream&)>;
+//! A command writer.
+using CommandWriter = network::FrameWriter;
 
 //! A command client.
 class CommandClient
@@ -51,10 +58,37 @@ public:
   [[nodiscard]] int32_t GetRollingCodeInt() const;
 
 private:
-  std::queue<CommandSupplier> _commandQueue;
   protocol::XorCode _rollingCode{};
 };
 
+//! Framing of the command protocol.
+//! The frames begin with the message magic. The data of the client frames
+//! are scrambled with the rolling code of the client and padded,
+//! the server frames are sent as they are.
+struct CommandFraming
+{
+  using ClientState = CommandClient;
+
+  static constexpr std::string_view Name = "command";
+  static constexpr std::size_t HeaderSize = sizeof(protocol::MessageMagic);
+  //! Max size of the frame, that is the max size of the command data and the size of the magic.
+  static constexpr std::size_t MaxFrameSize = 8192 + HeaderSize;
+  static constexpr std::size_t CommandCount = protocol::CommandCount;
+
+  static network::FrameHeader ReadHeader(std::span<const std::byte> header);
+  static void WriteHeader(std::span<std::byte> header, const network::FrameHeader& frameHeader);
+  static std::span<std::byte> DecodeData(
+    CommandClient& client,
+    uint16_t commandId,
+    std::span<std::byte> data);
+  static void EncodeFrame(std::span<std::byte>) noexcept {}
+  static std::string_view GetCommandName(uint16_t commandId);
+  static bool IsMuted(uint16_t commandId);
+  static bool HasCredentials(uint16_t commandId);
+  //! Clears the member number and the auth key of the login command.
+  static std::span<std::byte> RedactCredentials(uint16_t commandId, std::span<std::byte> data);
+};
+
 template <typename T>
 concept ReadableCommandStruct = ReadableStruct<T> and requires
 {
@@ -98,41 +132,149 @@ public:
   //! Begins the command server.
   //! @param address Address.
   //! @param port Port.
-  void BeginHost(const asio::ip::address& address, uint16_t port);
+  //! @param ioThreadCount Count of threads processing the network I/O.
+  void BeginHost(
+    const asio::ip::address& address,
+    uint16_t port,
+    uint32_t ioThreadCount = 1);
 
   //! Ends the command server.
   void EndHost();
 
+  //! Sets the interval of the network ticks, must be set before the server begins.
+  //! @param tickInterval Interval of the network ticks.
+  void SetNetworkTickInterval(std::chrono::steady_clock::duration tickInterval);
+
   asio::ip::address_v4 GetClientAddress(ClientId);
+  //! Returns the address of the client, or an empty optional if the client is not connected.
+  std::optional<asio::ip::address_v4> FindClientAddress(ClientId);
   void DisconnectClient(ClientId clientId);
 
   void SetCode(ClientId client, protocol::XorCode code);
 
+  //! Returns the per-command metrics.
+  //! @returns Command metrics.
+  [[nodiscard]] CommandMetrics& GetMetrics() noexcept;
+
+  //! Returns the recorder of the inbound traffic.
+  //! @returns Traffic recorder.
+  [[nodiscard]] network::TrafficRecorder& GetTrafficRecorder() noexcept;
+
+  //! Notifies the event handler of a connection of a replayed client.
+  //! @param clientId ID of the replayed client.
+  void ReplayClientConnected(ClientId clientId);
+
+  //! Notifies the event handler of a disconnection of a replayed client.
+  //! @param clientId ID of the replayed client.
+  void ReplayClientDisconnected(ClientId clientId);
+
+  //! Dispatches a decoded command to its handler, as if it was received from the client.
+  //! Used to replay traffic captures, the responses to replayed clients are discarded.
+  //! @param clientId ID of the replayed client.
+  //! @param commandId ID of the command.
+  //! @param commandData Decoded command data.
+  void ReplayCommand(
+    ClientId clientId,
+    protocol::Command commandId,
+    std::span<const std::byte> commandData);
+
+  //! Returns the statistics of the outbound write queues of the clients.
+  //! @returns Statistics of the write queues.
+  [[nodiscard]] network::WriteQueueStats GetWriteQueueStats();
+
   //! Registers a command handler.
   //! @param handler Handler of the command.
   template <ReadableCommandStruct C>
   void RegisterCommandHandler(
     std::function<void(ClientId clientId, const C& command)> handler)
   {
-    _handlers[C::GetCommand()] = [handler](ClientId clientId, SourceStream& source)
+    const auto commandId = static_cast<uint16_t>(C::GetCommand());
+    _transport.RegisterHandler(commandId, [this, handler](ClientId clientId, SourceStream& source)
     {
       C command;
-      C::Read(command, source);
+
+      {
+        // The decoding is measured even when it throws,
+        // so that the malformed commands are accounted for.
+        const auto decodeBegin = Clock::now();
+        const Deferred recordDecode([this, &source, decodeBegin]()
+        {
+          _metrics.Record(
+            C::GetCommand(),
+            CommandMetrics::Stage::Decode,
+            source.Size(),
+            Clock::now() - decodeBegin);
+        });
+
+        C::Read(command, source);
+      }
+
+      const auto handleBegin = Clock::now();
+
+      // The handler is measured even when it throws.
+      const Deferred recordHandle([this, handleBegin]()
+      {
+        _metrics.Record(
+          C::GetCommand(),
+          CommandMetrics::Stage::Handle,
+          0,
+          Clock::now() - handleBegin);
+      });
+
       handler(clientId, command);
-    };
+    });
   }
 
   //! Queues a command for sending.
+  //! The command is encoded immediately. The commands reporting their size
+  //! are encoded directly to a frame of the exact size.
   //! @param clientId ID of the client to send the command to.
   //! @param supplier Supplier of the command.
-  template <WritableStruct C>
+  template <WritableStruct C, typename Supplier>
+    requires std::is_invocable_r_v<C, Supplier>
   void QueueCommand(
     ClientId clientId,
-    std::function<C()> supplier)
+    const Supplier& supplier)
   {
-    SendCommand(clientId, C::GetCommand(), [supplier](SinkStream& sink){
-      C::Write(supplier(), sink);
-    });
+    if constexpr (SizedStruct<C>)
+    {
+      const C command = supplier();
+      SendCommand(
+        clientId,
+        C::GetCommand(),
+        [&command](SinkStream& sink){
+          C::Write(command, sink);
+        },
+        C::GetEncodedSize(command));
+    }
+    else
+    {
+      SendCommand(clientId, C::GetCommand(), [&supplier](SinkStream& sink){
+        C::Write(supplier(), sink);
+      });
+    }
+  }
+
+  //! Queues a command for sending to multiple clients.
+  //! The command is encoded once and the encoded frame is shared by all the recipients.
+  //! @param recipients IDs of the clients to send the command to.
+  //! @param command Command.
+  template <WritableStruct C>
+  void Broadcast(
+    std::span<const ClientId> recipients,
+    const C& command)
+  {
+    std::optional<std::size_t> commandDataSize;
+    if constexpr (SizedStruct<C>)
+      commandDataSize = C::GetEncodedSize(command);
+
+    BroadcastCommand(
+      recipients,
+      C::GetCommand(),
+      [&command](SinkStream& sink){
+        C::Write(command, sink);
+      },
+      commandDataSize);
   }
 
 private:
@@ -145,24 +287,68 @@ private:
     void HandleNetworkTick() override;
     void OnClientConnected(network::ClientId clientId) override;
     void OnClientDisconnected(network::ClientId clientId) override;
-    size_t OnClientData(network::ClientId clientId, const std::span<const std::byte>& data) override;
+    size_t OnClientData(network::ClientId clientId, const std::span<std::byte>& data) override;
 
   private:
     CommandServer& _commandServer;
   };
 
-  //!
+  //! Encodes the command and queues it for write to the client.
+  //! @param clientId ID of the client to send the command to.
+  //! @param commandId ID of the command.
+  //! @param writer Writer of the command data.
+  //! @param commandDataSize Size of the command data, if known.
   void SendCommand(
     ClientId clientId,
     protocol::Command commandId,
-    CommandSupplier supplier);
+    const CommandWriter& writer,
+    std::optional<std::size_t> commandDataSize = std::nullopt);
+
+  //! Encodes the command once and queues it for write to all the recipients.
+  //! @param recipients IDs of the clients to send the command to.
+  //! @param commandId ID of the command.
+  //! @param writer Writer of the command data.
+  //! @param commandDataSize Size of the command data, if known.
+  void BroadcastCommand(
+    std::span<const ClientId> recipients,
+    protocol::Command commandId,
+    const CommandWriter& writer,
+    std::optional<std::size_t> commandDataSize = std::nullopt);
+
+  //! Encodes the command to a frame.
+  //! The commands of a known size are written directly to a frame of the exact size,
+  //! the other commands are written to a scratch buffer and copied to a frame.
+  //! @param commandId ID of the command.
+  //! @param writer Writer of the command data.
+  //! @param commandDataSize Size of the command data, if known.
+  //! @returns Shared buffer with the encoded frame.
+  //! @throws std::exception If the writer fails or writes other than the known size.
+  network::SharedWriteBuffer EncodeCommand(
+    protocol::Command commandId,
+    const CommandWriter& writer,
+    std::optional<std::size_t> commandDataSize);
+
+  using Clock = std::chrono::steady_clock;
+
+  //! Transport of the command frames.
+  network::FramedTransport<CommandFraming> _transport;
 
-  bool debugIncomingCommandData = constants::DebugCommands;
-  bool debugOutgoingCommandData = constants::DebugCommands;
-  bool debugCommands = constants::DebugCommands;
+  //! Per-command metrics.
+  CommandMetrics _metrics;
+  //! Time point of the last log of the command metrics.
+  Clock::time_point _lastMetricsLog{Clock::now()};
+
+  //! A command client, its code is set from the event strand
+  //! while its commands are decoded on the strand of its connection.
+  struct GuardedClient
+  {
+    std::mutex mutex;
+    CommandClient client;
+  };
 
-  std::unordered_map<protocol::Command, RawCommandHandler> _handlers{};
-  std::unordered_map<ClientId, CommandClient> _clients{};
+  //! A mutex for the command clients.
+  std::mutex _clientsMutex;
+  std::unordered_map<ClientId, GuardedClient> _clients{};
 
   EventHandlerInterface& _eventHandler;
   NetworkEventHandler _serverNetworkEventHandler;
@@ -59,10 +59,15 @@ struct Item
   uint32_t expiresAt{};
   uint32_t count{};
 
+  //! The fields are written in their memory order without padding.
+  static constexpr bool IsBulkCopyable = true;
+
   static void Write(const Item& item, SinkStream& stream);
   static void Read(Item& item, SourceStream& stream);
 };
 
+static_assert(sizeof(Item) == 16, "Item must not be padded");
+
 struct StoredItem
 {
   enum class Status : uint8_t {
@@ -809,6 +814,9 @@ struct Vector3
     return std::sqrt(x * x + y * y + z * z);
   }
 
+  //! The fields are written in their memory order without padding.
+  static constexpr bool IsBulkCopyable = true;
+
   static void Write(
     const Vector3& vector,
     SinkStream& stream);
@@ -818,6 +826,8 @@ struct Vector3
     SourceStream& stream);
 };
 
+static_assert(sizeof(Vector3) == 12, "Vector3 must not be padded");
+
 //! A breeding bonus rolled from the BonusProbInfo table.
 struct BreedingBonus
 {
@@ -685,6 +685,12 @@ struct AcCmdUserRaceTimerOK
     const AcCmdUserRaceTimerOK& command,
     SinkStream& stream);
 
+  //! Returns the size of the command in the stream.
+  //! @param command Command.
+  //! @returns Size of the command.
+  static std::size_t GetEncodedSize(
+    const AcCmdUserRaceTimerOK& command);
+
   //! Reader a command from a provided source stream.
   //! @param command Command.
   //! @param stream Source stream.
@@ -1558,6 +1564,12 @@ struct AcCmdUserRaceUpdatePos
     const AcCmdUserRaceUpdatePos& command,
     SinkStream& stream);
 
+  //! Returns the size of the command in the stream.
+  //! @param command Command.
+  //! @returns Size of the command.
+  static std::size_t GetEncodedSize(
+    const AcCmdUserRaceUpdatePos& command);
+
   //! Reader a command from a provided source stream.
   //! @param command Command.
   //! @param stream Source stream.
@@ -1585,6 +1597,12 @@ struct AcCmdRCRoomCountdown
     const AcCmdRCRoomCountdown& command,
     SinkStream& stream);
 
+  //! Returns the size of the command in the stream.
+  //! @param command Command.
+  //! @returns Size of the command.
+  static std::size_t GetEncodedSize(
+    const AcCmdRCRoomCountdown& command);
+
   //! Reader a command from a provided source stream.
   //! @param command Command.
   //! @param stream Source stream.
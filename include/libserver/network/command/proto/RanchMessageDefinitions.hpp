@@ -374,6 +374,12 @@ struct AcCmdCRRanchSnapshot
     const AcCmdCRRanchSnapshot& command,
     SinkStream& stream);
 
+  //! Returns the size of the command in the stream.
+  //! @param command Command.
+  //! @returns Size of the command.
+  static std::size_t GetEncodedSize(
+    const AcCmdCRRanchSnapshot& command);
+
   //! Reader a command from a provided source stream.
   //! @param command Command.
   //! @param stream Source stream.
@@ -402,6 +408,12 @@ struct RanchCommandRanchSnapshotNotify
     const RanchCommandRanchSnapshotNotify& command,
     SinkStream& stream);
 
+  //! Returns the size of the command in the stream.
+  //! @param command Command.
+  //! @returns Size of the command.
+  static std::size_t GetEncodedSize(
+    const RanchCommandRanchSnapshotNotify& command);
+
   //! Reader a command from a provided source stream.
   //! @param command Command.
   //! @param stream Source stream.
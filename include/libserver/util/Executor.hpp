@@ -0,0 +1,150 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#ifndef SERVER_EXECUTOR_HPP
+#define SERVER_EXECUTOR_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace server
+{
+
+//! A pool of threads executing tasks, sized to the machine by default.
+//!
+//! Every worker thread has its own queue of tasks, a worker without tasks
+//! steals the tasks of the other workers and sleeps once there are none.
+//! Work which must not run concurrently is posted through a strand.
+class Executor final
+{
+  struct Worker;
+
+public:
+  //! A task to execute.
+  using Task = std::function<void()>;
+  //! An alias for the standard steady-clock.
+  using Clock = std::chrono::steady_clock;
+
+  //! Serializes the tasks posted through it, the tasks execute one at a time
+  //! and in the order they were posted, on any of the worker threads.
+  class Strand final
+  {
+  public:
+    //! Constructor.
+    //! @param executor Executor to execute the tasks of the strand.
+    explicit Strand(Executor& executor);
+
+    //! Posts a task to the strand.
+    //! @param task Task to execute.
+    void Post(Task task);
+
+    //! Posts a task to the strand to execute at a time point.
+    //! @param task Task to execute.
+    //! @param when Time point of when to execute the task.
+    void PostAt(Task task, Clock::time_point when);
+
+  private:
+    struct State;
+
+    //! Queues a task of the strand and posts a drain of the strand if there is none.
+    static void Enqueue(const std::shared_ptr<State>& state, Task task);
+    //! Executes the queued tasks of the strand.
+    static void Drain(const std::shared_ptr<State>& state);
+
+    //! State shared with the posted drains, which might outlive the strand.
+    std::shared_ptr<State> _state;
+  };
+
+  Executor();
+  ~Executor();
+
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+
+  //! Begins the worker threads.
+  //! @param threadCount Count of the worker threads, zero for the count of the hardware threads.
+  void Begin(uint32_t threadCount = 0);
+  //! Ends the worker threads, the tasks not yet executed are discarded.
+  void End();
+
+
+  //! Posts a task, discarded if the executor is not running.
+  //! @param task Task to execute.
+  void Post(Task task);
+
+  //! Posts a task to execute at a time point, discarded if the executor is not running.
+  //! @param task Task to execute.
+  //! @param when Time point of when to execute the task.
+  void PostAt(Task task, Clock::time_point when);
+
+  //! Returns the count of the worker threads.
+  [[nodiscard]] std::size_t GetThreadCount() const noexcept;
+
+private:
+  //! A task to execute at a time point.
+  struct TimedTask
+  {
+    Clock::time_point when{};
+    Task task{};
+  };
+
+  //! Runs the worker.
+  void RunWorker(std::size_t workerIdx);
+  //! Takes a task of the worker, or steals one from the other workers.
+  bool TakeTask(std::size_t workerIdx, Task& task);
+  //! Posts the due timed tasks to the worker.
+  void PostDueTasks(std::size_t workerIdx);
+  //! Pushes a task to the queue of a worker and wakes a sleeping worker.
+  void Push(std::size_t workerIdx, Task task);
+
+  //! The workers.
+  std::vector<std::unique_ptr<Worker>> _workers;
+  //! Index of the next worker tasks posted from the outside of the executor go to.
+  std::atomic_size_t _nextWorkerIdx{0};
+
+  //! Whether the workers should run.
+  std::atomic_bool _isRunning{false};
+  //! Count of the tasks in the queues of the workers.
+  std::atomic_size_t _queuedTaskCount{0};
+  //! Count of the sleeping workers.
+  std::atomic_size_t _sleepingWorkerCount{0};
+  //! The earliest time point of the timed tasks.
+  std::atomic<Clock::rep> _nextTimedTaskTime{Clock::time_point::max().time_since_epoch().count()};
+
+  //! A mutex to the sleeping workers and the timed tasks.
+  std::mutex _idleMutex;
+  //! A condition variable the workers sleep on.
+  std::condition_variable _idleCv;
+  //! Whether a sleeping worker waits for the earliest timed task.
+  bool _hasTimerWaiter{false};
+  //! Timed tasks, a min-heap by their time points.
+  std::vector<TimedTask> _timedTasks;
+};
+
+} // namespace server
+
+#endif // SERVER_EXECUTOR_HPP
@@ -0,0 +1,88 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#ifndef ALICIA_SERVER_LATENCYHISTOGRAM_HPP
+#define ALICIA_SERVER_LATENCYHISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace server
+{
+
+//! A lock-free histogram of durations.
+//!
+//! Samples are counted in power-of-two buckets of microseconds,
+//! so the percentiles are approximated by the upper bound of their bucket.
+//! Samples may be recorded from any thread.
+class LatencyHistogram
+{
+public:
+  using Duration = std::chrono::nanoseconds;
+
+  //! Summary of the recorded samples.
+  struct Summary
+  {
+    //! Count of the samples.
+    uint64_t count{};
+    //! Sum of the samples.
+    Duration total{};
+    //! Median of the samples.
+    Duration p50{};
+    //! 99th percentile of the samples.
+    Duration p99{};
+    //! Max of the samples.
+    Duration max{};
+  };
+
+  //! Records a sample.
+  //! @param duration Duration of the sample.
+  void Record(Duration duration) noexcept;
+
+  //! Summarizes the recorded samples.
+  //! @returns Summary of the samples.
+  [[nodiscard]] Summary Summarize() const noexcept;
+
+  //! Resets the recorded samples.
+  void Reset() noexcept;
+
+private:
+  //! Count of the buckets. The last bucket holds samples of 2^30us and longer.
+  static constexpr std::size_t BucketCount = 32;
+
+  //! Returns the percentile of the samples.
+  //! @param count Count of the samples.
+  //! @param percentile Percentile in the range of 0 to 100.
+  [[nodiscard]] Duration GetPercentile(uint64_t count, uint64_t percentile) const noexcept;
+
+  //! Sample counts of the buckets.
+  std::array<std::atomic<uint64_t>, BucketCount> _buckets{};
+  //! Count of the samples.
+  std::atomic<uint64_t> _count{};
+  //! Sum of the samples in nanoseconds.
+  std::atomic<uint64_t> _total{};
+  //! Max of the samples in nanoseconds.
+  std::atomic<uint64_t> _max{};
+};
+
+} // namespace server
+
+#endif // ALICIA_SERVER_LATENCYHISTOGRAM_HPP
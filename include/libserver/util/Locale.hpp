@@ -21,6 +21,7 @@
 #define LOCALE_HPP
 
 #include <string>
+#include <string_view>
 
 namespace server
 {
@@ -28,6 +29,12 @@ namespace server
 namespace locale
 {
 
+//! Checks whether the string consists only of the non-null ASCII characters.
+//! Such strings are encoded the same in EUC-KR and in UTF-8 and need no conversion.
+//! @param input Input string.
+//! @returns `true` if the string is plain ASCII, otherwise returns `false`.
+[[nodiscard]] bool IsPlainAscii(std::string_view input) noexcept;
+
 //! Converts EUC-KR encoded string into a UTF-8 encoded string.
 //! @param input Input string in the EUC-KR encoding.
 //! @returns Output string encoded in UTF8 encoding.
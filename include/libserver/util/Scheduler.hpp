@@ -20,51 +20,169 @@
 #ifndef SERVER_SCHEDULER_HPP
 #define SERVER_SCHEDULER_HPP
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <deque>
 #include <functional>
-#include <list>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 namespace server
 {
 
+//! A scheduler of tasks, executing every due task each tick.
 //!
+//! The delayed jobs are kept in a hierarchical timing wheel, so queueing
+//! and cancelling a job takes constant time whatever the count of the jobs.
+//! The jobs may be queued and cancelled from any thread.
 class Scheduler final
 {
+  struct Job;
+
 public:
   //! A task to perform.
   using Task = std::function<void()>;
   //! An alias for the standard steady-clock.
   using Clock = std::chrono::steady_clock;
+  //! A handler waking up the owner of the scheduler.
+  using WakeHandler = std::function<void()>;
+
+  //! A handle to a queued job, used to cancel it.
+  class JobHandle
+  {
+  public:
+    JobHandle() = default;
+
+    //! Cancels the job if it has not executed yet.
+    //! @returns `true` if the job was cancelled,
+    //!          `false` if it already executed or was cancelled.
+    bool Cancel();
+
+  private:
+    friend class Scheduler;
+
+    explicit JobHandle(std::weak_ptr<Job> job);
+
+    std::weak_ptr<Job> _job;
+  };
+
+  //! Default time budget of a tick.
+  static constexpr Clock::duration DefaultTickBudget = std::chrono::milliseconds(10);
 
   Scheduler();
 
-  //! Tick the scheduler.
+  //! Tick the scheduler, executes the due jobs in the order of their time points
+  //! until the time budget of the tick runs out. The remaining due jobs
+  //! execute first in the next tick.
   void Tick();
 
   //! Queue a task to be executed in the next tick.
   //! @param task Task to queue execution of.
   //! @param when A time point of when to execute the task. Defaults to immediate execution.
-  void Queue(
-    const Task& task,
+  //! @returns Handle to the job.
+  JobHandle Queue(
+    Task task,
     Clock::time_point when = Clock::now());
 
-protected:
+  //! Sets the handler called when a job due immediately is queued, so that the owner
+  //! can tick the scheduler right away instead of in its next periodic tick. It is also
+  //! called when a delayed job is queued before the time point last returned
+  //! by `GetNextDueTime`, so that the owner can tick the scheduler earlier.
+  //! May be set while the jobs are queued from the other threads.
+  //! @param wakeHandler Wake handler.
+  void SetWakeHandler(WakeHandler wakeHandler);
+
+  //! Returns the time point of when the scheduler has to be ticked next.
+  //! The time point might precede the first delayed job, but never follows it.
+  //! The owner is woken up if a job is queued before the returned time point.
+  //! @returns Time point of the next due job, the min time point if some jobs are due
+  //!          already and the max time point if there are no jobs.
+  [[nodiscard]] Clock::time_point GetNextDueTime();
+
+  //! Sets the time budget of a tick. At least one due job executes each tick.
+  //! @param budget Time budget, zero for no limit.
+  void SetTickBudget(Clock::duration budget);
+
+  //! Returns the count of the jobs which have not executed yet,
+  //! including the cancelled jobs not yet reached.
+  [[nodiscard]] std::size_t GetJobCount() const;
+
+private:
+  //! Bits of a slot index of a wheel.
+  static constexpr uint32_t WheelBits = 6;
+  //! Count of the slots of a wheel.
+  static constexpr uint32_t WheelSize = 1u << WheelBits;
+  //! Count of the wheels, each next wheel has slots as long as the previous wheel.
+  static constexpr uint32_t WheelCount = 4;
+  //! Length of a slot of the first wheel.
+  static constexpr Clock::duration Resolution = std::chrono::milliseconds(1);
+
   //! A job.
   struct Job
   {
+    enum class State : uint8_t
+    {
+      Pending,
+      Executed,
+      Cancelled,
+    };
+
     //! A time point of when the job should execute.
     Clock::time_point when{};
+    //! A tick of the wheels of when the job should execute.
+    uint64_t expiry{};
+    //! A sequence number of the job, orders the jobs with the same time point.
+    uint64_t sequence{};
     //! A task the job has to execute.
     Task task{};
+    //! A state of the job.
+    std::atomic<State> state{State::Pending};
   };
 
-  //! A mutex to the job list.
-  std::mutex _jobsMutex;
-  //! A job list.
-  std::list<Job> _jobs;
-  //! An iterator to the job to execute in the next tick cycle.
-  decltype(_jobs)::const_iterator _jobIterator;
+  using JobPtr = std::shared_ptr<Job>;
+  using Slot = std::vector<JobPtr>;
+
+  //! Returns the wheel tick of a time point, rounded up.
+  [[nodiscard]] uint64_t GetWheelTick(Clock::time_point when) const;
+  //! Inserts a job into the wheels relative to a wheel tick not yet processed.
+  //! @param job Job with an expiry at or after the reference tick.
+  //! @param reference Reference wheel tick.
+  void InsertJob(JobPtr job, uint64_t reference);
+  //! Returns the first wheel tick at which some of the delayed jobs might become due.
+  //! @returns Wheel tick, or the max wheel tick if there are no delayed jobs.
+  [[nodiscard]] uint64_t GetNextWheelTick() const;
+  //! Advances the wheels up to a wheel tick, collecting the due jobs.
+  //! @param tick Wheel tick.
+  //! @param due Due jobs, appended to.
+  void AdvanceWheels(uint64_t tick, std::vector<JobPtr>& due);
+
+  //! A mutex to the wheels and the ready jobs.
+  mutable std::mutex _jobsMutex;
+  //! A time point of the first wheel tick.
+  const Clock::time_point _epoch;
+  //! The last processed wheel tick.
+  uint64_t _currentTick{};
+  //! A sequence number of the next job.
+  uint64_t _nextSequence{};
+  //! The wheels of the slots of the delayed jobs.
+  std::array<std::array<Slot, WheelSize>, WheelCount> _wheels{};
+  //! Jobs beyond the range of the wheels.
+  Slot _overflow;
+  //! Count of the jobs in the wheels and the overflow.
+  std::size_t _wheelJobCount{};
+  //! Due jobs in the order of execution.
+  std::deque<JobPtr> _readyJobs;
+  //! A time budget of a tick.
+  Clock::duration _tickBudget{DefaultTickBudget};
+  //! A handler called when a job due immediately is queued, shared with the queueing
+  //! threads so it can be replaced while they call it.
+  std::shared_ptr<const WakeHandler> _wakeHandler;
+  //! A time point the owner expects to tick the scheduler at, the jobs queued before it
+  //! wake the owner up. The owners not asking for it are expected to tick periodically.
+  Clock::time_point _wakeDeadline{Clock::time_point::min()};
 };
 
 } // namespace server
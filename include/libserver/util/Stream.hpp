@@ -20,9 +20,14 @@
 #ifndef STREAM_HPP
 #define STREAM_HPP
 
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstring>
 #include <format>
 #include <span>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 
 namespace server
@@ -78,6 +83,25 @@ class SourceStream;
 template <typename T>
 concept Numeric = std::is_arithmetic_v<T> || std::is_enum_v<T>;
 
+namespace detail
+{
+
+template <typename T>
+constexpr bool IsBulkCopyable = std::is_trivially_copyable_v<T>
+  && (Numeric<T> || requires { requires T::IsBulkCopyable; });
+
+template <typename T, std::size_t Size>
+constexpr bool IsBulkCopyable<std::array<T, Size>> = IsBulkCopyable<T>;
+
+} // namespace detail
+
+//! Types whose representation in the stream is the same as their representation in the memory.
+//! These are the numerics, the structures declaring `static constexpr bool IsBulkCopyable = true`
+//! and the arrays of these types.
+//! Contiguous ranges of these types are copied with a single copy.
+template <typename T>
+concept BulkCopyable = detail::IsBulkCopyable<T>;
+
 template <typename T>
 concept Container = requires(T a) {
   typename T::value_type;
@@ -96,6 +120,20 @@ concept ReadableStruct = requires(T value, SourceStream& stream) {
   { T::Read(value, stream) };
 };
 
+//! Structures which report the size of their representation in the stream.
+//! The reported size must be exact, as the writers of the structures
+//! reserve only that many bytes.
+template <typename T>
+concept SizedStruct = WritableStruct<T> && requires(const T& value) {
+  { T::GetEncodedSize(value) } -> std::convertible_to<std::size_t>;
+};
+
+//! Returns the size of the representation of the string in the stream,
+//! that is the size of the string in EUC-KR with its null terminator.
+//! @param value String.
+//! @returns Size of the string in the stream.
+[[nodiscard]] std::size_t GetEncodedSize(const std::string& value);
+
 //! Buffered stream sink.
 class SinkStream final
   : public StreamBase<std::span<std::byte>>
@@ -118,6 +156,64 @@ public:
   //! Deleted copy assignment.
   void operator=(const SinkStream&) = delete;
 
+  //! A writer of a region reserved in the sink stream.
+  //! The bounds are checked once when the region is reserved,
+  //! the writes to the region are not checked.
+  class ReservedWriter
+  {
+  public:
+    //! Write a value to the reserved region.
+    //!
+    //! @param value Value to write.
+    //! @tparam T Type of value.
+    //! @return Reference to this.
+    template <Numeric T>
+    ReservedWriter& Write(const T& value) noexcept
+    {
+      WriteBytes(&value, sizeof(value));
+      return *this;
+    }
+
+    //! Write the values to the reserved region.
+    //!
+    //! @param values Values to write.
+    //! @return Reference to this.
+    template <typename T, std::size_t Extent>
+      requires BulkCopyable<std::remove_const_t<T>>
+    ReservedWriter& Write(std::span<T, Extent> values) noexcept
+    {
+      WriteBytes(values.data(), values.size_bytes());
+      return *this;
+    }
+
+  private:
+    friend class SinkStream;
+
+    ReservedWriter(std::byte* data, std::size_t size, std::size_t& cursor) noexcept
+      : _data(data)
+      , _remaining(size)
+      , _cursor(cursor)
+    {
+    }
+
+    void WriteBytes(const void* data, std::size_t size) noexcept
+    {
+      assert(size <= _remaining && "Write is out of the reserved region");
+      if (size == 0)
+        return;
+
+      std::memcpy(_data, data, size);
+      _data += size;
+      _remaining -= size;
+      _cursor += size;
+    }
+
+    std::byte* _data;
+    std::size_t _remaining;
+    //! Cursor of the sink stream, kept up to date with every write.
+    std::size_t& _cursor;
+  };
+
   //! Writes to the buffer storage.
   //! Fails if the operation can't be completed wholly.
   //!
@@ -125,6 +221,13 @@ public:
   //! @param size Size of data.
   void Write(const void* data, std::size_t size);
 
+  //! Reserves a region of the buffer storage for unchecked writes.
+  //! Fails if there is not enough space for the region.
+  //!
+  //! @param size Size of the region.
+  //! @returns Writer of the region.
+  [[nodiscard]] ReservedWriter Reserve(std::size_t size);
+
   //! Write a value to the sink stream.
   //!
   //! @param value Value to write.
@@ -133,8 +236,35 @@ public:
   template <Numeric T>
   SinkStream& Write(const T& value)
   {
-    const auto requiredByteCount = sizeof(value);
-    Write(reinterpret_cast<const void*>(&value), requiredByteCount);
+    // Copy inline when there is enough space, the out-of-line write fails otherwise.
+    if (_cursor + sizeof(value) > _storage.size())
+    {
+      Write(reinterpret_cast<const void*>(&value), sizeof(value));
+      return *this;
+    }
+
+    std::memcpy(_storage.data() + _cursor, &value, sizeof(value));
+    _cursor += sizeof(value);
+    return *this;
+  }
+
+  //! Write the values to the sink stream with a single copy.
+  //!
+  //! @param values Values to write.
+  //! @return Reference to this.
+  template <typename T, std::size_t Extent>
+    requires BulkCopyable<std::remove_const_t<T>>
+  SinkStream& Write(std::span<T, Extent> values)
+  {
+    // Copy inline when there is enough space, the out-of-line write fails otherwise.
+    if (_cursor + values.size_bytes() > _storage.size() || values.empty())
+    {
+      Write(reinterpret_cast<const void*>(values.data()), values.size_bytes());
+      return *this;
+    }
+
+    std::memcpy(_storage.data() + _cursor, values.data(), values.size_bytes());
+    _cursor += values.size_bytes();
     return *this;
   }
 
@@ -187,8 +317,34 @@ public:
   template <Numeric T>
   SourceStream& Read(T& value)
   {
-    const auto byteCount = sizeof(value);
-    Read(reinterpret_cast<void*>(&value), byteCount);
+    // Copy inline when there is enough data, the out-of-line read fails otherwise.
+    if (_cursor + sizeof(value) > _storage.size())
+    {
+      Read(reinterpret_cast<void*>(&value), sizeof(value));
+      return *this;
+    }
+
+    std::memcpy(&value, _storage.data() + _cursor, sizeof(value));
+    _cursor += sizeof(value);
+    return *this;
+  }
+
+  //! Read the values from the source stream with a single copy.
+  //!
+  //! @param values Values to read.
+  //! @return Reference to this.
+  template <BulkCopyable T, std::size_t Extent>
+  SourceStream& Read(std::span<T, Extent> values)
+  {
+    // Copy inline when there is enough data, the out-of-line read fails otherwise.
+    if (_cursor + values.size_bytes() > _storage.size() || values.empty())
+    {
+      Read(reinterpret_cast<void*>(values.data()), values.size_bytes());
+      return *this;
+    }
+
+    std::memcpy(values.data(), _storage.data() + _cursor, values.size_bytes());
+    _cursor += values.size_bytes();
     return *this;
   }
 
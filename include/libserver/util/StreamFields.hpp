@@ -0,0 +1,220 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#ifndef STREAMFIELDS_HPP
+#define STREAMFIELDS_HPP
+
+#include "libserver/util/Stream.hpp"
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+
+namespace server
+{
+
+//! Describes a field of a structure serialized by the `StreamFields`.
+//! Use the `STREAM_FIELD` macro to describe a field.
+//!
+//! @tparam Member Pointer to the member of the structure.
+//! @tparam Offset Offset of the member in the structure.
+template <auto Member, std::size_t Offset>
+struct StreamField;
+
+template <typename Struct, typename Type, Type Struct::* Member, std::size_t Offset>
+struct StreamField<Member, Offset>
+{
+  static_assert(
+    std::is_standard_layout_v<Struct>,
+    "The offsets of the fields are defined only for the standard layout structures");
+
+  using StructType = Struct;
+  using FieldType = Type;
+
+  static constexpr auto member = Member;
+  static constexpr std::size_t offset = Offset;
+  static constexpr std::size_t size = sizeof(Type);
+  static constexpr bool isBulkCopyable = BulkCopyable<Type>;
+};
+
+//! Describes a field of a structure.
+//! @param Struct Structure.
+//! @param member Member of the structure.
+#define STREAM_FIELD(Struct, member) \
+  ::server::StreamField<&Struct::member, offsetof(Struct, member)>
+
+//! Serializes the fields of a structure in the order they are listed.
+//!
+//! The runs of the listed fields which are bulk copyable and follow each
+//! other in the memory without padding are copied with a single copy.
+//! The other fields are read and written with the stream overloads of
+//! their types.
+//!
+//! @tparam Fields Fields of the structure, described with `STREAM_FIELD`.
+template <typename... Fields>
+class StreamFields
+{
+  static_assert(sizeof...(Fields) > 0, "At least one field is required");
+
+  using FieldTuple = std::tuple<Fields...>;
+  using Struct = typename std::tuple_element_t<0, FieldTuple>::StructType;
+
+  static_assert(
+    (std::is_same_v<typename Fields::StructType, Struct> && ...),
+    "The fields must be of the same structure");
+
+  template <std::size_t Index>
+  using Field = std::tuple_element_t<Index, FieldTuple>;
+
+  static constexpr std::size_t FieldCount = sizeof...(Fields);
+  static constexpr std::array<std::size_t, FieldCount> Offsets{Fields::offset...};
+  static constexpr std::array<std::size_t, FieldCount> Sizes{Fields::size...};
+  static constexpr std::array<bool, FieldCount> IsBulkCopyable{Fields::isBulkCopyable...};
+
+  //! Returns the index one past the last field of the bulk copyable run starting at the index.
+  static constexpr std::size_t GetRunEnd(const std::size_t begin)
+  {
+    std::size_t end = begin + 1;
+    while (end < FieldCount
+      && IsBulkCopyable[end]
+      && Offsets[end] == Offsets[end - 1] + Sizes[end - 1])
+    {
+      ++end;
+    }
+
+    return end;
+  }
+
+  //! Returns the size of the fields if all of them are bulk copyable, zero otherwise.
+  static constexpr std::size_t GetFixedSize()
+  {
+    std::size_t size = 0;
+    for (std::size_t idx = 0; idx < FieldCount; ++idx)
+    {
+      if (not IsBulkCopyable[idx])
+        return 0;
+      size += Sizes[idx];
+    }
+
+    return size;
+  }
+
+  //! Returns the count of the copies the fields are serialized with.
+  static constexpr std::size_t GetCopyCount()
+  {
+    std::size_t count = 0;
+    for (std::size_t idx = 0; idx < FieldCount; ++count)
+      idx = IsBulkCopyable[idx] ? GetRunEnd(idx) : idx + 1;
+
+    return count;
+  }
+
+  template <std::size_t Index, typename Sink>
+  static void WriteFrom(const Struct& value, Sink& sink)
+  {
+    if constexpr (Index < FieldCount)
+    {
+      if constexpr (Field<Index>::isBulkCopyable)
+      {
+        constexpr std::size_t RunEnd = GetRunEnd(Index);
+        constexpr std::size_t RunSize = Offsets[RunEnd - 1] + Sizes[RunEnd - 1] - Offsets[Index];
+
+        sink.Write(std::span<const std::byte, RunSize>(
+          reinterpret_cast<const std::byte*>(&value) + Offsets[Index],
+          RunSize));
+        WriteFrom<RunEnd>(value, sink);
+      }
+      else
+      {
+        sink.Write(value.*Field<Index>::member);
+        WriteFrom<Index + 1>(value, sink);
+      }
+    }
+  }
+
+  template <std::size_t Index>
+  static void ReadFrom(Struct& value, SourceStream& source)
+  {
+    if constexpr (Index < FieldCount)
+    {
+      if constexpr (Field<Index>::isBulkCopyable)
+      {
+        constexpr std::size_t RunEnd = GetRunEnd(Index);
+        constexpr std::size_t RunSize = Offsets[RunEnd - 1] + Sizes[RunEnd - 1] - Offsets[Index];
+
+        source.Read(std::span<std::byte, RunSize>(
+          reinterpret_cast<std::byte*>(&value) + Offsets[Index],
+          RunSize));
+        ReadFrom<RunEnd>(value, source);
+      }
+      else
+      {
+        source.Read(value.*Field<Index>::member);
+        ReadFrom<Index + 1>(value, source);
+      }
+    }
+  }
+
+public:
+  //! Size of the fields in the stream if all of them are bulk copyable, zero otherwise.
+  static constexpr std::size_t FixedSize = GetFixedSize();
+  //! Count of the copies, or of the stream operations, the fields are serialized with.
+  static constexpr std::size_t CopyCount = GetCopyCount();
+
+  //! Returns the size of the fields in the stream.
+  //! Available only if all the fields are bulk copyable.
+  //!
+  //! @returns Size of the fields in the stream.
+  static constexpr std::size_t GetEncodedSize(const Struct&) noexcept
+    requires (FixedSize > 0)
+  {
+    return FixedSize;
+  }
+
+  //! Writes the fields of the structure.
+  //! The structures of a fixed size are written with a single bounds check.
+  //!
+  //! @param value Structure.
+  //! @param stream Sink stream.
+  static void Write(const Struct& value, SinkStream& stream)
+  {
+    if constexpr (FixedSize > 0)
+    {
+      auto writer = stream.Reserve(FixedSize);
+      WriteFrom<0>(value, writer);
+    }
+    else
+    {
+      WriteFrom<0>(value, stream);
+    }
+  }
+
+  //! Reads the fields of the structure.
+  //!
+  //! @param value Structure.
+  //! @param stream Source stream.
+  static void Read(Struct& value, SourceStream& stream)
+  {
+    ReadFrom<0>(value, stream);
+  }
+};
+
+} // namespace server
+
+#endif // STREAMFIELDS_HPP
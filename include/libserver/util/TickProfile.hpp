@@ -0,0 +1,129 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#ifndef ALICIA_SERVER_TICKPROFILE_HPP
+#define ALICIA_SERVER_TICKPROFILE_HPP
+
+#include "libserver/util/LatencyHistogram.hpp"
+
+#include <array>
+#include <chrono>
+#include <span>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
+
+namespace server
+{
+
+//! Profile of a tick, keeping the slowest work items executed in the tick,
+//! so that an overrunning tick can be explained.
+//!
+//! A profile is made current on a thread for the duration of a scope.
+//! The schedulers and the command deferrers record their work items
+//! into the current profile of their thread, if there is one.
+class TickProfile
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  //! A work item of the tick.
+  struct Sample
+  {
+    //! Kind of the work item.
+    std::string_view kind;
+    //! Type of the work item.
+    const std::type_info* type{};
+    //! Duration of the work item.
+    Clock::duration duration{};
+  };
+
+  //! Max count of the slowest work items kept.
+  static constexpr std::size_t MaxSampleCount = 5;
+
+  //! Makes a profile current on the calling thread for the lifetime of the scope.
+  class Scope
+  {
+  public:
+    //! Constructor.
+    //! @param profile Profile to make current.
+    explicit Scope(TickProfile& profile) noexcept;
+    //! Destructor, restores the previously current profile.
+    ~Scope() noexcept;
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    TickProfile* _previous;
+  };
+
+  //! Returns whether a profile is current on the calling thread.
+  //! @returns `true` if a profile is current, `false` otherwise.
+  [[nodiscard]] static bool IsActive() noexcept;
+
+  //! Records a work item into the current profile of the calling thread, if any.
+  //! @param kind Kind of the work item.
+  //! @param type Type of the work item.
+  //! @param duration Duration of the work item.
+  static void Record(
+    std::string_view kind,
+    const std::type_info& type,
+    Clock::duration duration) noexcept;
+
+  //! Returns the slowest work items, the slowest first.
+  //! @returns Slowest work items.
+  [[nodiscard]] std::span<const Sample> GetSlowestSamples() const noexcept;
+
+  //! Formats the slowest work items into a single line.
+  //! @returns Formatted work items.
+  [[nodiscard]] std::string FormatSlowestSamples() const;
+
+private:
+  //! Adds a work item, if it is one of the slowest.
+  //! @param sample Work item.
+  void Add(const Sample& sample) noexcept;
+
+  //! Slowest work items, the slowest first.
+  std::array<Sample, MaxSampleCount> _samples{};
+  //! Count of the slowest work items.
+  std::size_t _sampleCount{};
+};
+
+//! Measurements of the ticks of a single source, such as a director or a network tick,
+//! ticked from a single thread at a time.
+struct TickMonitor
+{
+  explicit TickMonitor(std::string name)
+    : name(std::move(name))
+  {
+  }
+
+  //! A name of the source of the ticks.
+  std::string name;
+  //! Durations of the ticks.
+  LatencyHistogram tickDurations;
+  //! Time point of the last logged overrun of the budget.
+  std::chrono::steady_clock::time_point lastOverrunLog{};
+};
+
+} // namespace server
+
+#endif // ALICIA_SERVER_TICKPROFILE_HPP
@@ -48,6 +48,10 @@ public:
     std::string notice;
     //! Passphrase required to use the //promote command.
     std::string promotePassphrase;
+    //! Count of the threads the directors run on, zero for the count of the hardware threads.
+    uint32_t directorThreads{0};
+    //! Budget of a tick of a director in milliseconds, the ticks over it are logged.
+    uint32_t directorTickBudget{20};
   } general{};
 
   //!
@@ -80,6 +84,9 @@ public:
     bool enabled{true};
     Listen listen{
       .port = 10030};
+    //! Count of threads processing the network I/O.
+    //! The handlers of the server still run one at a time.
+    uint32_t ioThreads{1};
 
     struct Advertisement
     {
@@ -110,6 +117,9 @@ public:
     bool enabled{true};
     Listen listen{
       .port = 10031};
+    //! Count of threads processing the network I/O.
+    uint32_t ioThreads{1};
+
   } ranch{};
 
   //!
@@ -118,6 +128,8 @@ public:
     bool enabled{true};
     Listen listen{
       .port = 10032};
+    //! Count of threads processing the network I/O.
+    uint32_t ioThreads{1};
   } race{};
 
   //!
@@ -126,6 +138,8 @@ public:
     bool enabled{true};
     Listen listen{
       .port = 10033};
+    //! Count of threads processing the network I/O.
+    uint32_t ioThreads{1};
   } messenger{};
 
   //!
@@ -134,6 +148,8 @@ public:
     bool enabled{true};
     Listen listen{
       .port = 10034};
+    //! Count of threads processing the network I/O.
+    uint32_t ioThreads{1};
   } allChat{};
 
   struct PrivateChat
@@ -141,12 +157,17 @@ public:
     bool enabled{true};
     Listen listen{
       .port = 10035};
+    //! Count of threads processing the network I/O.
+    uint32_t ioThreads{1};
   } privateChat{};
 
   //!
   struct UdpRaceRelay
   {
     bool enabled{true};
+    //! Whether the relay runs in this process. The in-process relay is an inert
+    //! prototype with a framing of its own, which no client sends.
+    bool inProcess{false};
     Listen listen{
       .address = asio::ip::address_v4::loopback(),
       .port = 10500};
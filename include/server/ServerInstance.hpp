@@ -52,15 +52,37 @@
 #include <libserver/registry/PetRegistry.hpp>
 #include <libserver/registry/QuestRegistry.hpp>
 #include <libserver/registry/SystemContentRegistry.hpp>
+#include <libserver/util/Executor.hpp>
+#include <libserver/util/LatencyHistogram.hpp>
+#include <libserver/util/TickProfile.hpp>
 
 #include <spdlog/spdlog.h>
 
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace server
 {
 
 class ServerInstance final
 {
 public:
+  //! Tick metrics of a director.
+  struct DirectorTickMetrics
+  {
+    //! Name of the director.
+    std::string name;
+    //! Durations of the ticks since the previous collection.
+    LatencyHistogram::Summary tickDurations{};
+    //! Count of the periodic ticks which finished past their deadline since the previous collection.
+    uint64_t missedDeadlineCount{};
+  };
+
   //! Constructor.
   //! @param resourceDirectory Directory for server resources.
   explicit ServerInstance(const std::filesystem::path& resourceDirectory);
@@ -68,12 +90,20 @@ public:
 
   //! Initializes the server instance.
   void Initialize();
+  //! Blocks until the directors started by the initialization are initialized.
+  //! @returns `true` if all the directors initialized, `false` if any of them failed.
+  bool WaitForInitialization();
   //! Terminates the server instance.
   void Terminate();
 
   //! Loads configurations.
   void LoadConfigurations();
 
+  //! Sets a function adjusting the settings once they are loaded, before the directors start.
+  //! Must be set before the initialization.
+  //! @param settingsOverride Function adjusting the settings.
+  void SetSettingsOverride(std::function<void(Config&)> settingsOverride);
+
   //! Returns reference to the authentication service.
   //! @returns Reference to the authentication service.
   AuthenticationService& GetAuthenticationService();
@@ -106,6 +136,16 @@ public:
   //! @returns Reference to the private chat director.
   PrivateChatDirector& GetPrivateChatDirector();
 
+  //! Finds a command server by its name.
+  //! @param name Name of the server, one of `lobby`, `ranch` or `race`.
+  //! @returns Pointer to the command server or `nullptr` if there is no such server.
+  CommandServer* FindCommandServer(std::string_view name);
+
+  //! Finds a chatter server by its name.
+  //! @param name Name of the server, one of `messenger`, `allchat` or `privatechat`.
+  //! @returns Pointer to the chatter server or `nullptr` if there is no such server.
+  ChatterServer* FindChatterServer(std::string_view name);
+
   //! Returns reference to the Character registry.
   //! @returns Reference to the Character registry.
   registry::CharacterRegistry& GetCharacterRegistry();
@@ -198,90 +238,151 @@ public:
   //! @returns Reference to the settings.
   Config& GetSettings();
 
-private:
+  //! Returns the resource directory.
+  //! @returns Path to the resource directory.
+  const std::filesystem::path& GetResourceDirectory() const;
 
-  template<typename T>
-  void RunDirectorTaskLoop(T& director)
-  {
-    using Clock = std::chrono::steady_clock;
+  //! Runs a tick, measures it and logs its slowest work if it overruns the budget
+  //! of the director ticks. The overruns are logged at most once per second.
+  //! @param monitor Measurements of the source of the tick.
+  //! @param tick Tick to run.
+  void ProfileTick(TickMonitor& monitor, const std::function<void()>& tick);
 
-    constexpr uint64_t TicksPerSecond = 50;
-    constexpr uint64_t millisPerTick = 1000ull / TicksPerSecond;
+  //! Collects the tick metrics of the directors and resets them. Thread safe.
+  //! @returns Tick metrics of the directors.
+  std::vector<DirectorTickMetrics> CollectDirectorTickMetrics();
 
-    Clock::time_point lastTick;
-    while (_shouldRun.load(std::memory_order::relaxed))
+private:
+
+  //! A director running on the executor.
+  struct DirectorRun
+    : TickMonitor
+  {
+    DirectorRun(std::string name, Executor& executor)
+      : TickMonitor(std::move(name))
+      , strand(executor)
     {
-      const auto timeNow = Clock::now();
-      // Time delta between ticks [ms].
-      const auto tickDelta = std::chrono::duration_cast<
-        std::chrono::milliseconds>(timeNow - lastTick);
-
-      if (tickDelta < std::chrono::milliseconds(millisPerTick))
-      {
-        const auto sleepMs = millisPerTick - tickDelta.count();
-        std::this_thread::sleep_for(
-          std::chrono::milliseconds(sleepMs));
-        continue;
-      }
-
-      lastTick = timeNow;
-
-      try
-      {
-        director.Tick();
-      }
-      catch (const std::exception& x)
-      {
-        spdlog::error("Exception in tick loop: {}", x.what());
-      }
     }
+
+    //! Functions initializing, ticking and terminating the director.
+    std::function<void()> initialize;
+    std::function<void()> tick;
+    std::function<void()> terminate;
+    //! A function ticking the work queued for the director when it is woken up.
+    std::function<void()> tickQueuedWork;
+    //! A function returning the time point of the next periodic work of the director.
+    std::function<std::chrono::steady_clock::time_point()> getNextTickTime;
+    //! Time point of the last tick.
+    std::chrono::steady_clock::time_point lastTickTime{};
+    //! Time point of the scheduled tick, the max time point if the director sleeps until woken up.
+    std::chrono::steady_clock::time_point scheduledTickTime{};
+    //! A strand serializing the work of the director.
+    Executor::Strand strand;
+    //! Whether the director is initialized and not yet terminated.
+    std::atomic_bool isRunning{false};
+    //! Whether a wake up of the director is posted to its strand.
+    std::atomic_bool isWakePending{false};
+    //! Count of the periodic ticks which finished past the time of the next tick.
+    std::atomic<uint64_t> missedDeadlineCount{0};
+    //! Fulfilled once the director initialized, with whether the initialization succeeded.
+    std::promise<bool> initialized;
+    //! Fulfilled once the director terminated.
+    std::promise<void> terminated;
+  };
+
+  //! Runs a director on its own strand of the executor. The director is initialized,
+  //! ticked until the server should stop and then terminated.
+  //! @param name Name of the director.
+  //! @param director Director to run.
+  template<typename T>
+  void RunDirector(const std::string& name, T& director)
+  {
+    const auto run = std::make_shared<DirectorRun>(name, _executor);
+    run->initialize = [&director]() { director.Initialize(); };
+    run->tick = [&director]() { director.Tick(); };
+    run->terminate = [&director]() { director.Terminate(); };
+
+    // Directors with periodic work besides their queued work tick only the latter when woken up.
+    if constexpr (requires { director.TickQueuedWork(); })
+      run->tickQueuedWork = [&director]() { director.TickQueuedWork(); };
+    else
+      run->tickQueuedWork = run->tick;
+
+    // Directors aware of their next periodic work sleep until it or until woken up,
+    // the others tick periodically.
+    if constexpr (requires { director.GetNextTickTime(); })
+      run->getNextTickTime = [&director]() { return director.GetNextTickTime(); };
+    else
+      run->getNextTickTime = []() { return std::chrono::steady_clock::time_point::min(); };
+
+    if constexpr (requires { director.SetWakeHandler([]() {}); })
+      director.SetWakeHandler([this, run]() { WakeDirector(run); });
+
+    StartDirector(run);
   }
 
+  //! Starts a director on its strand.
+  //! @param run Director to start.
+  void StartDirector(const std::shared_ptr<DirectorRun>& run);
+  //! Wakes a director up to tick its queued work right away. Thread safe.
+  //! @param run Director to wake up.
+  void WakeDirector(const std::shared_ptr<DirectorRun>& run);
+  //! Ticks a director and schedules its next tick, or terminates it if the server should stop.
+  //! @param run Director to tick.
+  //! @param tickTime Time point of the tick.
+  void TickDirector(
+    const std::shared_ptr<DirectorRun>& run,
+    std::chrono::steady_clock::time_point tickTime);
+  //! Schedules the tick of a director, superseding its previously scheduled tick.
+  //! Must be called from the strand of the director.
+  //! @param run Director to schedule the tick of.
+  //! @param tickTime Time point of the tick, the max time point to sleep until woken up.
+  void ScheduleTick(
+    const std::shared_ptr<DirectorRun>& run,
+    std::chrono::steady_clock::time_point tickTime);
+
   //! Atomic flag indicating whether the server should run.
   std::atomic_bool _shouldRun{false};
 
+  //! An executor the directors run on.
+  Executor _executor;
+  //! Names of the running directors and the futures of their termination.
+  std::vector<std::pair<std::string, std::future<void>>> _directorTerminations;
+  //! Names of the running directors and the futures of their initialization.
+  std::vector<std::pair<std::string, std::future<bool>>> _directorInitializations;
+  //! The running directors. All of them are started during the initialization.
+  std::vector<std::shared_ptr<DirectorRun>> _directorRuns;
+  //! Budget of a tick of a director.
+  std::chrono::milliseconds _directorTickBudget{};
+
   //! A path to the resource directory.
   std::filesystem::path _resourceDirectory;
   //! A config.
   Config _config;
+  //! A function adjusting the loaded config.
+  std::function<void(Config&)> _settingsOverride;
 
-  //! A thread of the authentication service.
-  std::thread _authenticationThread;
   //! An authentication service.
   AuthenticationService _authenticationService;
 
-  //! A thread of the data director.
-  std::thread _dataDirectorThread;
   //! A data director.
   DataDirector _dataDirector;
 
-  //! A thread of the lobby director.
-  std::thread _lobbyDirectorThread;
   //! A lobby director.
   LobbyDirector _lobbyDirector;
 
-  //! A thread for the messenger director.
-  std::thread _messengerThread;
   //! A messenger director.
   MessengerDirector _messengerDirector;
 
-  //! A thread for the all chat director.
-  std::thread _allChatDirectorThread;
   //! An all chat director.
   AllChatDirector _allChatDirector;
 
-  //! A thread for the private chat director.
-  std::thread _privateChatDirectorThread;
   //! A private chat director.
   PrivateChatDirector _privateChatDirector;
 
-  //! A thread of the ranch director.
-  std::thread _ranchDirectorThread;
   //! A ranch director.
   RanchDirector _ranchDirector;
 
-  //! A thread of the race director.
-  std::thread _raceDirectorThread;
   //! A race director.
   RaceDirector _raceDirector;
 
@@ -325,8 +426,6 @@ private:
   //! A reward system.
   RewardSystem _rewardSystem;
 
-  //! A thread for telemetry.
-  std::thread _telemetryThread;
   //! Telemetry.
   Telemetry _telemetry;
 
@@ -23,6 +23,8 @@
 #include "AuthenticationBackend.hpp"
 
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -47,6 +49,20 @@ public:
   void Initialize();
   void Terminate() noexcept;
   void Tick() noexcept;
+  //! Returns the time point of the next periodic tick, the max time point while
+  //! there are no queued authentications.
+  //! @returns Time point of the next tick.
+  [[nodiscard]] std::chrono::steady_clock::time_point GetNextTickTime();
+
+  //! Sets the handler called when an authentication is queued,
+  //! so that the service can be ticked right away instead of in its next periodic tick.
+  //! Must be set before the authentications are queued.
+  //! @param wakeHandler Wake handler.
+  void SetWakeHandler(std::function<void()> wakeHandler);
+
+  //! Sets the handler called when a verdict is available. Thread safe.
+  //! @param verdictHandler Verdict handler.
+  void SetVerdictHandler(std::function<void()> verdictHandler);
 
   //! Thread safe
   void QueueAuthentication(
@@ -75,6 +91,11 @@ private:
   std::mutex _verdictsMutex{};
   std::vector<Verdict> _verdicts{};
 
+  //! A handler called when an authentication is queued.
+  std::function<void()> _wakeHandler;
+  //! A handler called when a verdict is available, guarded by the verdicts mutex.
+  std::function<void()> _verdictHandler;
+
   std::unique_ptr<AuthenticationBackend> _backend;
 };
 
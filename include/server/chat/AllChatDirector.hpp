@@ -10,6 +10,8 @@
 
 #include "server/Config.hpp"
 
+#include <chrono>
+
 namespace server
 {
 
@@ -39,12 +41,19 @@ public:
   //! @return Chat config.
   [[nodiscard]] Config::AllChat& GetConfig();
 
+  //! Get chatter server.
+  //! @return Chatter server.
+  [[nodiscard]] ChatterServer& GetChatterServer();
+
   void Initialize();
   void Terminate();
   ClientContext& GetClientContext(
     network::ClientId clientId,
     bool requireAuthentication = true);
   void Tick();
+  //! Returns the time point of the next periodic tick.
+  //! @returns The max time point, the director has no periodic work.
+  [[nodiscard]] std::chrono::steady_clock::time_point GetNextTickTime() const;
 
 private:
   void HandleClientConnected(network::ClientId clientId) override;
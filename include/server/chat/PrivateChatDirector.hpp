@@ -10,6 +10,8 @@
 
 #include "server/Config.hpp"
 
+#include <chrono>
+
 namespace server
 {
 
@@ -37,12 +39,19 @@ public:
   //! @return Chat config.
   [[nodiscard]] Config::PrivateChat& GetConfig();
 
+  //! Get chatter server.
+  //! @return Chatter server.
+  [[nodiscard]] ChatterServer& GetChatterServer();
+
   void Initialize();
   void Terminate();
   ConversationContext& GetConversationContext(
     network::ClientId clientId,
     bool requireAuthentication = true);
   void Tick();
+  //! Returns the time point of the next periodic tick.
+  //! @returns The max time point, the director has no periodic work.
+  [[nodiscard]] std::chrono::steady_clock::time_point GetNextTickTime() const;
 
 private:
   void HandleClientConnected(network::ClientId clientId) override;
@@ -81,6 +81,14 @@ public:
   void Terminate();
   //! Tick the director.
   void Tick();
+  //! Returns the time point of the next periodic tick, which is due right away
+  //! while there are queued logins to process.
+  //! @returns Time point of the next tick.
+  [[nodiscard]] Scheduler::Clock::time_point GetNextTickTime();
+  //! Sets the handler called when work is queued for the director,
+  //! so that it can be ticked right away instead of in its next periodic tick.
+  //! @param wakeHandler Wake handler.
+  void SetWakeHandler(const Scheduler::WakeHandler& wakeHandler);
 
   bool QueueClientConnect(
     network::ClientId clientId);
@@ -190,6 +198,8 @@ private:
   ServerInstance& _serverInstance;
   //! A scheduler.
   Scheduler _scheduler;
+  //! A handler called when work is queued for the director.
+  Scheduler::WakeHandler _wakeHandler;
   //! A shop manager.
   ShopManager _shopManager;
 
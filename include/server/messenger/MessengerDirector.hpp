@@ -12,6 +12,8 @@
 
 #include "server/Config.hpp"
 
+#include <chrono>
+
 namespace server
 {
 
@@ -52,6 +54,10 @@ public:
   //! @return Messenger config.
   [[nodiscard]] Config::Messenger& GetConfig();
 
+  //! Get chatter server.
+  //! @return Chatter server.
+  [[nodiscard]] ChatterServer& GetChatterServer();
+
   ClientContext& GetClientContext(
     network::ClientId clientId,
     bool requireAuthentication = true);
@@ -64,6 +70,9 @@ public:
     const BreedingMarket::Earnings& earnings);
 
   void Tick();
+  //! Returns the time point of the next periodic tick.
+  //! @returns The max time point, the director has no periodic work.
+  [[nodiscard]] std::chrono::steady_clock::time_point GetNextTickTime() const;
 
 private:
   void HandleClientConnected(network::ClientId clientId) override;
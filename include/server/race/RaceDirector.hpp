@@ -45,6 +45,16 @@ public:
   void Initialize();
   void Terminate();
   void Tick();
+  //! Ticks the work queued for the director, without the periodic ticks of the races.
+  void TickQueuedWork();
+  //! Returns the time point of the next periodic tick, which is due right away
+  //! while there are races to tick.
+  //! @returns Time point of the next tick.
+  [[nodiscard]] Scheduler::Clock::time_point GetNextTickTime();
+  //! Sets the handler called when work is queued for the director,
+  //! so that its queued work can be ticked right away instead of in its next periodic tick.
+  //! @param wakeHandler Wake handler.
+  void SetWakeHandler(const Scheduler::WakeHandler& wakeHandler);
 
   void DisconnectCharacter(data::Uid characterUid);
   void NotifySummonCharacter(
@@ -29,6 +29,7 @@
 #include "server/tracker/RaceTracker.hpp"
 
 #include "libserver/registry/MagicRegistry.hpp"
+#include "libserver/network/UdpRelay.hpp"
 #include "libserver/network/command/CommandServer.hpp"
 #include "libserver/network/command/proto/CommonMessageDefinitions.hpp"
 #include "libserver/network/command/proto/RaceMessageDefinitions.hpp"
@@ -53,6 +54,16 @@ public:
   void Initialize();
   void Terminate();
   void Tick();
+  //! Ticks the scheduler, without the periodic ticks of the races.
+  void TickScheduler();
+  //! Returns the time point of the next periodic tick, which is due right away
+  //! while there are races to tick.
+  //! @returns Time point of the next tick.
+  [[nodiscard]] Scheduler::Clock::time_point GetNextTickTime();
+  //! Sets the handler called when a job due immediately is queued to the scheduler
+  //! or when a race is created.
+  //! @param wakeHandler Wake handler.
+  void SetWakeHandler(const Scheduler::WakeHandler& wakeHandler);
 
   void NotifyRoomNameChanged(uint32_t roomUid) noexcept;
 
@@ -92,17 +103,15 @@ public:
     const RaceInstance& raceInstance,
     const C& command)
   {
+    std::vector<ClientId> recipients;
     raceInstance.GetRoom(
-      [this, command](const Room& room)
+      [&recipients](const Room& room)
       {
         for (const auto& player : room.GetPlayers() | std::views::values)
-          _commandServer.QueueCommand<C>(
-            player.GetClientId(),
-            [command]()
-            {
-              return command;
-            });
+          recipients.emplace_back(player.GetClientId());
       });
+
+    _commandServer.Broadcast(recipients, command);
   }
 
   template <WritableStruct C>
@@ -111,22 +120,20 @@ public:
     const C& command,
     data::Uid skipCharacterUid)
   {
+    std::vector<ClientId> recipients;
     raceInstance.GetRoom(
-      [this, command, skipCharacterUid](const Room& room)
+      [&recipients, skipCharacterUid](const Room& room)
       {
         for (const auto& [characterUid, player] : room.GetPlayers())
         {
           if (characterUid == skipCharacterUid)
             continue;
 
-          _commandServer.QueueCommand<C>(
-            player.GetClientId(),
-            [command]()
-            {
-              return command;
-            });
+          recipients.emplace_back(player.GetClientId());
         }
       });
+
+    _commandServer.Broadcast(recipients, command);
   }
 
 private:
@@ -144,6 +151,9 @@ private:
     data::Uid roomUid{data::InvalidUid};
     bool isAuthenticated = false;
     std::string userName;
+    //! One time password the client entered the room with,
+    //! binds the session of the client in the UDP relay.
+    uint32_t oneTimePassword{};
   };
 
   race::P2dId GetOrCreateP2dId(ClientId clientId);
@@ -386,6 +396,8 @@ private:
 
   //! A scheduler instance.
   Scheduler _scheduler;
+  //! A handler called when a race is created.
+  Scheduler::WakeHandler _wakeHandler;
   //! A server instance.
   ServerInstance& _serverInstance;
   //! A command server instance.
@@ -396,6 +408,8 @@ private:
   std::unordered_map<ClientId, race::P2dId> _p2dIds;
   //! A pool for active race clients with P2dIds.
   race::P2dIdPool _p2dIdPool;
+  //! A UDP relay of the race traffic, its sessions are the P2dIds.
+  network::UdpRelay _udpRelay;
 
   std::mutex _raceInstancesMutex;
   //! A map of all race instanced indexed by room UIDs.
@@ -117,6 +117,9 @@ public:
   void Terminate();
   //! Ticks the breeding market.
   void Tick();
+  //! Returns the time point of the next scheduled job of the breeding market.
+  //! @returns Time point of the next tick.
+  [[nodiscard]] Scheduler::Clock::time_point GetNextTickTime();
 
   [[nodiscard]] bool HandleRegisterStallion(
     data::Uid characterUid,
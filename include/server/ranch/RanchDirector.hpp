@@ -22,6 +22,7 @@
 
 #include "libserver/network/command/CommandDeferrer.hpp"
 #include "libserver/util/Scheduler.hpp"
+#include "libserver/util/TickProfile.hpp"
 #include "server/Config.hpp"
 #include "server/ranch/BreedingMarket.hpp"
 #include "server/tracker/RanchTracker.hpp"
@@ -31,6 +32,8 @@
 #include "libserver/network/command/proto/RanchMessageDefinitions.hpp"
 #include "libserver/network/command/proto/CommonMessageDefinitions.hpp"
 
+#include <chrono>
+#include <optional>
 #include <random>
 #include <unordered_map>
 #include <unordered_set>
@@ -51,10 +54,22 @@ public:
   void Initialize();
   void Terminate();
   void Tick();
+  //! Returns the time point of the next scheduled job of the director or the breeding market.
+  //! @returns Time point of the next tick.
+  [[nodiscard]] Scheduler::Clock::time_point GetNextTickTime();
+  //! Sets the handler called when work is queued for the director,
+  //! so that it can be ticked right away instead of in its next periodic tick.
+  //! @param wakeHandler Wake handler.
+  void SetWakeHandler(const Scheduler::WakeHandler& wakeHandler);
 
   std::vector<data::Uid> GetOnlineCharacters();
 
   void HandleNetworkTick() override;
+
+  //! Returns the metrics of the command deferrers, summed up.
+  //! The wait time percentiles are the worst of the deferrers.
+  //! @returns Metrics of the command deferrers.
+  [[nodiscard]] CommandDeferrerMetrics GetDeferredCommandMetrics() const;
   void HandleClientConnected(ClientId clientId) override;
   void HandleClientDisconnected(ClientId client) override;
 
@@ -121,6 +136,7 @@ public:
 
   ServerInstance& GetServerInstance();
   Config::Ranch& GetConfig();
+  CommandServer& GetCommandServer();
 
 private:
   struct ClientContext
@@ -147,13 +163,6 @@ private:
     //! is bred; the maturity sweep only looks at these, and only does a record
     //! lookup once an entry's deadline has passed.
     std::unordered_map<data::Uid, data::Clock::time_point> maturingFoals;
-
-    //! Number of times a deferred ranch entry has been retried while waiting
-    //! for horse records to load. Capped so the client isn't stuck forever.
-    uint32_t enterRanchDeferAttempts{0};
-
-    //! Number of times a deferred breeding attempt has been retried 
-    uint32_t tryBreedingDeferAttempts{0};
   };
 
   struct RanchInstance
@@ -164,6 +173,30 @@ private:
     std::unordered_set<ClientId> clients;
   };
 
+  //! Broadcasts the command to the clients of the ranch.
+  //! The command is encoded once for all the recipients.
+  //! @param ranchInstance Ranch instance.
+  //! @param command Command.
+  //! @param skipClientId Optional ID of the client to not broadcast to.
+  template <WritableStruct C>
+  void BroadcastToRanch(
+    const RanchInstance& ranchInstance,
+    const C& command,
+    std::optional<ClientId> skipClientId = std::nullopt)
+  {
+    std::vector<ClientId> recipients;
+    recipients.reserve(ranchInstance.clients.size());
+    for (const ClientId ranchClientId : ranchInstance.clients)
+    {
+      if (ranchClientId == skipClientId)
+        continue;
+
+      recipients.emplace_back(ranchClientId);
+    }
+
+    _commandServer.Broadcast(recipients, command);
+  }
+
   //! Get client context.
   //! @param clientId Id of the client.
   //! @param requireAuthentication Require the client to be authorized.
@@ -266,10 +299,13 @@ private:
   //! Handles the breeding attempt command.
   //! @param clientId ID of the client.
   //! @param command Command.
+  //! @param isWaitOver Whether the wait for the ancestry is over,
+  //!                   the breeding then proceeds with the records at hand.
   //! @returns True if the command should be deferred and retried
   bool HandleTryBreeding(
     ClientId clientId,
-    const protocol::AcCmdCRTryBreeding& command);
+    const protocol::AcCmdCRTryBreeding& command,
+    bool isWaitOver = false);
 
   //! Rolls a breeding bonus based on the stallion's grade.
   //! @param stallionGrade Grade of the stallion.
@@ -470,8 +506,15 @@ private:
   void HandleRequestLeagueTeamList(ClientId clientId,
     const protocol::RanchCommandRequestLeagueTeamList& command);
 
+  //! Handles the family tree command.
+  //! @param clientId ID of the client.
+  //! @param command Command.
+  //! @param isWaitOver Whether the wait for the ancestors is over,
+  //!                   the response then carries the records at hand.
+  //! @returns True if the command should be deferred and retried.
   bool HandleMountFamilyTree(ClientId clientId,
-    const protocol::AcCmdCRMountFamilyTree& command);
+    const protocol::AcCmdCRMountFamilyTree& command,
+    bool isWaitOver = false);
 
   void HandleRecoverMount(
     ClientId clientId,
@@ -615,6 +658,8 @@ private:
 
   //! A command deferrer for the `AcCmdCRTryBreeding` command.
   CommandDeferrer<protocol::AcCmdCRTryBreeding> _tryBreedingDeferrer;
+  //! Measurements of the network ticks, which resume the deferred commands.
+  TickMonitor _networkTickMonitor{"ranch network"};
 
   //! Drives periodic ranch chores, such as the foal maturity sweep.
   Scheduler _scheduler;
@@ -23,6 +23,7 @@
 #include <libserver/util/Scheduler.hpp>
 #include <libserver/util/TimeSeriesData.hpp>
 
+#include <chrono>
 #include <optional>
 
 #include <pqxx/pqxx>
@@ -40,12 +41,34 @@ public:
   void Initialize();
   void Terminate();
   void Tick();
+  //! Returns the time point of the next collection or synchronization of the data.
+  //! @returns Time point of the next tick.
+  [[nodiscard]] Scheduler::Clock::time_point GetNextTickTime();
 
 private:
   //! Time series data tracking the player count.
   TimeSeriesData<size_t, 3600> _playerCountMetric;
   //! Time series data tracking the race count.
   TimeSeriesData<size_t, 3600> _roomCountMetric;
+  //! Time series data tracking the outbound queued bytes of the slowest client.
+  TimeSeriesData<size_t, 3600> _outboundQueueBytesMetric;
+  //! Time series data tracking the count of the deferred ranch commands.
+  TimeSeriesData<size_t, 3600> _deferredCommandCountMetric;
+  //! Time series data tracking the mean wait of the deferred ranch commands
+  //! completed since the previous collection, in milliseconds.
+  TimeSeriesData<size_t, 3600> _deferredCommandWaitMetric;
+
+  //! Time series data tracking the worst 99th percentile of the tick durations
+  //! of the directors since the previous collection, in microseconds.
+  TimeSeriesData<size_t, 3600> _directorTickDurationMetric;
+  //! Time series data tracking the count of the deadlines missed by the directors
+  //! since the previous collection.
+  TimeSeriesData<size_t, 3600> _directorMissedDeadlineMetric;
+
+  //! Count of the completed deferred commands at the previous collection.
+  uint64_t _deferredCommandWaitCount{};
+  //! Total wait of the completed deferred commands at the previous collection.
+  std::chrono::nanoseconds _deferredCommandWaitTotal{};
 
   //! Flag indicating whether telemetry is enabled.
   bool enabled = false;
@@ -23,6 +23,7 @@
 #include "server/tracker/Tracker.hpp"
 
 #include <libserver/data/DataDefinitions.hpp>
+#include <libserver/network/NetworkDefinitions.hpp>
 #include <libserver/network/command/proto/CommonStructureDefinitions.hpp>
 #include <libserver/registry/ItemRegistry.hpp>
 
@@ -71,6 +72,8 @@ public:
     };
 
     Oid oid{InvalidEntityOid};
+    //! ID of the client of the racer.
+    network::ClientId clientId{};
     State state{State::Disconnected};
     Team team{Team::Solo};
     //! The racer's position in the world, as a vector.
@@ -189,6 +192,10 @@ public:
   //! Returns a reference to all racer records.
   //! @return Reference to racer records.
   [[nodiscard]] RacerObjectMap& GetRacers();
+  //! Finds the racer with the OID.
+  //! @param oid OID of the racer.
+  //! @returns Racer record, or null if no racer has the OID.
+  [[nodiscard]] Racer* FindRacerByOid(Oid oid);
 
   //! Adds an item for tracking.
   //! @returns A reference to the new item record.
@@ -241,6 +248,8 @@ private:
   Oid _nextItemDeckOid = 1;
   //! Racer entities.
   RacerObjectMap _racers;
+  //! Character UIDs of the racers indexed by their OIDs.
+  std::unordered_map<Oid, data::Uid> _racerOids;
   //! Item deck entities.
   ItemDeckMap _itemDecks;
   //! Tracked race map events.
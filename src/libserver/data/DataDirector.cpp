@@ -819,6 +819,52 @@ void DataDirector::Tick()
   }
 }
 
+Scheduler::Clock::time_point DataDirector::GetNextTickTime()
+{
+  return _scheduler.GetNextDueTime();
+}
+
+void DataDirector::SetWakeHandler(const Scheduler::WakeHandler& wakeHandler)
+{
+  _userStorage.SetWakeHandler(wakeHandler);
+  _infractionStorage.SetWakeHandler(wakeHandler);
+  _characterStorage.SetWakeHandler(wakeHandler);
+  _horseStorage.SetWakeHandler(wakeHandler);
+  _itemStorage.SetWakeHandler(wakeHandler);
+  _storageItemStorage.SetWakeHandler(wakeHandler);
+  _eggStorage.SetWakeHandler(wakeHandler);
+  _petStorage.SetWakeHandler(wakeHandler);
+  _guildStorage.SetWakeHandler(wakeHandler);
+  _housingStorage.SetWakeHandler(wakeHandler);
+  _stallionStorage.SetWakeHandler(wakeHandler);
+  _settingsStorage.SetWakeHandler(wakeHandler);
+  _dailyQuestGroupStorage.SetWakeHandler(wakeHandler);
+  _mailStorage.SetWakeHandler(wakeHandler);
+  _questStorage.SetWakeHandler(wakeHandler);
+  _rewardStorage.SetWakeHandler(wakeHandler);
+  _scheduler.SetWakeHandler(wakeHandler);
+}
+
+uint64_t DataDirector::GetRetrieveEpoch() const noexcept
+{
+  return _userStorage.GetRetrieveEpoch()
+    + _infractionStorage.GetRetrieveEpoch()
+    + _characterStorage.GetRetrieveEpoch()
+    + _horseStorage.GetRetrieveEpoch()
+    + _itemStorage.GetRetrieveEpoch()
+    + _storageItemStorage.GetRetrieveEpoch()
+    + _eggStorage.GetRetrieveEpoch()
+    + _petStorage.GetRetrieveEpoch()
+    + _guildStorage.GetRetrieveEpoch()
+    + _housingStorage.GetRetrieveEpoch()
+    + _stallionStorage.GetRetrieveEpoch()
+    + _settingsStorage.GetRetrieveEpoch()
+    + _dailyQuestGroupStorage.GetRetrieveEpoch()
+    + _mailStorage.GetRetrieveEpoch()
+    + _questStorage.GetRetrieveEpoch()
+    + _rewardStorage.GetRetrieveEpoch();
+}
+
 void DataDirector::RequestLoadUserData(
   const std::string& userName)
 {
@@ -20,7 +20,9 @@
 #include "libserver/network/Server.hpp"
 #include "libserver/util/Deferred.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <ranges>
 #include <spdlog/spdlog.h>
 #include <stacktrace>
@@ -36,13 +38,21 @@ constexpr std::size_t MaxTotalConnections = 1024;
 constexpr std::size_t MaxConnectRatePerAddress = 10;
 constexpr auto RateWindow = std::chrono::seconds(30);
 
+//! Initial size of a read.
+constexpr std::size_t MinReadSize = 1024;
+//! Max size of a read.
+constexpr std::size_t MaxReadSize = 64 * 1024;
+
 } // namespace
 
 Client::Client(
   ClientId clientId,
   asio::ip::tcp::socket&& socket,
-  EventHandlerInterface& networkEventHandler) noexcept
-  : _clientId(clientId)
+  EventHandlerInterface& networkEventHandler,
+  const WriteQueueLimits& writeQueueLimits) noexcept
+  : _writeQueueLimits(writeQueueLimits)
+  , _readSize(MinReadSize)
+  , _clientId(clientId)
   , _socket(std::move(socket))
   , _networkEventHandler(networkEventHandler)
 {
@@ -56,9 +66,13 @@ void Client::Begin()
   if (_shouldRun.exchange(true, std::memory_order::acq_rel))
     return;
 
-  _networkEventHandler.OnClientConnected(_clientId);
-
-  ReadLoop();
+  asio::dispatch(
+    _socket.get_executor(),
+    [clientPtr = this->shared_from_this()]()
+    {
+      clientPtr->_networkEventHandler.OnClientConnected(clientPtr->_clientId);
+      clientPtr->ReadLoop();
+    });
 }
 
 void Client::End()
@@ -66,33 +80,133 @@ void Client::End()
   if (not _shouldRun.exchange(false, std::memory_order::seq_cst))
     return;
 
-  try
-  {
-    if (_socket.is_open())
+  // The socket is closed on the strand of the client,
+  // so that the shutdown does not race the pending operations.
+  asio::dispatch(
+    _socket.get_executor(),
+    [clientPtr = this->shared_from_this()]()
     {
-      _socket.shutdown(asio::socket_base::shutdown_both);
-      _socket.close();
-    }
-  }
-  catch (const std::exception&)
-  {
-    // Ignore
-  }
+      try
+      {
+        if (clientPtr->_socket.is_open())
+        {
+          clientPtr->_socket.shutdown(asio::socket_base::shutdown_both);
+          clientPtr->_socket.close();
+        }
+      }
+      catch (const std::exception&)
+      {
+        // Ignore
+      }
+    });
 
   _networkEventHandler.OnClientDisconnected(_clientId);
 }
 
-void Client::QueueWrite(WriteSupplier writeSupplier)
+void Client::QueueWrite(
+  WriteBuffer writeBuffer,
+  const WritePriority priority)
+{
+  QueueWrite(
+    std::make_shared<const WriteBuffer>(std::move(writeBuffer)),
+    priority);
+}
+
+void Client::QueueWrite(
+  SharedWriteBuffer writeBuffer,
+  const WritePriority priority)
 {
   if (not _shouldRun.load(std::memory_order::acquire))
     return;
 
+  bool isOverLimit = false;
   {
     std::scoped_lock lock(_writeMutex);
-    _writeQueue.emplace(writeSupplier);
+
+    const std::size_t writeSize = writeBuffer->size();
+    const bool isOverHighWater =
+      _writeQueueStats.queuedBytes + writeSize > _writeQueueLimits.highWaterBytes
+      || _writeQueueStats.queuedMessages + 1 > _writeQueueLimits.highWaterMessages;
+
+    if (isOverHighWater)
+    {
+      // The client does not keep up with the written data,
+      // drop the droppable write.
+      if (priority == WritePriority::Droppable)
+      {
+        ++_writeQueueStats.droppedMessages;
+        return;
+      }
+
+      // Drop the queued droppable writes in favour of the reliable one.
+      std::erase_if(
+        _writeQueue,
+        [this](const QueuedWrite& queuedWrite)
+        {
+          if (queuedWrite.priority != WritePriority::Droppable)
+            return false;
+
+          _writeQueueStats.queuedBytes -= queuedWrite.buffer->size();
+          --_writeQueueStats.queuedMessages;
+          ++_writeQueueStats.droppedMessages;
+          return true;
+        });
+    }
+
+    _writeQueueStats.queuedBytes += writeSize;
+    ++_writeQueueStats.queuedMessages;
+    _writeQueue.emplace_back(QueuedWrite{
+      .buffer = std::move(writeBuffer),
+      .priority = priority});
+
+    isOverLimit = _writeQueueStats.queuedBytes > _writeQueueLimits.maxBytes
+      || _writeQueueStats.queuedMessages > _writeQueueLimits.maxMessages;
+
+    if (isOverLimit)
+    {
+      // The slow consumer is evicted only once.
+      if (_isEvictionPending.exchange(true, std::memory_order::relaxed))
+        return;
+
+      spdlog::warn(
+        "Client {} is disconnecting because its write queue exceeded the limit ({} bytes, {} messages)",
+        _clientId,
+        _writeQueueStats.queuedBytes,
+        _writeQueueStats.queuedMessages);
+    }
+  }
+
+  // Disconnect the slow consumer. The eviction is posted, never run inline,
+  // so that the disconnect notification does not re-enter the code which queued the write,
+  // which might be iterating over its clients.
+  if (isOverLimit)
+  {
+    asio::post(
+      _socket.get_executor(),
+      [clientPtr = this->shared_from_this()]()
+      {
+        clientPtr->End();
+      });
+    return;
   }
 
-  WriteLoop();
+  // The writes may be queued from any thread,
+  // the write loop itself runs on the strand of the client.
+  asio::dispatch(
+    _socket.get_executor(),
+    [clientPtr = this->shared_from_this()]()
+    {
+      clientPtr->WriteLoop();
+    });
+}
+
+WriteQueueStats Client::GetWriteQueueStats()
+{
+  std::scoped_lock lock(_writeMutex);
+
+  auto stats = _writeQueueStats;
+  stats.maxQueuedBytes = stats.queuedBytes;
+  return stats;
 }
 
 asio::ip::address_v4 Client::GetAddress() const noexcept
@@ -107,47 +221,42 @@ uint16_t Client::GetPort() const noexcept
 
 void Client::WriteLoop() noexcept
 {
-  // todo: forgive me for this, its not clean, its not pretty and i'm pretty sure there some side effects
-  //       i'll nuke it in the future
-
   if (not _shouldRun.load(std::memory_order::acquire))
     return;
 
-  if (_isSending.load(std::memory_order::acquire))
+  // Only one write may be in progress at a time,
+  // the write completion continues the loop.
+  if (_isSending)
     return;
 
-  std::scoped_lock lock(_writeMutex);
-  if (_writeQueue.empty())
+  // Take all the queued buffers as the next write batch.
   {
-    return;
+    std::scoped_lock lock(_writeMutex);
+    if (_writeQueue.empty())
+      return;
+
+    std::swap(_writeQueue, _writeBatch);
   }
 
-  // Write the suppliers to the write buffer.
-  while (not _writeQueue.empty())
+  // Gather the buffers of the batch into one buffer sequence.
+  _writeBufferSequence.clear();
+  _writeBatchBytes = 0;
+  for (const auto& queuedWrite : _writeBatch)
   {
-    try
-    {
-      const auto& supplier = _writeQueue.front();
-      supplier(_writeBuffer);
-      _writeQueue.pop();
-    }
-    catch (const std::exception& e)
-    {
-      spdlog::error("Unhandled exception in supplier of write data for client {}: {}",
-        _clientId,
-        e.what());
-      End();
-      return;
-    }
+    _writeBufferSequence.emplace_back(
+      queuedWrite.buffer->data(),
+      queuedWrite.buffer->size());
+    _writeBatchBytes += queuedWrite.buffer->size();
   }
 
-  _isSending.store(true, std::memory_order::release);
+  _isSending = true;
 
-  // Asynchronously write the data to the socket.
+  // Asynchronously write the whole batch to the socket.
   _writeProfiler.Start();
-  _socket.async_write_some(
-    _writeBuffer.data(),
-    [clientPtr = this->shared_from_this()](const boost::system::error_code& error, const std::size_t size)
+  asio::async_write(
+    _socket,
+    _writeBufferSequence,
+    [clientPtr = this->shared_from_this()](const boost::system::error_code& error, const std::size_t)
     {
       try
       {
@@ -164,24 +273,26 @@ void Client::WriteLoop() noexcept
                 std::format("Generic network error {}", error.message()));
           }
         }
-
-        // Consume the sent bytes.
-        {
-          std::scoped_lock lock(clientPtr->_writeMutex);
-          clientPtr->_writeBuffer.consume(size);
-        }
       }
       catch (const std::exception& x)
       {
         spdlog::debug(
-          "Client {} is disconnecting because of read loop exception: {}",
+          "Client {} is disconnecting because of write loop exception: {}",
           clientPtr->_clientId,
           x.what());
 
         clientPtr->End();
       }
 
-      clientPtr->_isSending.store(false, std::memory_order::release);
+      {
+        std::scoped_lock lock(clientPtr->_writeMutex);
+        clientPtr->_writeQueueStats.queuedBytes -= clientPtr->_writeBatchBytes;
+        clientPtr->_writeQueueStats.queuedMessages -= clientPtr->_writeBatch.size();
+      }
+
+      // Clear the written batch, its capacity is reused by the write queue.
+      clientPtr->_writeBatch.clear();
+      clientPtr->_isSending = false;
       clientPtr->_writeProfiler.Stop();
       clientPtr->WriteLoop();
     });
@@ -192,9 +303,13 @@ void Client::ReadLoop() noexcept
   if (not _shouldRun.load(std::memory_order::acquire))
     return;
 
+  // Make space for the next read after the data already buffered.
+  if (_readBuffer.size() < _readBufferSize + _readSize)
+    _readBuffer.resize(_readBufferSize + _readSize);
+
   _readProfiler.Start();
   _socket.async_read_some(
-    _readBuffer.prepare(1024),
+    asio::buffer(_readBuffer.data() + _readBufferSize, _readSize),
     [clientPtr = this->shared_from_this()](boost::system::error_code error, std::size_t size)
     {
       try
@@ -214,17 +329,42 @@ void Client::ReadLoop() noexcept
           }
         }
 
-        clientPtr->_readBuffer.commit(size);
+        // If the read filled the whole space,
+        // there's likely more data pending, grow the size of the next read.
+        const bool isReadFull = size == clientPtr->_readSize;
+
+        clientPtr->_readBufferSize += size;
 
+        // The received data are passed as mutable,
+        // so that the handler can decode them in place.
         const std::span receivedData{
-          static_cast<const std::byte*>(clientPtr->_readBuffer.data().data()),
-          clientPtr->_readBuffer.data().size()};
+          clientPtr->_readBuffer.data(),
+          clientPtr->_readBufferSize};
 
         const auto consumedBytes = clientPtr->_networkEventHandler.OnClientData(
           clientPtr->_clientId,
           receivedData);
 
-        clientPtr->_readBuffer.consume(consumedBytes);
+        // Move the data that were not consumed to the front of the buffer.
+        const auto pendingSize = clientPtr->_readBufferSize - consumedBytes;
+        if (consumedBytes > 0 && pendingSize > 0)
+        {
+          std::memmove(
+            clientPtr->_readBuffer.data(),
+            clientPtr->_readBuffer.data() + consumedBytes,
+            pendingSize);
+        }
+
+        clientPtr->_readBufferSize = pendingSize;
+
+        // The data left in the buffer are a partially received frame,
+        // make sure the next read can hold at least the same amount.
+        if (isReadFull || pendingSize > clientPtr->_readSize)
+        {
+          clientPtr->_readSize = std::min(
+            std::max(clientPtr->_readSize * 2, pendingSize),
+            MaxReadSize);
+        }
 
         // Continue the read loop.
         clientPtr->_readProfiler.Stop();
@@ -243,13 +383,17 @@ void Client::ReadLoop() noexcept
 }
 
 Server::Server(EventHandlerInterface& networkEventHandler) noexcept
-  : _acceptor(_io_ctx)
+  : _eventStrand(asio::make_strand(_io_ctx))
+  , _acceptor(_io_ctx)
   , _timer(_io_ctx)
   , _networkEventHandler(networkEventHandler)
 {
 }
 
-void Server::Begin(const asio::ip::address& address, uint16_t port)
+void Server::Begin(
+  const asio::ip::address& address,
+  uint16_t port,
+  uint32_t ioThreadCount)
 {
   const asio::ip::tcp::endpoint server_endpoint(address, port);
 
@@ -272,25 +416,51 @@ void Server::Begin(const asio::ip::address& address, uint16_t port)
   // Run the accept loop.
   AcceptLoop();
 
-  try
+  // Run the tick loop.
+  asio::post(_eventStrand, [this]()
   {
-    // Run the tick loop.
     TickLoop();
-  }
-  catch (const std::exception& x)
+  });
+
+  // Run the additional I/O threads, the current thread is the first one.
+  for (uint32_t threadIdx = 1; threadIdx < ioThreadCount; ++threadIdx)
   {
-    throw std::runtime_error(
-      std::format(
-        "Exception in network tick loop: {}",
-        x.what()));
+    _ioThreads.emplace_back([this, threadIdx]()
+    {
+      try
+      {
+        _io_ctx.run();
+      }
+      catch (const std::exception& x)
+      {
+        spdlog::error(
+          "Exception in asio IO context (I/O thread {}): {}",
+          threadIdx,
+          x.what());
+        End();
+      }
+    });
   }
 
+  const Deferred deferredJoinIoThreads([this]()
+  {
+    for (auto& ioThread : _ioThreads)
+    {
+      if (ioThread.joinable())
+        ioThread.join();
+    }
+
+    _ioThreads.clear();
+  });
+
   try
   {
     _io_ctx.run();
   }
   catch (const std::exception& x)
   {
+    End();
+
     throw std::runtime_error(
       std::format(
         "Exception in asio IO context: {}",
@@ -306,15 +476,64 @@ void Server::End()
 
 std::shared_ptr<Client> Server::GetClient(ClientId clientId)
 {
-  const auto clientItr = _clients.find(clientId);
-  if (clientItr == _clients.end())
+  auto client = FindClient(clientId);
+  if (not client)
   {
     throw std::runtime_error("Invalid client");
   }
 
+  return client;
+}
+
+std::shared_ptr<Client> Server::FindClient(ClientId clientId)
+{
+  std::scoped_lock lock(_clientsMutex);
+
+  const auto clientItr = _clients.find(clientId);
+  if (clientItr == _clients.end())
+    return nullptr;
+
   return clientItr->second->shared_from_this();
 }
 
+void Server::SetTickInterval(const std::chrono::steady_clock::duration tickInterval)
+{
+  _tickInterval = tickInterval;
+}
+
+void Server::SetWriteQueueLimits(const WriteQueueLimits& writeQueueLimits)
+{
+  std::scoped_lock lock(_clientsMutex);
+  _writeQueueLimits = writeQueueLimits;
+}
+
+WriteQueueStats Server::GetWriteQueueStats()
+{
+  std::vector<std::shared_ptr<Client>> clients;
+  {
+    std::scoped_lock lock(_clientsMutex);
+    for (const auto& client : _clients | std::views::values)
+      clients.emplace_back(client);
+  }
+
+  WriteQueueStats stats{};
+  for (const auto& client : clients)
+  {
+    const auto clientStats = client->GetWriteQueueStats();
+    stats.queuedBytes += clientStats.queuedBytes;
+    stats.queuedMessages += clientStats.queuedMessages;
+    stats.droppedMessages += clientStats.droppedMessages;
+    stats.maxQueuedBytes = std::max(stats.maxQueuedBytes, clientStats.queuedBytes);
+  }
+
+  return stats;
+}
+
+void Server::PostEvent(std::function<void()> task)
+{
+  asio::post(_eventStrand, std::move(task));
+}
+
 void Server::HandleNetworkTick()
 {
 }
@@ -322,32 +541,49 @@ void Server::HandleNetworkTick()
 void Server::OnClientConnected(
   ClientId clientId)
 {
-  _networkEventHandler.OnClientConnected(clientId);
+  // The data of the client are handled after the connection,
+  // as they are posted to the event strand later on.
+  PostEvent([this, clientId]()
+  {
+    _networkEventHandler.OnClientConnected(clientId);
+  });
 }
 
 void Server::OnClientDisconnected(
   ClientId clientId)
 {
-  const auto clientIt = _clients.find(clientId);
-  assert(clientIt != _clients.end());
+  {
+    std::scoped_lock lock(_clientsMutex);
 
-  const auto address = clientIt->second->GetAddress();
-  OnThrottleDisconnect(address);
+    const auto clientIt = _clients.find(clientId);
+    assert(clientIt != _clients.end());
 
-  _networkEventHandler.OnClientDisconnected(clientId);
+    const auto address = clientIt->second->GetAddress();
+    OnThrottleDisconnect(address);
+  }
 
-  _clients.erase(clientIt);
+  // The client is kept until the disconnection is handled,
+  // the data received before the disconnection are handled first.
+  PostEvent([this, clientId]()
+  {
+    _networkEventHandler.OnClientDisconnected(clientId);
+
+    std::scoped_lock lock(_clientsMutex);
+    _clients.erase(clientId);
+  });
 }
 
 size_t Server::OnClientData(
   ClientId clientId,
-  const std::span<const std::byte>& data)
+  const std::span<std::byte>& data)
 {
   return _networkEventHandler.OnClientData(clientId, data);
 }
 
 bool Server::IsConnectionThrottled(const asio::ip::address_v4& address) noexcept
 {
+  std::scoped_lock lock(_clientsMutex);
+
   auto& state = _addressStates[address];
   // If there are more active connections than allowed by `MaxConnectionsPerAddress`
   // throttle the connection from the address.
@@ -379,6 +615,7 @@ bool Server::IsConnectionThrottled(const asio::ip::address_v4& address) noexcept
 
 void Server::OnThrottleDisconnect(const asio::ip::address_v4& address) noexcept
 {
+  // Expects the clients mutex to be locked by the caller.
   const auto it = _addressStates.find(address);
   if (it == _addressStates.end())
   {
@@ -399,7 +636,9 @@ void Server::OnThrottleDisconnect(const asio::ip::address_v4& address) noexcept
 
 void Server::AcceptLoop() noexcept
 {
+  // Each accepted socket gets its own strand.
   _acceptor.async_accept(
+    asio::make_strand(_io_ctx),
     [&](const boost::system::error_code& error, asio::ip::tcp::socket client_socket)
     {
       try
@@ -433,20 +672,27 @@ void Server::AcceptLoop() noexcept
           return;
         }
 
-        // Sequential Id.
-        const ClientId clientId = _client_id++;
-
-        // Create the client.
-        const auto [itr, emplaced] = _clients.try_emplace(
-          clientId,
-          std::make_shared<Client>(clientId,
-            std::move(client_socket),
-            *this));
-
-        // Id is sequential so emplacement should never fail.
-        assert(emplaced);
+        std::shared_ptr<Client> client;
+        {
+          std::scoped_lock lock(_clientsMutex);
+
+          // Sequential Id.
+          const ClientId clientId = _client_id++;
+
+          // Create the client.
+          const auto [itr, emplaced] = _clients.try_emplace(
+            clientId,
+            std::make_shared<Client>(clientId,
+              std::move(client_socket),
+              *this,
+              _writeQueueLimits));
+
+          // Id is sequential so emplacement should never fail.
+          assert(emplaced);
+          client = itr->second;
+        }
 
-        itr->second->Begin();
+        client->Begin();
 
         // Continue the accept loop.
         AcceptLoop();
@@ -464,14 +710,16 @@ void Server::TickLoop() noexcept
 {
   _networkEventHandler.HandleNetworkTick();
 
-  _timer.expires_after(std::chrono::seconds(1));
-  _timer.async_wait([this](const boost::system::error_code& error)
+  _timer.expires_after(_tickInterval);
+  _timer.async_wait(asio::bind_executor(
+    _eventStrand,
+    [this](const boost::system::error_code& error)
     {
       if (error)
         return;
 
       TickLoop();
-    });
+    }));
 }
 
 } // namespace server::network
@@ -0,0 +1,215 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/network/TrafficCapture.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <limits>
+
+#include <spdlog/spdlog.h>
+
+namespace server::network
+{
+
+namespace
+{
+
+//! Magic the capture files begin with.
+constexpr std::array CaptureMagic{'A', 'C', 'A', 'P'};
+//! Version of the capture file format.
+constexpr uint16_t CaptureVersion = 2;
+
+template <typename T>
+void WriteValue(std::ostream& stream, const T& value)
+{
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool ReadValue(std::istream& stream, T& value)
+{
+  return static_cast<bool>(
+    stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+} // anon namespace
+
+void TrafficRecorder::Start(
+  const std::filesystem::path& path,
+  const TrafficProtocol protocol,
+  const std::string& source)
+{
+  std::scoped_lock lock(_mutex);
+
+  if (_file.is_open())
+    _file.close();
+
+  _file.open(path, std::ios::binary | std::ios::trunc);
+  if (not _file.is_open())
+  {
+    throw std::runtime_error(
+      std::format("Couldn't open traffic capture file '{}'", path.string()));
+  }
+
+  const auto startTime = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::system_clock::now().time_since_epoch());
+  const auto sourceLength = static_cast<uint8_t>(
+    std::min<std::size_t>(source.size(), std::numeric_limits<uint8_t>::max()));
+
+  _file.write(CaptureMagic.data(), CaptureMagic.size());
+  WriteValue(_file, CaptureVersion);
+  WriteValue(_file, protocol);
+  WriteValue(_file, sourceLength);
+  _file.write(source.data(), sourceLength);
+  WriteValue(_file, static_cast<uint64_t>(startTime.count()));
+
+  _startTimePoint = std::chrono::steady_clock::now();
+  _isRecording.store(true, std::memory_order::relaxed);
+
+  spdlog::info("Started capturing '{}' traffic to '{}'", source, path.string());
+}
+
+void TrafficRecorder::Stop()
+{
+  std::scoped_lock lock(_mutex);
+
+  if (not _isRecording.exchange(false, std::memory_order::relaxed))
+    return;
+
+  _file.close();
+  spdlog::info("Stopped capturing traffic");
+}
+
+void TrafficRecorder::Record(
+  const ClientId clientId,
+  const uint16_t commandId,
+  const std::span<const std::byte> payload) noexcept
+{
+  WriteRecord(clientId, TrafficRecordKind::Command, commandId, payload);
+}
+
+void TrafficRecorder::RecordConnect(const ClientId clientId) noexcept
+{
+  WriteRecord(clientId, TrafficRecordKind::Connect, 0, {});
+}
+
+void TrafficRecorder::RecordDisconnect(const ClientId clientId) noexcept
+{
+  WriteRecord(clientId, TrafficRecordKind::Disconnect, 0, {});
+}
+
+void TrafficRecorder::WriteRecord(
+  const ClientId clientId,
+  const TrafficRecordKind kind,
+  const uint16_t commandId,
+  const std::span<const std::byte> payload) noexcept
+{
+  if (not IsRecording())
+    return;
+
+  std::scoped_lock lock(_mutex);
+
+  // The recording might have been stopped in the meantime.
+  if (not _file.is_open())
+    return;
+
+  const auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - _startTimePoint);
+
+  WriteValue(_file, static_cast<uint64_t>(timestamp.count()));
+  WriteValue(_file, static_cast<uint64_t>(clientId));
+  WriteValue(_file, kind);
+  WriteValue(_file, commandId);
+  WriteValue(_file, static_cast<uint32_t>(payload.size()));
+  _file.write(
+    reinterpret_cast<const char*>(payload.data()),
+    static_cast<std::streamsize>(payload.size()));
+}
+
+TrafficCaptureReader::TrafficCaptureReader(const std::filesystem::path& path)
+  : _file(path, std::ios::binary)
+{
+  if (not _file.is_open())
+  {
+    throw std::runtime_error(
+      std::format("Couldn't open traffic capture file '{}'", path.string()));
+  }
+
+  std::array<char, CaptureMagic.size()> magic{};
+  uint16_t version{};
+  uint8_t sourceLength{};
+
+  if (not _file.read(magic.data(), magic.size())
+    || magic != CaptureMagic
+    || not ReadValue(_file, version)
+    || version != CaptureVersion)
+  {
+    throw std::runtime_error(
+      std::format("File '{}' is not a supported traffic capture", path.string()));
+  }
+
+  ReadValue(_file, _header.protocol);
+  ReadValue(_file, sourceLength);
+  _header.source.resize(sourceLength);
+  _file.read(_header.source.data(), sourceLength);
+
+  if (not ReadValue(_file, _header.startTime))
+  {
+    throw std::runtime_error(
+      std::format("Traffic capture '{}' has a truncated header", path.string()));
+  }
+}
+
+const TrafficCaptureHeader& TrafficCaptureReader::GetHeader() const noexcept
+{
+  return _header;
+}
+
+std::optional<TrafficRecord> TrafficCaptureReader::Next()
+{
+  TrafficRecord record;
+  uint64_t clientId{};
+  uint32_t payloadSize{};
+
+  if (not ReadValue(_file, record.timestamp))
+    return std::nullopt;
+
+  if (not ReadValue(_file, clientId)
+    || not ReadValue(_file, record.kind)
+    || not ReadValue(_file, record.commandId)
+    || not ReadValue(_file, payloadSize))
+  {
+    throw std::runtime_error("Traffic capture has a truncated record");
+  }
+
+  record.clientId = static_cast<ClientId>(clientId);
+  record.payload.resize(payloadSize);
+  if (not _file.read(
+    reinterpret_cast<char*>(record.payload.data()),
+    static_cast<std::streamsize>(payloadSize)))
+  {
+    throw std::runtime_error("Traffic capture has a truncated record payload");
+  }
+
+  return record;
+}
+
+} // namespace server::network
@@ -0,0 +1,557 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/network/UdpRelay.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+#include <mutex>
+
+#include <spdlog/spdlog.h>
+
+#if defined(__linux__)
+  #include <sys/socket.h>
+  #define UDP_RELAY_MMSG
+#endif
+
+namespace server::network
+{
+
+namespace
+{
+
+//! Max size of a relayed datagram.
+constexpr std::size_t MaxDatagramSize = 2048;
+//! Max count of the datagrams received in a batch.
+constexpr std::size_t BatchSize = 32;
+//! Timeout of a receive, after which the relay checks whether it should run.
+constexpr auto ReceiveTimeout = std::chrono::milliseconds(100);
+
+#if defined(_WIN32)
+using SocketLength = int;
+#else
+using SocketLength = socklen_t;
+#endif
+
+void SetReceiveTimeout(asio::ip::udp::socket& socket)
+{
+#if defined(_WIN32)
+  const DWORD timeout = static_cast<DWORD>(ReceiveTimeout.count());
+#else
+  const timeval timeout{
+    .tv_sec = 0,
+    .tv_usec = static_cast<suseconds_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(ReceiveTimeout).count())};
+#endif
+
+  const int result = ::setsockopt(
+    socket.native_handle(),
+    SOL_SOCKET,
+    SO_RCVTIMEO,
+    reinterpret_cast<const char*>(&timeout),
+    sizeof(timeout));
+  if (result != 0)
+    throw std::runtime_error("Failed to set the receive timeout of the UDP relay socket");
+}
+
+} // anon namespace
+
+std::optional<RelayDatagramHeader> RelayDatagramHeader::Read(
+  const std::span<const std::byte> datagram) noexcept
+{
+  if (datagram.size() < Size)
+    return std::nullopt;
+
+  const auto readU16 = [&datagram](const std::size_t offset)
+  {
+    return static_cast<uint16_t>(
+      std::to_integer<uint16_t>(datagram[offset])
+      | std::to_integer<uint16_t>(datagram[offset + 1]) << 8);
+  };
+
+  return RelayDatagramHeader{
+    .source = readU16(0),
+    .target = readU16(2)};
+}
+
+std::optional<RelaySessionToken> RelayDatagramHeader::ReadToken(
+  const std::span<const std::byte> datagram) noexcept
+{
+  if (datagram.size() < Size + sizeof(RelaySessionToken))
+    return std::nullopt;
+
+  RelaySessionToken token{};
+  for (std::size_t idx = 0; idx < sizeof(RelaySessionToken); ++idx)
+    token |= std::to_integer<RelaySessionToken>(datagram[Size + idx]) << (idx * 8);
+  return token;
+}
+
+bool UdpRelayTable::RegisterSession(
+  const RelaySessionId sessionId,
+  const RelayRoomId roomId,
+  const asio::ip::address_v4& address,
+  const RelaySessionToken token)
+{
+  if (sessionId == RelayDatagramHeader::BroadcastSession)
+    return false;
+
+  std::unique_lock lock(_mutex);
+
+  const auto [sessionIter, inserted] = _sessions.try_emplace(sessionId);
+  auto& session = sessionIter->second;
+  if (not inserted)
+    EraseRoomMember(sessionId, session.roomId);
+
+  session = Session{
+    .roomId = roomId,
+    .address = address,
+    .token = token,
+    .endpoint = std::nullopt};
+  _rooms[roomId].emplace_back(sessionId);
+
+  return true;
+}
+
+void UdpRelayTable::UnregisterSession(const RelaySessionId sessionId)
+{
+  std::unique_lock lock(_mutex);
+
+  const auto sessionIter = _sessions.find(sessionId);
+  if (sessionIter == _sessions.cend())
+    return;
+
+  EraseRoomMember(sessionId, sessionIter->second.roomId);
+  _sessions.erase(sessionIter);
+}
+
+void UdpRelayTable::UnregisterRoom(const RelayRoomId roomId)
+{
+  std::unique_lock lock(_mutex);
+
+  const auto roomIter = _rooms.find(roomId);
+  if (roomIter == _rooms.cend())
+    return;
+
+  for (const RelaySessionId sessionId : roomIter->second)
+    _sessions.erase(sessionId);
+  _rooms.erase(roomIter);
+}
+
+bool UdpRelayTable::Route(
+  const asio::ip::udp::endpoint& sender,
+  const RelayDatagramHeader& header,
+  const std::optional<RelaySessionToken> token,
+  std::vector<asio::ip::udp::endpoint>& recipients)
+{
+  // Most of the datagrams are sent by the bound sessions,
+  // which are routed under the shared lock.
+  {
+    std::shared_lock lock(_mutex);
+
+    const auto sessionIter = _sessions.find(header.source);
+    if (sessionIter == _sessions.cend())
+      return false;
+
+    const auto& session = sessionIter->second;
+    if (session.endpoint == sender)
+      return CollectRecipients(session, header, recipients);
+  }
+
+  // Bind the session to the sender, if it is sent from the address
+  // of the session and presents the token of the session.
+  if (not token)
+    return false;
+
+  std::unique_lock lock(_mutex);
+
+  const auto sessionIter = _sessions.find(header.source);
+  if (sessionIter == _sessions.cend())
+    return false;
+
+  auto& session = sessionIter->second;
+  if (not sender.address().is_v4())
+    return false;
+  if (not session.address.is_unspecified()
+    && session.address != sender.address().to_v4())
+  {
+    return false;
+  }
+
+  if (session.token != *token)
+    return false;
+
+  if (session.endpoint)
+  {
+    spdlog::debug(
+      "UDP relay session {} rebound from {}:{} to {}:{}",
+      header.source,
+      session.endpoint->address().to_string(),
+      session.endpoint->port(),
+      sender.address().to_string(),
+      sender.port());
+  }
+
+  session.endpoint = sender;
+
+  // The binding datagram is not forwarded.
+  return false;
+}
+
+std::size_t UdpRelayTable::GetSessionCount() const
+{
+  std::shared_lock lock(_mutex);
+  return _sessions.size();
+}
+
+void UdpRelayTable::EraseRoomMember(
+  const RelaySessionId sessionId,
+  const RelayRoomId roomId)
+{
+  const auto roomIter = _rooms.find(roomId);
+  if (roomIter == _rooms.cend())
+    return;
+
+  auto& members = roomIter->second;
+  std::erase(members, sessionId);
+  if (members.empty())
+    _rooms.erase(roomIter);
+}
+
+bool UdpRelayTable::CollectRecipients(
+  const Session& session,
+  const RelayDatagramHeader& header,
+  std::vector<asio::ip::udp::endpoint>& recipients) const
+{
+  const std::size_t previousCount = recipients.size();
+
+  if (header.target == RelayDatagramHeader::BroadcastSession)
+  {
+    const auto roomIter = _rooms.find(session.roomId);
+    if (roomIter == _rooms.cend())
+      return false;
+
+    for (const RelaySessionId memberId : roomIter->second)
+    {
+      if (memberId == header.source)
+        continue;
+
+      const auto& member = _sessions.at(memberId);
+      if (member.endpoint)
+        recipients.emplace_back(*member.endpoint);
+    }
+  }
+  else
+  {
+    // Datagrams are forwarded only within the room of the sender.
+    const auto targetIter = _sessions.find(header.target);
+    if (targetIter == _sessions.cend())
+      return false;
+
+    const auto& target = targetIter->second;
+    if (target.roomId != session.roomId || not target.endpoint)
+      return false;
+
+    recipients.emplace_back(*target.endpoint);
+  }
+
+  return recipients.size() > previousCount;
+}
+
+#if defined(UDP_RELAY_MMSG)
+
+struct UdpRelay::Batch
+{
+  //! Buffer of the received datagrams.
+  std::array<std::array<std::byte, MaxDatagramSize>, BatchSize> datagrams{};
+  std::array<sockaddr_storage, BatchSize> senders{};
+  std::array<iovec, BatchSize> receiveVectors{};
+  std::array<mmsghdr, BatchSize> receiveMessages{};
+
+  //! Recipients of the batch.
+  std::vector<asio::ip::udp::endpoint> recipients;
+  //! Index of the datagram of every recipient.
+  std::vector<std::size_t> recipientDatagrams;
+  std::vector<iovec> sendVectors;
+  std::vector<mmsghdr> sendMessages;
+};
+
+#else
+
+struct UdpRelay::Batch
+{
+  //! Buffer of the received datagram.
+  std::array<std::byte, MaxDatagramSize> datagram{};
+  //! Recipients of the datagram.
+  std::vector<asio::ip::udp::endpoint> recipients;
+};
+
+#endif
+
+UdpRelay::UdpRelay()
+  : _socket(_ioContext)
+  , _batch(std::make_unique<Batch>())
+{
+}
+
+UdpRelay::~UdpRelay()
+{
+  End();
+}
+
+void UdpRelay::Begin(const asio::ip::address_v4& address, const uint16_t port)
+{
+  if (_shouldRun.exchange(true))
+    return;
+
+  try
+  {
+    const asio::ip::udp::endpoint endpoint(address, port);
+    _socket.open(endpoint.protocol());
+    _socket.bind(endpoint);
+    SetReceiveTimeout(_socket);
+  }
+  catch (const std::exception& x)
+  {
+    _shouldRun = false;
+    if (_socket.is_open())
+      _socket.close();
+
+    throw std::runtime_error(std::format(
+      "Failed to bind the UDP relay to {}:{}: {}",
+      address.to_string(),
+      port,
+      x.what()));
+  }
+
+  _thread = std::thread([this]()
+  {
+    RelayLoop();
+  });
+}
+
+void UdpRelay::End()
+{
+  if (not _shouldRun.exchange(false))
+    return;
+
+  if (_thread.joinable())
+    _thread.join();
+
+  boost::system::error_code error;
+  _socket.close(error);
+}
+
+uint16_t UdpRelay::GetPort() const
+{
+  boost::system::error_code error;
+  return _socket.local_endpoint(error).port();
+}
+
+UdpRelayTable& UdpRelay::GetTable()
+{
+  return _table;
+}
+
+UdpRelayStats UdpRelay::GetStats() const
+{
+  return UdpRelayStats{
+    .received = _received.load(std::memory_order::relaxed),
+    .forwarded = _forwarded.load(std::memory_order::relaxed),
+    .dropped = _dropped.load(std::memory_order::relaxed)};
+}
+
+void UdpRelay::RelayLoop() noexcept
+{
+  while (_shouldRun.load(std::memory_order::acquire))
+  {
+    try
+    {
+      RelayBatch();
+    }
+    catch (const std::exception& x)
+    {
+      spdlog::error("Unhandled exception in the UDP relay: {}", x.what());
+    }
+  }
+}
+
+#if defined(UDP_RELAY_MMSG)
+
+void UdpRelay::RelayBatch()
+{
+  auto& batch = *_batch;
+  const int socket = _socket.native_handle();
+
+  for (std::size_t idx = 0; idx < BatchSize; ++idx)
+  {
+    batch.receiveVectors[idx] = iovec{
+      .iov_base = batch.datagrams[idx].data(),
+      .iov_len = MaxDatagramSize};
+
+    auto& header = batch.receiveMessages[idx].msg_hdr;
+    header = msghdr{};
+    header.msg_name = &batch.senders[idx];
+    header.msg_namelen = sizeof(sockaddr_storage);
+    header.msg_iov = &batch.receiveVectors[idx];
+    header.msg_iovlen = 1;
+  }
+
+  // Blocks until the first datagram or the timeout
+  // and then takes the datagrams which are already queued.
+  const int receivedCount = ::recvmmsg(
+    socket,
+    batch.receiveMessages.data(),
+    BatchSize,
+    MSG_WAITFORONE,
+    nullptr);
+  if (receivedCount <= 0)
+    return;
+
+  _received.fetch_add(receivedCount, std::memory_order::relaxed);
+
+  batch.recipients.clear();
+  batch.recipientDatagrams.clear();
+
+  uint64_t droppedCount = 0;
+  for (std::size_t idx = 0; idx < static_cast<std::size_t>(receivedCount); ++idx)
+  {
+    const auto& message = batch.receiveMessages[idx];
+    const std::span<const std::byte> datagram(
+      batch.datagrams[idx].data(),
+      message.msg_len);
+
+    const auto header = RelayDatagramHeader::Read(datagram);
+    if (not header || (message.msg_hdr.msg_flags & MSG_TRUNC) != 0)
+    {
+      ++droppedCount;
+      continue;
+    }
+
+    asio::ip::udp::endpoint sender;
+    std::memcpy(sender.data(), &batch.senders[idx], message.msg_hdr.msg_namelen);
+    sender.resize(message.msg_hdr.msg_namelen);
+
+    if (not _table.Route(sender, *header, RelayDatagramHeader::ReadToken(datagram), batch.recipients))
+    {
+      ++droppedCount;
+      continue;
+    }
+
+    batch.recipientDatagrams.resize(batch.recipients.size(), idx);
+  }
+
+  _dropped.fetch_add(droppedCount, std::memory_order::relaxed);
+
+  const std::size_t sendCount = batch.recipients.size();
+  if (sendCount == 0)
+    return;
+
+  batch.sendVectors.resize(sendCount);
+  batch.sendMessages.resize(sendCount);
+  for (std::size_t idx = 0; idx < sendCount; ++idx)
+  {
+    const std::size_t datagramIdx = batch.recipientDatagrams[idx];
+    batch.sendVectors[idx] = iovec{
+      .iov_base = batch.datagrams[datagramIdx].data(),
+      .iov_len = batch.receiveMessages[datagramIdx].msg_len};
+
+    auto& recipient = batch.recipients[idx];
+    auto& header = batch.sendMessages[idx].msg_hdr;
+    header = msghdr{};
+    header.msg_name = recipient.data();
+    header.msg_namelen = static_cast<socklen_t>(recipient.size());
+    header.msg_iov = &batch.sendVectors[idx];
+    header.msg_iovlen = 1;
+  }
+
+  std::size_t sentCount = 0;
+  while (sentCount < sendCount)
+  {
+    const int result = ::sendmmsg(
+      socket,
+      batch.sendMessages.data() + sentCount,
+      sendCount - sentCount,
+      0);
+
+    // Skip the datagram which failed to send, the relay is best effort.
+    if (result <= 0)
+    {
+      ++sentCount;
+      continue;
+    }
+
+    sentCount += result;
+    _forwarded.fetch_add(result, std::memory_order::relaxed);
+  }
+}
+
+#else
+
+void UdpRelay::RelayBatch()
+{
+  auto& batch = *_batch;
+
+  asio::ip::udp::endpoint sender;
+  SocketLength senderSize = static_cast<SocketLength>(sender.capacity());
+
+  const auto receivedSize = ::recvfrom(
+    _socket.native_handle(),
+    reinterpret_cast<char*>(batch.datagram.data()),
+    static_cast<int>(batch.datagram.size()),
+    0,
+    sender.data(),
+    &senderSize);
+  if (receivedSize < 0)
+    return;
+
+  sender.resize(senderSize);
+  _received.fetch_add(1, std::memory_order::relaxed);
+
+  const std::span<const std::byte> datagram(
+    batch.datagram.data(),
+    static_cast<std::size_t>(receivedSize));
+
+  batch.recipients.clear();
+  const auto header = RelayDatagramHeader::Read(datagram);
+  if (not header
+    || not _table.Route(sender, *header, RelayDatagramHeader::ReadToken(datagram), batch.recipients))
+  {
+    _dropped.fetch_add(1, std::memory_order::relaxed);
+    return;
+  }
+
+  for (const auto& recipient : batch.recipients)
+  {
+    const auto result = ::sendto(
+      _socket.native_handle(),
+      reinterpret_cast<const char*>(datagram.data()),
+      static_cast<int>(datagram.size()),
+      0,
+      recipient.data(),
+      static_cast<SocketLength>(recipient.size()));
+    if (result >= 0)
+      _forwarded.fetch_add(1, std::memory_order::relaxed);
+  }
+}
+
+#endif
+
+} // namespace server::network
@@ -0,0 +1,221 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/network/XorCodec.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define XOR_CODEC_X86_64
+  #include <immintrin.h>
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #endif
+#endif
+
+#if defined(_MSC_VER)
+  #define XOR_CODEC_TARGET_AVX2
+#else
+  #define XOR_CODEC_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace server::network
+{
+
+namespace
+{
+
+//! XORs the bytes from the specified index to the end of the data.
+//! The index must be a multiple of the key size.
+void XorBytes(
+  std::span<std::byte> data,
+  const XorKey& key,
+  std::size_t idx) noexcept
+{
+  for (; idx < data.size(); ++idx)
+  {
+    data[idx] ^= key[idx % 4];
+  }
+}
+
+void XorScalar64(
+  std::span<std::byte> data,
+  const XorKey& key) noexcept
+{
+  // The key repeated to the size of the word.
+  std::array<std::byte, sizeof(uint64_t)> wideKey{};
+  std::memcpy(wideKey.data(), key.data(), key.size());
+  std::memcpy(wideKey.data() + key.size(), key.data(), key.size());
+
+  uint64_t keyWord;
+  std::memcpy(&keyWord, wideKey.data(), sizeof(keyWord));
+
+  std::size_t idx = 0;
+  for (; idx + sizeof(uint64_t) <= data.size(); idx += sizeof(uint64_t))
+  {
+    uint64_t word;
+    std::memcpy(&word, data.data() + idx, sizeof(word));
+    word ^= keyWord;
+    std::memcpy(data.data() + idx, &word, sizeof(word));
+  }
+
+  XorBytes(data, key, idx);
+}
+
+#ifdef XOR_CODEC_X86_64
+
+void XorSse2(
+  std::span<std::byte> data,
+  const XorKey& key) noexcept
+{
+  int32_t keyValue;
+  std::memcpy(&keyValue, key.data(), sizeof(keyValue));
+  const __m128i keyVector = _mm_set1_epi32(keyValue);
+
+  std::size_t idx = 0;
+  for (; idx + sizeof(__m128i) <= data.size(); idx += sizeof(__m128i))
+  {
+    const auto address = reinterpret_cast<__m128i*>(data.data() + idx);
+    _mm_storeu_si128(
+      address,
+      _mm_xor_si128(_mm_loadu_si128(address), keyVector));
+  }
+
+  XorBytes(data, key, idx);
+}
+
+XOR_CODEC_TARGET_AVX2 void XorAvx2(
+  std::span<std::byte> data,
+  const XorKey& key) noexcept
+{
+  int32_t keyValue;
+  std::memcpy(&keyValue, key.data(), sizeof(keyValue));
+  const __m256i keyVector = _mm256_set1_epi32(keyValue);
+
+  std::size_t idx = 0;
+  for (; idx + sizeof(__m256i) <= data.size(); idx += sizeof(__m256i))
+  {
+    const auto address = reinterpret_cast<__m256i*>(data.data() + idx);
+    _mm256_storeu_si256(
+      address,
+      _mm256_xor_si256(_mm256_loadu_si256(address), keyVector));
+  }
+
+  XorBytes(data, key, idx);
+}
+
+bool IsAvx2Supported() noexcept
+{
+#if defined(_MSC_VER)
+  std::array<int, 4> cpuInfo{};
+  __cpuid(cpuInfo.data(), 0);
+  if (cpuInfo[0] < 7)
+    return false;
+
+  // OSXSAVE and AVX, and the OS saving the YMM registers.
+  __cpuid(cpuInfo.data(), 1);
+  constexpr int OsXSaveAndAvx = (1 << 27) | (1 << 28);
+  if ((cpuInfo[2] & OsXSaveAndAvx) != OsXSaveAndAvx)
+    return false;
+  if ((_xgetbv(0) & 0x6) != 0x6)
+    return false;
+
+  __cpuidex(cpuInfo.data(), 7, 0);
+  return (cpuInfo[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+} // anon namespace
+
+bool IsXorKernelSupported(const XorKernel kernel) noexcept
+{
+  switch (kernel)
+  {
+    case XorKernel::Byte:
+    case XorKernel::Scalar64:
+      return true;
+#ifdef XOR_CODEC_X86_64
+    case XorKernel::Sse2:
+      // SSE2 is a part of the x86-64 baseline.
+      return true;
+    case XorKernel::Avx2:
+    {
+      static const bool isSupported = IsAvx2Supported();
+      return isSupported;
+    }
+#endif
+    default:
+      return false;
+  }
+}
+
+XorKernel GetBestXorKernel() noexcept
+{
+  static const XorKernel bestKernel = []()
+  {
+    for (const auto kernel : {XorKernel::Avx2, XorKernel::Sse2})
+    {
+      if (IsXorKernelSupported(kernel))
+        return kernel;
+    }
+
+    return XorKernel::Scalar64;
+  }();
+
+  return bestKernel;
+}
+
+void XorInPlace(
+  std::span<std::byte> data,
+  const XorKey& key) noexcept
+{
+  XorInPlace(data, key, GetBestXorKernel());
+}
+
+void XorInPlace(
+  std::span<std::byte> data,
+  const XorKey& key,
+  const XorKernel kernel) noexcept
+{
+  switch (kernel)
+  {
+#ifdef XOR_CODEC_X86_64
+    case XorKernel::Avx2:
+      XorAvx2(data, key);
+      break;
+    case XorKernel::Sse2:
+      XorSse2(data, key);
+      break;
+#endif
+    case XorKernel::Scalar64:
+      XorScalar64(data, key);
+      break;
+    case XorKernel::Byte:
+    default:
+      XorBytes(data, key, 0);
+      break;
+  }
+}
+
+} // namespace server::network
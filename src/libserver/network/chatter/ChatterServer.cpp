@@ -18,10 +18,11 @@
  **/
 
 #include "libserver/network/chatter/ChatterServer.hpp"
+#include "libserver/network/XorCodec.hpp"
 #include "libserver/util/Deferred.hpp"
 #include "libserver/util/Stream.hpp"
-#include "libserver/util/Util.hpp"
 
+#include <cstring>
 #include <stacktrace>
 
 #include <spdlog/spdlog.h>
@@ -33,16 +34,66 @@ namespace
 {
 
 // The base XOR scrambling constant, which seems to not roll.
-constexpr std::array XorCode{
+constexpr network::XorKey XorCode{
   static_cast<std::byte>(0x2B),
   static_cast<std::byte>(0xFE),
   static_cast<std::byte>(0xB8),
   static_cast<std::byte>(0x02)};
 
-// todo: de/serializer map, handler map
-
 } // anon namespace
 
+network::FrameHeader ChatterFraming::ReadHeader(
+  const std::span<const std::byte> header)
+{
+  protocol::ChatterCommandHeader commandHeader{};
+  std::memcpy(&commandHeader.length, header.data(), sizeof(commandHeader.length));
+  std::memcpy(
+    &commandHeader.commandId,
+    header.data() + sizeof(commandHeader.length),
+    sizeof(commandHeader.commandId));
+
+  // Decrypt the header.
+  commandHeader.length ^= *reinterpret_cast<const uint16_t*>(XorCode.data());
+  commandHeader.commandId ^= *reinterpret_cast<const uint16_t*>(XorCode.data() + 2);
+
+  return {
+    .commandId = commandHeader.commandId,
+    .frameSize = commandHeader.length};
+}
+
+void ChatterFraming::WriteHeader(
+  const std::span<std::byte> header,
+  const network::FrameHeader& frameHeader)
+{
+  const protocol::ChatterCommandHeader commandHeader{
+    .length = static_cast<uint16_t>(frameHeader.frameSize),
+    .commandId = frameHeader.commandId};
+
+  SinkStream(header).Write(commandHeader.length)
+    .Write(commandHeader.commandId);
+}
+
+std::span<std::byte> ChatterFraming::DecodeData(
+  ClientState&,
+  uint16_t,
+  const std::span<std::byte> data)
+{
+  // XOR key index is relative to packet payload (idx % 4).
+  network::XorInPlace(data, XorCode);
+  return data;
+}
+
+void ChatterFraming::EncodeFrame(const std::span<std::byte> frame)
+{
+  // The header is scrambled together with the command data.
+  network::XorInPlace(frame, XorCode);
+}
+
+std::string_view ChatterFraming::GetCommandName(const uint16_t commandId)
+{
+  return GetChatterCommandName(static_cast<protocol::ChatterCommand>(commandId));
+}
+
 ChatterServer::ChatterServer(
   IChatterServerEventsHandler& chatterServerEventsHandler)
   : _chatterServerEventsHandler(chatterServerEventsHandler)
@@ -57,13 +108,16 @@ ChatterServer::~ChatterServer()
     _serverThread.join();
 }
 
-void ChatterServer::BeginHost(network::asio::ip::address_v4 address, uint16_t port)
+void ChatterServer::BeginHost(
+  network::asio::ip::address_v4 address,
+  uint16_t port,
+  uint32_t ioThreadCount)
 {
-  _serverThread = std::thread([this, address, port]()
+  _serverThread = std::thread([this, address, port, ioThreadCount]()
   {
     try
     {
-      _server.Begin(address, port);
+      _server.Begin(address, port, ioThreadCount);
     }
     catch (const std::exception& x)
     {
@@ -94,130 +148,103 @@ void ChatterServer::HandleNetworkTick()
 
 void ChatterServer::OnClientConnected(network::ClientId clientId)
 {
+  _transport.GetTrafficRecorder().RecordConnect(clientId);
   _chatterServerEventsHandler.HandleClientConnected(clientId);
 }
 
 void ChatterServer::OnClientDisconnected(network::ClientId clientId)
 {
+  _transport.GetTrafficRecorder().RecordDisconnect(clientId);
   _chatterServerEventsHandler.HandleClientDisconnected(clientId);
 }
 
 size_t ChatterServer::OnClientData(
   network::ClientId clientId,
-  const std::span<const std::byte>& data)
+  const std::span<std::byte>& data)
 {
-  SourceStream commandStream{data};
+  ChatterFraming::ClientState state;
 
-  while (commandStream.GetCursor() != commandStream.Size())
+  // The commands decoded before a malformed frame are dispatched too.
+  network::DecodedCommands decoded;
+  const Deferred dispatchDecoded([this, clientId, &decoded]()
   {
-    const auto bufferedDataSize = commandStream.Size() - commandStream.GetCursor();
+    if (decoded.commands.empty())
+      return;
 
-    // If there's not enough buffered data to read the header,
-    // break out of the loop.
-    if (bufferedDataSize < sizeof(protocol::ChatterCommandHeader))
-      break;
-
-    const auto streamOrigin = commandStream.GetCursor();
-    bool isCommandBufferedWhole = true;
-
-    const Deferred deferredResetCommandStreamCursor(
-      [streamOrigin, &commandStream, &isCommandBufferedWhole]()
+    _server.PostEvent(
+      [this, clientId, decoded = std::move(decoded)]()
       {
-        // If the command was not buffered whole,
-        // reset the stream to the cursor before the command was read,
-        // so that it may be read when more data arrive.
-        if (not isCommandBufferedWhole)
-          commandStream.Seek(streamOrigin);
+        _transport.Dispatch(clientId, decoded);
       });
+  });
 
-    // Read the header.
-    protocol::ChatterCommandHeader header{};
-    commandStream.Read(header.length)
-      .Read(header.commandId);
-
-    // Decrypt the header.
-    header.length ^= *reinterpret_cast<const uint16_t*>(XorCode.data());
-    header.commandId ^= *reinterpret_cast<const uint16_t*>(XorCode.data() + 2);
+  return _transport.ReadFrames(state, data, decoded);
+}
 
-    // If the length of the command is not at least the size of the header
-    // or is more than 4KB, throw an exception to terminate corrupted connection.
-    if (header.length < sizeof(protocol::ChatterCommandHeader) || header.length > 4092)
-    {
-      throw std::runtime_error(
-        std::format("Invalid chatter header: Bad command data size '{}'", header.length));
-    }
+network::TrafficRecorder& ChatterServer::GetTrafficRecorder() noexcept
+{
+  return _transport.GetTrafficRecorder();
+}
 
-    // If there's not enough data to read the full command payload,
-    // wait for more data to arrive.
-    if (bufferedDataSize < header.length)
-    {
-      isCommandBufferedWhole = false;
-      break;
-    }
+void ChatterServer::ReplayClientConnected(network::ClientId clientId)
+{
+  _chatterServerEventsHandler.HandleClientConnected(clientId);
+}
 
-    const size_t commandDataLength = header.length - sizeof(protocol::ChatterCommandHeader);
-    std::vector<std::byte> commandData(commandDataLength);
+void ChatterServer::ReplayClientDisconnected(network::ClientId clientId)
+{
+  _chatterServerEventsHandler.HandleClientDisconnected(clientId);
+}
 
-    // Read the command data from the command stream.
-    // XOR key index is relative to packet payload (idx % 4).
-    for (size_t idx = 0; idx < commandDataLength; ++idx)
-    {
-      std::byte& val = commandData[idx];
-      commandStream.Read(val);
-      val ^= XorCode[idx % 4];
-    }
+void ChatterServer::ReplayCommand(
+  network::ClientId clientId,
+  uint16_t commandId,
+  std::span<const std::byte> commandData)
+{
+  SourceStream commandDataSource(commandData);
+  _transport.Dispatch(clientId, commandId, commandDataSource);
+}
 
-    SourceStream commandDataSource({commandData.begin(), commandData.end()});
+void ChatterServer::SendCommand(
+  network::ClientId clientId,
+  uint16_t commandId,
+  const std::function<void(SinkStream&)>& writer,
+  const std::optional<std::size_t> commandDataSize)
+{
+  std::shared_ptr<network::Client> client;
+  try
+  {
+    client = _server.GetClient(clientId);
+  }
+  catch (const std::exception&)
+  {
+    // The client disconnected, or it is a replayed client.
+    return;
+  }
 
-    if (debugIncomingCommandData)
-    {
-      spdlog::debug("Read data for command '{}' (0x{:X}),\n\n"
-        "Command data size: {} \n"
-        "Data dump: \n\n{}\n",
-        GetChatterCommandName(static_cast<protocol::ChatterCommand>(header.commandId)),
-        header.commandId,
-        commandDataLength,
-        util::GenerateByteDump({commandData.data(), commandData.size()}));
-    }
+  network::WriteBuffer writeBuffer;
+  try
+  {
+    writeBuffer = _transport.EncodeFrame(commandId, writer, commandDataSize);
+  }
+  catch (const std::exception& x)
+  {
+    spdlog::error("Unhandled exception writing chatter command '{}' (0x{:X}) for client {}: {}",
+      GetChatterCommandName(static_cast<protocol::ChatterCommand>(commandId)),
+      commandId,
+      clientId,
+      x.what());
+    return;
+  }
 
-    // Find the handler of the command.
-    const auto handlerIter = _handlers.find(header.commandId);
-    if (handlerIter == _handlers.cend())
-    {
-      if (debugCommands)
-      {
-        spdlog::warn("Unhandled chatter command: {} ({:#x})", 
-          GetChatterCommandName(static_cast<protocol::ChatterCommand>(header.commandId)),
-          header.commandId);
-      }
-    }
-    else
-    {
-      const auto& handler = handlerIter->second;
-      try
-      {
-        handler(clientId, commandDataSource);
-        
-        if (debugCommands)
-        {
-          spdlog::debug("Handled chatter command: {} ({:#x})", 
-            GetChatterCommandName(static_cast<protocol::ChatterCommand>(header.commandId)),
-            header.commandId);
-        }
-      }
-      catch (const std::exception& ex)
-      {
-        spdlog::error("Unhandled exception handling chatter command {} ({:#x}): {}",
-          GetChatterCommandName(static_cast<protocol::ChatterCommand>(header.commandId)),
-          header.commandId,
-          ex.what());
-      }
+  client->QueueWrite(std::move(writeBuffer));
 
-      assert(commandDataSource.GetCursor() == commandDataSource.Size());
-    }
+  if (_transport.debugCommands)
+  {
+    spdlog::debug("Sent chatter command message '{}' (0x{:X})",
+      GetChatterCommandName(static_cast<protocol::ChatterCommand>(commandId)),
+      commandId);
   }
-
-  return commandStream.GetCursor();
 }
 
 network::asio::ip::address_v4 ChatterServer::GetClientAddress(
@@ -921,6 +921,14 @@ void server::protocol::ChatCmdChannelChatTrs::Write(
     .Write(command.role);
 }
 
+std::size_t server::protocol::ChatCmdChannelChatTrs::GetEncodedSize(
+  const ChatCmdChannelChatTrs& command)
+{
+  return server::GetEncodedSize(command.messageAuthor)
+    + server::GetEncodedSize(command.message)
+    + sizeof(command.role);
+}
+
 void server::protocol::ChatCmdChannelChatTrs::Read(
   ChatCmdChannelChatTrs&,
   SourceStream&)
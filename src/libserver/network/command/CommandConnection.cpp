@@ -0,0 +1,296 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/network/command/CommandConnection.hpp"
+
+#include "libserver/network/XorCodec.hpp"
+
+#include <cstring>
+
+#include <spdlog/spdlog.h>
+
+namespace server
+{
+
+namespace
+{
+
+//! Max size of the command data.
+constexpr std::size_t MaxCommandDataSize = 8192;
+
+//! Max size of the whole command.
+constexpr std::size_t MaxCommandSize = MaxCommandDataSize + sizeof(protocol::MessageMagic);
+
+//! Size of a single read from the socket.
+constexpr std::size_t ReadChunkSize = 4096;
+
+} // anon namespace
+
+std::vector<std::byte> EncodeClientCommand(
+  const protocol::Command commandId,
+  const std::span<const std::byte> payload,
+  CommandClient& code)
+{
+  // The server rolls the code only for the commands with a payload.
+  std::size_t padding = 0;
+  if (not payload.empty())
+  {
+    code.RollCode();
+    padding = static_cast<uint32_t>(code.GetRollingCodeInt()) & 7;
+  }
+
+  const std::size_t commandSize = sizeof(protocol::MessageMagic) + payload.size() + padding;
+  if (commandSize > MaxCommandSize)
+    throw std::runtime_error("Command is over the size limit");
+
+  std::vector<std::byte> frame(commandSize);
+
+  const uint32_t magic = protocol::encode_message_magic({
+    .id = static_cast<uint16_t>(commandId),
+    .length = static_cast<uint16_t>(commandSize)});
+  std::memcpy(frame.data(), &magic, sizeof(magic));
+
+  if (not payload.empty())
+  {
+    std::memcpy(frame.data() + sizeof(magic), payload.data(), payload.size());
+
+    // The padding is scrambled together with the payload.
+    network::XorInPlace(
+      std::span(frame).subspan(sizeof(magic)),
+      code.GetRollingCode());
+  }
+
+  return frame;
+}
+
+CommandConnection::CommandConnection(asio::io_context& ioContext)
+  : _socket(ioContext)
+  , _strand(asio::make_strand(ioContext))
+{
+  _handlers.resize(protocol::CommandCount);
+}
+
+void CommandConnection::Connect(
+  const asio::ip::tcp::endpoint& endpoint,
+  ConnectHandler handler)
+{
+  _socket.async_connect(
+    endpoint,
+    asio::bind_executor(
+      _strand,
+      [self = shared_from_this(), handler = std::move(handler)](
+        const boost::system::error_code& error)
+      {
+        if (error)
+        {
+          handler(false);
+          return;
+        }
+
+        self->_socket.set_option(asio::ip::tcp::no_delay(true));
+        handler(true);
+        self->ReadLoop();
+      }));
+}
+
+void CommandConnection::Close()
+{
+  asio::dispatch(_strand, [self = shared_from_this()]()
+  {
+    self->_isClosed = true;
+
+    boost::system::error_code error;
+    self->_socket.shutdown(asio::ip::tcp::socket::shutdown_both, error);
+    self->_socket.close(error);
+  });
+}
+
+void CommandConnection::RegisterCommandHandler(
+  const protocol::Command commandId,
+  std::function<void(SourceStream& source)> handler)
+{
+  const auto handlerIndex = static_cast<std::size_t>(commandId);
+  if (handlerIndex >= _handlers.size())
+    throw std::runtime_error("Command ID is out of the range of the handler table");
+
+  _handlers[handlerIndex] = std::move(handler);
+}
+
+void CommandConnection::SetDisconnectHandler(DisconnectHandler handler)
+{
+  _disconnectHandler = std::move(handler);
+}
+
+void CommandConnection::ResetCode()
+{
+  _code.SetCode({});
+}
+
+asio::strand<asio::io_context::executor_type>& CommandConnection::GetStrand() noexcept
+{
+  return _strand;
+}
+
+void CommandConnection::SendCommand(
+  const protocol::Command commandId,
+  CommandWriter writer)
+{
+  asio::dispatch(
+    _strand,
+    [self = shared_from_this(), commandId, writer = std::move(writer)]()
+    {
+      if (self->_isClosed)
+        return;
+
+      std::array<std::byte, MaxCommandDataSize> payloadBuffer;
+      SinkStream payloadSink(payloadBuffer);
+      writer(payloadSink);
+
+      // The code must be rolled in the order the commands are written.
+      self->_writeQueue.emplace_back(EncodeClientCommand(
+        commandId,
+        std::span(payloadBuffer).first(payloadSink.GetCursor()),
+        self->_code));
+
+      if (not self->_isWriting)
+        self->WriteLoop();
+    });
+}
+
+void CommandConnection::ReadLoop()
+{
+  if (_readBuffer.size() < _readBufferSize + ReadChunkSize)
+    _readBuffer.resize(_readBufferSize + ReadChunkSize);
+
+  _socket.async_read_some(
+    asio::buffer(_readBuffer.data() + _readBufferSize, ReadChunkSize),
+    asio::bind_executor(
+      _strand,
+      [self = shared_from_this()](
+        const boost::system::error_code& error,
+        const std::size_t bytesRead)
+      {
+        if (error)
+        {
+          self->HandleDisconnect();
+          return;
+        }
+
+        self->_readBufferSize += bytesRead;
+
+        try
+        {
+          self->ProcessReadBuffer();
+        }
+        catch (const std::exception& x)
+        {
+          spdlog::warn("Failed to process the commands of the server: {}", x.what());
+          self->HandleDisconnect();
+          return;
+        }
+
+        self->ReadLoop();
+      }));
+}
+
+void CommandConnection::ProcessReadBuffer()
+{
+  std::size_t cursor = 0;
+  while (_readBufferSize - cursor >= sizeof(protocol::MessageMagic))
+  {
+    uint32_t magicValue{};
+    std::memcpy(&magicValue, _readBuffer.data() + cursor, sizeof(magicValue));
+
+    const auto magic = protocol::decode_message_magic(magicValue);
+    if (magic.length < sizeof(protocol::MessageMagic) || magic.length > MaxCommandSize)
+    {
+      throw std::runtime_error(
+        std::format("Invalid command magic: Bad command data size '{}'", magic.length));
+    }
+
+    // Wait for the rest of the command.
+    if (_readBufferSize - cursor < magic.length)
+      break;
+
+    // The commands sent by the server are not scrambled.
+    const auto commandData = std::span(_readBuffer).subspan(
+      cursor + sizeof(protocol::MessageMagic),
+      magic.length - sizeof(protocol::MessageMagic));
+    cursor += magic.length;
+
+    if (magic.id >= _handlers.size() || not _handlers[magic.id])
+      continue;
+
+    SourceStream commandStream(commandData);
+    _handlers[magic.id](commandStream);
+
+    // The handler might have closed the connection.
+    if (_isClosed)
+      return;
+  }
+
+  // Move the partially received command to the beginning of the buffer.
+  std::memmove(_readBuffer.data(), _readBuffer.data() + cursor, _readBufferSize - cursor);
+  _readBufferSize -= cursor;
+}
+
+void CommandConnection::WriteLoop()
+{
+  if (_writeQueue.empty() || _isClosed)
+  {
+    _isWriting = false;
+    return;
+  }
+
+  _isWriting = true;
+  asio::async_write(
+    _socket,
+    asio::buffer(_writeQueue.front()),
+    asio::bind_executor(
+      _strand,
+      [self = shared_from_this()](
+        const boost::system::error_code& error,
+        std::size_t)
+      {
+        if (error)
+        {
+          self->_isWriting = false;
+          self->HandleDisconnect();
+          return;
+        }
+
+        self->_writeQueue.pop_front();
+        self->WriteLoop();
+      }));
+}
+
+void CommandConnection::HandleDisconnect()
+{
+  if (_isClosed)
+    return;
+
+  _isClosed = true;
+  boost::system::error_code error;
+  _socket.close(error);
+
+  if (_disconnectHandler)
+    _disconnectHandler();
+}
+
+} // namespace server
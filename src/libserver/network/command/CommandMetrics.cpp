@@ -0,0 +1,186 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/network/command/CommandMetrics.hpp"
+
+#include <algorithm>
+#include <format>
+#include <new>
+
+namespace server
+{
+
+namespace
+{
+
+//! Returns the duration in microseconds.
+uint64_t ToMicroseconds(const LatencyHistogram::Duration duration)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+} // anon namespace
+
+CommandMetrics::CommandMetrics()
+  : _metrics(std::make_unique<std::atomic<Metrics*>[]>(protocol::CommandCount))
+{
+}
+
+CommandMetrics::~CommandMetrics()
+{
+  for (std::size_t idx = 0; idx < protocol::CommandCount; ++idx)
+  {
+    delete _metrics[idx].load(std::memory_order::acquire);
+  }
+}
+
+void CommandMetrics::Record(
+  const protocol::Command command,
+  const Stage stage,
+  const std::size_t bytes,
+  const LatencyHistogram::Duration duration) noexcept
+{
+  const auto commandIdx = static_cast<std::size_t>(command);
+  if (commandIdx >= protocol::CommandCount)
+    return;
+
+  auto& slot = _metrics[commandIdx];
+  Metrics* metrics = slot.load(std::memory_order::acquire);
+  if (metrics == nullptr)
+  {
+    // Publish the metrics of the command,
+    // if another thread published them first use those instead.
+    auto* allocatedMetrics = new(std::nothrow) Metrics();
+    if (allocatedMetrics == nullptr)
+      return;
+
+    if (slot.compare_exchange_strong(
+      metrics,
+      allocatedMetrics,
+      std::memory_order::acq_rel,
+      std::memory_order::acquire))
+    {
+      metrics = allocatedMetrics;
+    }
+    else
+    {
+      delete allocatedMetrics;
+    }
+  }
+
+  auto& stageMetrics = (*metrics)[static_cast<std::size_t>(stage)];
+  stageMetrics.bytes.fetch_add(bytes, std::memory_order::relaxed);
+  stageMetrics.latency.Record(duration);
+}
+
+std::vector<CommandMetrics::CommandSummary> CommandMetrics::Summarize() const
+{
+  std::vector<CommandSummary> summaries;
+
+  for (std::size_t commandIdx = 0; commandIdx < protocol::CommandCount; ++commandIdx)
+  {
+    const Metrics* metrics = _metrics[commandIdx].load(std::memory_order::acquire);
+    if (metrics == nullptr)
+      continue;
+
+    auto& summary = summaries.emplace_back(CommandSummary{
+      .command = static_cast<protocol::Command>(commandIdx)});
+
+    for (std::size_t stageIdx = 0; stageIdx < summary.stages.size(); ++stageIdx)
+    {
+      const auto& stageMetrics = (*metrics)[stageIdx];
+      summary.stages[stageIdx] = StageSummary{
+        .bytes = stageMetrics.bytes.load(std::memory_order::relaxed),
+        .latency = stageMetrics.latency.Summarize()};
+    }
+  }
+
+  const auto getTotalTime = [](const CommandSummary& summary)
+  {
+    LatencyHistogram::Duration total{};
+    for (const auto& stage : summary.stages)
+      total += stage.latency.total;
+    return total;
+  };
+
+  std::ranges::sort(
+    summaries,
+    [&getTotalTime](const CommandSummary& lhs, const CommandSummary& rhs)
+    {
+      return getTotalTime(lhs) > getTotalTime(rhs);
+    });
+
+  return summaries;
+}
+
+std::vector<std::string> CommandMetrics::Format(const std::size_t limit) const
+{
+  std::vector<std::string> lines;
+
+  for (const auto& summary : Summarize())
+  {
+    if (lines.size() >= limit)
+      break;
+
+    std::string line = std::string(protocol::GetCommandName(summary.command));
+
+    constexpr std::array<std::pair<Stage, std::string_view>, 3> stages{{
+      {Stage::Decode, "decode"},
+      {Stage::Handle, "handle"},
+      {Stage::Encode, "encode"}}};
+
+    for (const auto& [stage, stageName] : stages)
+    {
+      const auto& stageSummary = summary.Get(stage);
+      if (stageSummary.latency.count == 0)
+        continue;
+
+      line += std::format(
+        " | {} n={} {}B p50={}us p99={}us max={}us",
+        stageName,
+        stageSummary.latency.count,
+        stageSummary.bytes,
+        ToMicroseconds(stageSummary.latency.p50),
+        ToMicroseconds(stageSummary.latency.p99),
+        ToMicroseconds(stageSummary.latency.max));
+    }
+
+    lines.emplace_back(std::move(line));
+  }
+
+  return lines;
+}
+
+void CommandMetrics::Reset() noexcept
+{
+  for (std::size_t commandIdx = 0; commandIdx < protocol::CommandCount; ++commandIdx)
+  {
+    Metrics* metrics = _metrics[commandIdx].load(std::memory_order::acquire);
+    if (metrics == nullptr)
+      continue;
+
+    for (auto& stageMetrics : *metrics)
+    {
+      stageMetrics.bytes.store(0, std::memory_order::relaxed);
+      stageMetrics.latency.Reset();
+    }
+  }
+}
+
+} // namespace server
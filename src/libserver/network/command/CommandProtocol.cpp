@@ -19,7 +19,7 @@
 
 #include "libserver/network/command/CommandProtocol.hpp"
 
-#include <unordered_map>
+#include <utility>
 
 namespace server::protocol
 {
@@ -27,8 +27,8 @@ namespace server::protocol
 namespace
 {
 
-//! Commands IDs mapped to the command names.
-const std::unordered_map<Command, std::string_view> commands = {
+//! Commands IDs paired with the command names.
+constexpr std::pair<Command, std::string_view> CommandNames[] = {
   {Command::AcCmdCLLogin, "AcCmdCLLogin"},
   {Command::AcCmdCLLoginOK, "AcCmdCLLoginOK"},
   {Command::AcCmdCLLoginCancel, "AcCmdCLLoginCancel"},
@@ -675,6 +675,61 @@ const std::unordered_map<Command, std::string_view> commands = {
   {Command::AcCmdUserRaceItemGet, "AcCmdUserRaceItemGet"},
 };
 
+//! Commands excluded from the debug logs.
+constexpr Command MutedCommands[] = {
+  Command::AcCmdCLHeartbeat,
+  Command::AcCmdCLRoomList,
+  Command::AcCmdCLRoomListOK,
+  Command::AcCmdCRHeartbeat,
+  Command::AcCmdCRRanchSnapshot,
+  Command::AcCmdCRRanchSnapshotNotify,
+  Command::AcCmdUserRaceUpdatePos,
+  Command::AcCmdCRRelay,
+  Command::AcCmdCRRelayNotify,
+  Command::AcCmdCRRelayCommand,
+  Command::AcCmdCRRelayCommandNotify,
+  Command::AcCmdUserRaceActivateEvent,
+  Command::AcCmdCRStarPointGet,
+  Command::AcCmdCRStarPointGetOK};
+
+//! Commands which may be dropped when a client falls behind.
+//! Snapshots and relayed state are superseded by the next ones.
+constexpr Command DroppableCommands[] = {
+  Command::AcCmdCRRanchSnapshotNotify,
+  Command::AcCmdCRRelayNotify};
+
+//! Commands streamed at a high rate.
+constexpr Command StreamCommands[] = {
+  Command::AcCmdCLHeartbeat,
+  Command::AcCmdCRHeartbeat,
+  Command::AcCmdCRRanchSnapshot,
+  Command::AcCmdCRRanchSnapshotNotify,
+  Command::AcCmdUserRaceUpdatePos,
+  Command::AcCmdCRRelay,
+  Command::AcCmdCRRelayNotify,
+  Command::AcCmdCRRelayCommand,
+  Command::AcCmdCRRelayCommandNotify};
+
+//! Traits of the commands indexed by the command IDs.
+constexpr auto CommandTraitsTable = []()
+{
+  std::array<CommandTraits, CommandCount> table{};
+
+  for (const auto& [command, name] : CommandNames)
+    table[static_cast<std::size_t>(command)].name = name;
+  for (const auto command : MutedCommands)
+    table[static_cast<std::size_t>(command)].isMuted = true;
+  for (const auto command : DroppableCommands)
+    table[static_cast<std::size_t>(command)].priority = CommandPriority::Droppable;
+  for (const auto command : StreamCommands)
+    table[static_cast<std::size_t>(command)].rateClass = CommandRateClass::Stream;
+
+  return table;
+}();
+
+//! Traits of the unknown commands.
+constexpr CommandTraits UnknownCommandTraits{};
+
 } // namespace
 
 MessageMagic decode_message_magic(uint32_t value)
@@ -708,10 +763,17 @@ uint32_t encode_message_magic(MessageMagic magic)
   return encoded;
 }
 
+const CommandTraits& GetCommandTraits(Command command) noexcept
+{
+  const auto index = static_cast<std::size_t>(command);
+  return index < CommandTraitsTable.size()
+    ? CommandTraitsTable[index]
+    : UnknownCommandTraits;
+}
+
 std::string_view GetCommandName(Command command)
 {
-  const auto commandIter = commands.find(command);
-  return commandIter == commands.cend() ? "n/a" : commandIter->second;
+  return GetCommandTraits(command).name;
 }
 
 } // namespace server
@@ -19,9 +19,10 @@
 
 #include "libserver/network/command/CommandServer.hpp"
 
-#include "libserver/util/Deferred.hpp"
-#include "libserver/util/Util.hpp"
+#include "libserver/network/XorCodec.hpp"
+#include "libserver/network/command/proto/LobbyMessageDefinitions.hpp"
 
+#include <cstring>
 #include <ranges>
 #include <stacktrace>
 
@@ -33,54 +34,24 @@ namespace server
 namespace
 {
 
-//! Max size of the command data.
-constexpr std::size_t MaxCommandDataSize = 8192;
+//! Interval of the log of the command metrics.
+constexpr auto MetricsLogInterval = std::chrono::minutes(5);
+//! Count of the commands in the log of the command metrics.
+constexpr std::size_t MetricsLogCommandCount = 10;
 
-//! Max size of the whole command payload.
-//! That is command data size + size of the message magic.
-constexpr std::size_t MaxCommandSize = MaxCommandDataSize + sizeof(protocol::MessageMagic);
-
-//! Reads every specified byte of the source stream,
-//! performs XOR operation on that byte with the specified sliding key
-//! and writes the result to the sink stream.
-//!
-//! @param key Xor Key
-//! @param source Source stream.
-//! @param sink Sink stream.
-void XorAlgorithm(
-  const protocol::XorCode& key,
-  SourceStream& source,
-  SinkStream& sink)
+//! Returns the priority of the write of the command.
+//! @param id ID of the command.
+//! @returns Priority of the write.
+network::WritePriority GetWritePriority(protocol::Command id)
 {
-  for (std::size_t idx = 0; idx < source.Size(); idx++)
-  {
-    const auto shift = idx % 4;
-
-    // Read a byte.
-    std::byte v;
-    source.Read(v);
-
-    // Xor it with the key.
-    sink.Write(v ^ key[shift]);
-  }
+  return protocol::GetCommandTraits(id).priority == protocol::CommandPriority::Droppable
+    ? network::WritePriority::Droppable
+    : network::WritePriority::Reliable;
 }
 
 bool IsMuted(protocol::Command id)
 {
-  return id == protocol::Command::AcCmdCLHeartbeat
-    || id == protocol::Command::AcCmdCLRoomList
-    || id == protocol::Command::AcCmdCLRoomListOK
-    || id == protocol::Command::AcCmdCRHeartbeat
-    || id == protocol::Command::AcCmdCRRanchSnapshot
-    || id == protocol::Command::AcCmdCRRanchSnapshotNotify
-    || id == protocol::Command::AcCmdUserRaceUpdatePos
-    || id == protocol::Command::AcCmdCRRelay
-    || id == protocol::Command::AcCmdCRRelayNotify
-    || id == protocol::Command::AcCmdCRRelayCommand
-    || id == protocol::Command::AcCmdCRRelayCommandNotify
-    || id == protocol::Command::AcCmdUserRaceActivateEvent
-    || id == protocol::Command::AcCmdCRStarPointGet
-    || id == protocol::Command::AcCmdCRStarPointGetOK;
+  return protocol::GetCommandTraits(id).isMuted;
 }
 
 } // namespace
@@ -109,6 +80,114 @@ int32_t CommandClient::GetRollingCodeInt() const
   return *reinterpret_cast<const int32_t*>(_rollingCode.data());
 }
 
+network::FrameHeader CommandFraming::ReadHeader(
+  const std::span<const std::byte> header)
+{
+  uint32_t magicValue{};
+  std::memcpy(&magicValue, header.data(), sizeof(magicValue));
+
+  const auto magic = protocol::decode_message_magic(magicValue);
+
+  // Command ID must be within the valid range.
+  if (magic.id > static_cast<uint16_t>(protocol::Command::Count))
+  {
+    throw std::runtime_error(
+      std::format(
+        "Invalid command magic: Bad command ID '{}'",
+        magic.id));
+  }
+
+  return {
+    .commandId = magic.id,
+    .frameSize = magic.length};
+}
+
+void CommandFraming::WriteHeader(
+  const std::span<std::byte> header,
+  const network::FrameHeader& frameHeader)
+{
+  const uint32_t magicValue = protocol::encode_message_magic({
+    .id = frameHeader.commandId,
+    .length = static_cast<uint16_t>(frameHeader.frameSize)});
+
+  std::memcpy(header.data(), &magicValue, sizeof(magicValue));
+}
+
+std::span<std::byte> CommandFraming::DecodeData(
+  CommandClient& client,
+  const uint16_t commandId,
+  const std::span<std::byte> data)
+{
+  // The code rolls only for the commands with data.
+  if (data.empty())
+    return data;
+
+  client.RollCode();
+
+  // Extract the padding from the code.
+  const auto padding = static_cast<uint32_t>(client.GetRollingCodeInt()) & 7;
+
+  // The command is malformed if the provided command data
+  // size is smaller or equal to the generated padding.
+  if (padding >= data.size())
+  {
+    throw std::runtime_error(
+      std::format(
+        "Malformed command {}: Bad command data size '{}', padding is {}.",
+        GetCommandName(commandId),
+        data.size(),
+        padding));
+  }
+
+  // Apply XOR algorithm to the data.
+  network::XorInPlace(data, client.GetRollingCode());
+
+  return data.first(data.size() - padding);
+}
+
+std::string_view CommandFraming::GetCommandName(const uint16_t commandId)
+{
+  return protocol::GetCommandName(static_cast<protocol::Command>(commandId));
+}
+
+bool CommandFraming::IsMuted(const uint16_t commandId)
+{
+  return server::IsMuted(static_cast<protocol::Command>(commandId));
+}
+
+bool CommandFraming::HasCredentials(const uint16_t commandId)
+{
+  return static_cast<protocol::Command>(commandId) == protocol::Command::AcCmdCLLogin;
+}
+
+std::span<std::byte> CommandFraming::RedactCredentials(
+  const uint16_t commandId,
+  const std::span<std::byte> data)
+{
+  if (not HasCredentials(commandId))
+    return data;
+
+  try
+  {
+    protocol::AcCmdCLLogin command;
+    SourceStream source(data);
+    protocol::AcCmdCLLogin::Read(command, source);
+
+    command.memberNo = 0;
+    command.authKey.clear();
+
+    // The redacted command is never larger than the original one.
+    SinkStream sink(data);
+    protocol::AcCmdCLLogin::Write(command, sink);
+    return data.first(sink.GetCursor());
+  }
+  catch (const std::exception&)
+  {
+    // Malformed commands are not captured at all.
+    return {};
+  }
+}
+
 CommandServer::CommandServer(
   EventHandlerInterface& networkEventHandler)
   : _eventHandler(networkEventHandler)
@@ -117,14 +196,17 @@ CommandServer::CommandServer(
 {
 }
 
-void CommandServer::BeginHost(const asio::ip::address& address, uint16_t port)
+void CommandServer::BeginHost(
+  const asio::ip::address& address,
+  uint16_t port,
+  uint32_t ioThreadCount)
 {
   _serverThread = std::thread(
-    [this, address, port]()
+    [this, address, port, ioThreadCount]()
     {
       try
       {
-        _server.Begin(address, port);
+        _server.Begin(address, port, ioThreadCount);
       }
       catch (const std::exception& x)
       {
@@ -155,17 +237,54 @@ asio::ip::address_v4 CommandServer::GetClientAddress(
   return _server.GetClient(clientId)->GetAddress();
 }
 
+std::optional<asio::ip::address_v4> CommandServer::FindClientAddress(
+  const ClientId clientId)
+{
+  const auto client = _server.FindClient(clientId);
+  if (not client)
+    return std::nullopt;
+
+  return client->GetAddress();
+}
+
 void CommandServer::DisconnectClient(
   const ClientId clientId)
 {
   _server.GetClient(clientId)->End();
 }
 
+CommandMetrics& CommandServer::GetMetrics() noexcept
+{
+  return _metrics;
+}
+
+network::TrafficRecorder& CommandServer::GetTrafficRecorder() noexcept
+{
+  return _transport.GetTrafficRecorder();
+}
+
+void CommandServer::SetNetworkTickInterval(const std::chrono::steady_clock::duration tickInterval)
+{
+  _server.SetTickInterval(tickInterval);
+}
+
+network::WriteQueueStats CommandServer::GetWriteQueueStats()
+{
+  return _server.GetWriteQueueStats();
+}
+
 void CommandServer::SetCode(
   const ClientId client,
   const protocol::XorCode code)
 {
-  _clients[client].SetCode(code);
+  auto& guardedClient = [this, client]() -> GuardedClient&
+  {
+    std::scoped_lock lock(_clientsMutex);
+    return _clients[client];
+  }();
+
+  std::scoped_lock lock(guardedClient.mutex);
+  guardedClient.client.SetCode(code);
 }
 
 CommandServer::NetworkEventHandler::NetworkEventHandler(
@@ -177,283 +296,210 @@ CommandServer::NetworkEventHandler::NetworkEventHandler(
 void CommandServer::NetworkEventHandler::HandleNetworkTick()
 {
   _commandServer._eventHandler.HandleNetworkTick();
+
+  // Periodically log the busiest commands.
+  const auto now = Clock::now();
+  if (now - _commandServer._lastMetricsLog >= MetricsLogInterval)
+  {
+    _commandServer._lastMetricsLog = now;
+
+    for (const auto& line : _commandServer._metrics.Format(MetricsLogCommandCount))
+    {
+      spdlog::info("Command metrics: {}", line);
+    }
+  }
 }
 
 void CommandServer::NetworkEventHandler::OnClientConnected(
   network::ClientId clientId)
 {
+  _commandServer._transport.GetTrafficRecorder().RecordConnect(clientId);
   _commandServer._eventHandler.HandleClientConnected(clientId);
 }
 
 void CommandServer::NetworkEventHandler::OnClientDisconnected(
   network::ClientId clientId)
 {
+  _commandServer._transport.GetTrafficRecorder().RecordDisconnect(clientId);
   _commandServer._eventHandler.HandleClientDisconnected(clientId);
 }
 
 size_t CommandServer::NetworkEventHandler::OnClientData(
   network::ClientId clientId,
-  const std::span<const std::byte>& data)
+  const std::span<std::byte>& data)
 {
-  SourceStream commandStream(data);
-
-  while (commandStream.GetCursor() != commandStream.Size())
+  // References to the elements of the map stay valid after the lock is released.
+  auto& guardedClient = [this, clientId]() -> GuardedClient&
   {
-    // The size of the buffer that was not read yet.
-    const size_t bufferedDataSize = commandStream.Size() - commandStream.GetCursor();
-
-    // Do not continue if the available data does not contain the data
-    // for the message magic.
-    if (bufferedDataSize < sizeof(protocol::MessageMagic))
-      break;
+    std::scoped_lock lock(_commandServer._clientsMutex);
+    return _commandServer._clients[clientId];
+  }();
 
-    // Store the origin cursor position before reading the command.
-    // This is so we can return to it if the command is not completely buffered.
-    const auto streamOrigin = commandStream.GetCursor();
-    bool isCommandBufferedWhole = true;
+  // The commands decoded before a malformed frame are dispatched too.
+  network::DecodedCommands decoded;
+  const Deferred dispatchDecoded([this, clientId, &decoded]()
+  {
+    if (decoded.commands.empty())
+      return;
 
-    const Deferred deferredResetCommandStreamCursor(
-      [streamOrigin, &commandStream, &isCommandBufferedWhole]()
+    _commandServer._server.PostEvent(
+      [this, clientId, decoded = std::move(decoded)]()
       {
-        // If the command was not buffered whole,
-        // reset the stream to the cursor before the command was read,
-        // so that it may be read when more data arrive.
-        if (not isCommandBufferedWhole)
-          commandStream.Seek(streamOrigin);
+        _commandServer._transport.Dispatch(clientId, decoded);
       });
+  });
 
-    // Read the message magic.
-    uint32_t magicValue{};
-    commandStream.Read(magicValue);
-
-    const auto magic = protocol::decode_message_magic(magicValue);
-
-    // Command ID must be within the valid range.
-    if (magic.id > static_cast<uint16_t>(protocol::Command::Count))
-    {
-      throw std::runtime_error(
-        std::format(
-          "Invalid command magic: Bad command ID '{}'",
-          magic.id)
-          .c_str());
-    }
-
-    // The provided payload length must be at least the size
-    // of the magic itself and smaller than the max command size.
-    if (magic.length < sizeof(protocol::MessageMagic) || magic.length > MaxCommandSize)
-    {
-      throw std::runtime_error(
-        std::format(
-          "Invalid command magic: Bad command data size '{}'",
-          magic.length)
-          .c_str());
-    }
-
-    // Size of the data portion of the command.
-    const size_t commandDataSize = static_cast<size_t>(magic.length) - sizeof(protocol::MessageMagic);
-    // Size of the available data.
-    const size_t availableDataSize = bufferedDataSize - sizeof(protocol::MessageMagic);
-
-    // If all the required command data are not buffered,
-    // wait for them to arrive.
-    if (commandDataSize > availableDataSize)
-    {
-      isCommandBufferedWhole = false;
-      break;
-    }
-
-    // Buffer for the command data.
-    std::array<std::byte, MaxCommandDataSize> commandDataBuffer{};
-
-    // Read the command data.
-    commandStream.Read(
-      commandDataBuffer.data(),
-      commandDataSize);
+  std::scoped_lock lock(guardedClient.mutex);
+  return _commandServer._transport.ReadFrames(guardedClient.client, data, decoded);
+}
 
-    SourceStream commandDataStream(nullptr);
+void CommandServer::ReplayClientConnected(ClientId clientId)
+{
+  {
+    std::scoped_lock lock(_clientsMutex);
+    _clients.try_emplace(clientId);
+  }
 
-    auto& client = _commandServer._clients[clientId];
+  _eventHandler.HandleClientConnected(clientId);
+}
 
-    const auto commandId = static_cast<protocol::Command>(magic.id);
+void CommandServer::ReplayClientDisconnected(ClientId clientId)
+{
+  _eventHandler.HandleClientDisconnected(clientId);
 
-    // Validate and process the command data.
-    if (commandDataSize > 0)
-    {
-      client.RollCode();
+  std::scoped_lock lock(_clientsMutex);
+  _clients.erase(clientId);
+}
 
-      const uint32_t code = client.GetRollingCodeInt();
+void CommandServer::ReplayCommand(
+  ClientId clientId,
+  protocol::Command commandId,
+  std::span<const std::byte> commandData)
+{
+  SourceStream commandDataStream(commandData);
+  _transport.Dispatch(
+    clientId,
+    static_cast<uint16_t>(commandId),
+    commandDataStream);
+}
 
-      // Extract the padding from the code.
-      const auto padding = code & 7;
+void CommandServer::SendCommand(
+  ClientId clientId,
+  protocol::Command commandId,
+  const CommandWriter& writer,
+  const std::optional<std::size_t> commandDataSize)
+{
+  std::shared_ptr<network::Client> client;
+  try
+  {
+    client = _server.GetClient(clientId);
+  }
+  catch (const std::exception&)
+  {
+    // the client disconnected, todo dont use client ids, or dont
+    return;
+  }
 
-      // The command is malformed if the provided command data
-      // size is smaller or equal to the generated padding.
-      if (padding >= commandDataSize)
-      {
-        throw std::runtime_error(
-          std::format(
-            "Malformed command {}: Bad command data size '{}', padding is {}.",
-            GetCommandName(commandId),
-            commandDataSize,
-            padding)
-            .c_str());
-      }
+  network::SharedWriteBuffer writeBuffer;
+  try
+  {
+    writeBuffer = EncodeCommand(commandId, writer, commandDataSize);
+  }
+  catch (const std::exception& x)
+  {
+    spdlog::error("Unhandled exception writing command '{}' (0x{:X}) for client {}: {}",
+      GetCommandName(commandId),
+      static_cast<uint32_t>(commandId),
+      clientId,
+      x.what());
+    client->End();
+    return;
+  }
 
-      const auto actualCommandDataSize = commandDataSize - padding;
+  client->QueueWrite(std::move(writeBuffer), GetWritePriority(commandId));
 
-      // Source stream of the command data.
-      SourceStream dataSourceStream(
-        {commandDataBuffer.begin(), commandDataSize});
-      // Sink stream of the command data.
-      // Correctly points to the same buffer.
-      SinkStream dataSinkStream(
-        {commandDataBuffer.begin(), commandDataBuffer.end()});
+  if (_transport.debugCommands
+    && not IsMuted(commandId))
+  {
+    spdlog::debug("Sent command message '{}' (0x{:X})",
+    GetCommandName(commandId),
+    static_cast<uint32_t>(commandId));
+  }
+}
 
-      // Apply XOR algorithm to the data.
-      XorAlgorithm(
-        client.GetRollingCode(),
-        dataSourceStream,
-        dataSinkStream);
+void CommandServer::BroadcastCommand(
+  std::span<const ClientId> recipients,
+  protocol::Command commandId,
+  const CommandWriter& writer,
+  const std::optional<std::size_t> commandDataSize)
+{
+  if (recipients.empty())
+    return;
 
-      commandDataStream = std::move(SourceStream(
-        {commandDataBuffer.begin(), actualCommandDataSize}));
+  network::SharedWriteBuffer writeBuffer;
+  try
+  {
+    writeBuffer = EncodeCommand(commandId, writer, commandDataSize);
+  }
+  catch (const std::exception& x)
+  {
+    spdlog::error("Unhandled exception writing broadcast command '{}' (0x{:X}): {}",
+      GetCommandName(commandId),
+      static_cast<uint32_t>(commandId),
+      x.what());
+    return;
+  }
 
-      if (_commandServer.debugIncomingCommandData
-        && not IsMuted(commandId))
-      {
-        spdlog::debug("Read data for command '{}' (0x{:X}),\n\n"
-          "XOR code: {:#X},\n"
-          "Command data size: {} (padding: {}),\n"
-          "Actual command data size: {}\n"
-          "Processed data dump: \n\n{}\n",
-          GetCommandName(commandId),
-          magic.id,
-          code,
-          commandDataSize,
-          padding,
-          actualCommandDataSize,
-          util::GenerateByteDump({commandDataBuffer.data(), commandDataSize}));
-      }
-    }
+  const auto writePriority = GetWritePriority(commandId);
 
-    // Find the handler of the command.
-    const auto handlerIter = _commandServer._handlers.find(commandId);
-    if (handlerIter == _commandServer._handlers.cend())
+  // The outgoing frames are not scrambled per client,
+  // so every recipient is queued the same encoded frame.
+  for (const ClientId clientId : recipients)
+  {
+    std::shared_ptr<network::Client> client;
+    try
     {
-      if (_commandServer.debugCommands
-        && not IsMuted(commandId))
-      {
-        spdlog::warn(
-          "Unhandled command '{}' (0x{:x})",
-          GetCommandName(commandId),
-          magic.id);
-      }
+      client = _server.GetClient(clientId);
     }
-    else
+    catch (const std::exception&)
     {
-      const auto& handler = handlerIter->second;
-      // Handler validity is checked when registering.
-      assert(handler);
-
-      try
-      {
-        // Call the handler.
-        handler(clientId, commandDataStream);
-      }
-      catch (const std::exception& x)
-      {
-        spdlog::error(
-          "Unhandled exception handling command '{}' (0x{:x}): {}",
-          protocol::GetCommandName(commandId),
-          magic.id,
-          x.what());
-      }
-
-      // There shouldn't be any left-over data in the stream.
-      assert(commandDataStream.GetCursor() == commandDataStream.Size());
-
-      if (_commandServer.debugCommands
-        && not IsMuted(commandId))
-      {
-        spdlog::debug(
-          "Handled command '{}' (0x{:x})",
-          GetCommandName(commandId),
-          magic.id);
-      }
+      // the client disconnected
+      continue;
     }
+
+    client->QueueWrite(writeBuffer, writePriority);
   }
 
-  return commandStream.GetCursor();
+  if (_transport.debugCommands
+    && not IsMuted(commandId))
+  {
+    spdlog::debug("Broadcast command message '{}' (0x{:X}) to {} clients",
+    GetCommandName(commandId),
+    static_cast<uint32_t>(commandId),
+    recipients.size());
+  }
 }
 
-void CommandServer::SendCommand(
-  ClientId clientId,
+network::SharedWriteBuffer CommandServer::EncodeCommand(
   protocol::Command commandId,
-  CommandSupplier supplier)
+  const CommandWriter& writer,
+  const std::optional<std::size_t> commandDataSize)
 {
-  try
-  {
-    _server.GetClient(clientId)->QueueWrite(
-      [this, commandId, supplier = std::move(supplier)](asio::streambuf& writeBuffer)
-      {
-        const auto mutableBuffer = writeBuffer.prepare(MaxCommandSize);
-        const auto writeBufferView = std::span(
-          static_cast<std::byte*>(mutableBuffer.data()),
-          mutableBuffer.size());
-
-        SinkStream commandSink(writeBufferView);
+  const auto encodeBegin = Clock::now();
 
-        const auto streamOrigin = commandSink.GetCursor();
-        commandSink.Seek(streamOrigin + sizeof(protocol::MessageMagic));
-
-        // Write the message data.
-        supplier(commandSink);
-
-        // Command size is the size of the whole command.
-        const size_t commandSize = commandSink.GetCursor();
-
-        if (debugOutgoingCommandData
-          && not IsMuted(commandId))
-        {
-          spdlog::debug("Write data for command '{}' (0x{:X}),\n\n"
-            "Command data size: {} \n"
-            "Data dump: \n\n{}\n",
-            GetCommandName(commandId),
-            static_cast<uint32_t>(commandId),
-            commandSize,
-            util::GenerateByteDump(
-              std::span(
-                static_cast<std::byte*>(mutableBuffer.data()) + sizeof(protocol::MessageMagic),
-                commandSize - sizeof(protocol::MessageMagic))));
-        }
+  auto writeBuffer = std::make_shared<const network::WriteBuffer>(
+    _transport.EncodeFrame(
+      static_cast<uint16_t>(commandId),
+      writer,
+      commandDataSize));
 
-        // Traverse back the stream before the message data,
-        // and write the message magic.
-        commandSink.Seek(streamOrigin);
+  _metrics.Record(
+    commandId,
+    CommandMetrics::Stage::Encode,
+    writeBuffer->size(),
+    Clock::now() - encodeBegin);
 
-        // Write the message magic.
-        const protocol::MessageMagic magic{
-          .id = static_cast<uint16_t>(commandId),
-          .length = static_cast<uint16_t>(commandSize)};
-
-        commandSink.Write(encode_message_magic(magic));
-        writeBuffer.commit(magic.length);
-
-        if (debugCommands
-          && not IsMuted(commandId))
-        {
-          spdlog::debug("Sent command message '{}' (0x{:X})",
-          GetCommandName(commandId),
-          static_cast<uint32_t>(commandId));
-        }
-
-        return commandSize;
-      });
-  }
-  catch (std::exception&)
-  {
-    // the client disconnected, todo dont use client ids, or dont
-  }
+  return writeBuffer;
 }
 
 } // namespace server
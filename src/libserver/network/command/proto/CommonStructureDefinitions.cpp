@@ -26,18 +26,12 @@ namespace server::protocol
 
 void Item::Write(const Item& item, SinkStream& stream)
 {
-  stream.Write(item.uid)
-    .Write(item.tid)
-    .Write(item.expiresAt)
-    .Write(item.count);
+  stream.Write(std::span(&item, 1));
 }
 
 void Item::Read(Item& item, SourceStream& stream)
 {
-  stream.Read(item.uid)
-    .Read(item.tid)
-    .Read(item.expiresAt)
-    .Read(item.count);
+  stream.Read(std::span(&item, 1));
 }
 
 void StoredItem::Write(const StoredItem& item, SinkStream& stream)
@@ -639,11 +633,8 @@ void RanchCharacter::Write(const RanchCharacter& ranchCharacter, SinkStream& str
   stream.Write(ranchCharacter.character)
     .Write(ranchCharacter.mount);
 
-  stream.Write(static_cast<uint8_t>(ranchCharacter.characterEquipment.size()));
-  for (const Item& item : ranchCharacter.characterEquipment)
-  {
-    stream.Write(item);
-  }
+  stream.Write(static_cast<uint8_t>(ranchCharacter.characterEquipment.size()))
+    .Write(std::span(ranchCharacter.characterEquipment));
 
   // Guild
   const auto& struct5 = ranchCharacter.guild;
@@ -685,10 +676,7 @@ void RanchCharacter::Read(RanchCharacter& value, SourceStream& stream)
   uint8_t size;
   stream.Read(size);
   value.characterEquipment.resize(size);
-  for (auto& item : value.characterEquipment)
-  {
-    stream.Read(item);
-  }
+  stream.Read(std::span(value.characterEquipment));
 
   stream.Read(value.guild);
 
@@ -866,18 +854,14 @@ void Vector3::Write(
   const Vector3& vector,
   SinkStream& stream)
 {
-  stream.Write(vector.x)
-    .Write(vector.y)
-    .Write(vector.z);
+  stream.Write(std::span(&vector, 1));
 }
 
 void Vector3::Read(
   Vector3& vector,
   SourceStream& stream)
 {
-  stream.Read(vector.x)
-    .Read(vector.y)
-    .Read(vector.z);
+  stream.Read(std::span(&vector, 1));
 }
 
 void BreedingBonus::Write(
@@ -23,10 +23,15 @@ namespace server::protocol
 {
 
 void AcCmdCLLogin::Write(
-  const AcCmdCLLogin&,
-  SinkStream&)
+  const AcCmdCLLogin& command,
+  SinkStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Write(command.constant0)
+    .Write(command.constant1)
+    .Write(command.loginId)
+    .Write(command.memberNo)
+    .Write(command.authKey)
+    .Write(command.val0);
 }
 
 void AcCmdCLLogin::Read(
@@ -52,10 +57,19 @@ void LobbyCommandLoginOK::SystemContent::Write(const SystemContent& command, Sin
 }
 
 void LobbyCommandLoginOK::SystemContent::Read(
-  SystemContent&,
-  SourceStream&)
+  SystemContent& command,
+  SourceStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  uint8_t size{};
+  stream.Read(size);
+  for (uint8_t idx = 0; idx < size; ++idx)
+  {
+    uint32_t key{};
+    uint32_t value{};
+    stream.Read(key)
+      .Read(value);
+    command.values[key] = value;
+  }
 }
 
 void LobbyCommandLoginOK::Write(
@@ -78,12 +92,8 @@ void LobbyCommandLoginOK::Write(
   if (command.equipmentItems.size() > MaxEquipmentItemCount)
     throw std::runtime_error("Equipment item count is over the limit");
 
-  stream.Write(static_cast<uint8_t>(command.equipmentItems.size()));
-  for (size_t idx = 0; idx < command.equipmentItems.size(); ++idx)
-  {
-    const auto& item = command.equipmentItems[idx];
-    stream.Write(item);
-  }
+  stream.Write(static_cast<uint8_t>(command.equipmentItems.size()))
+    .Write(std::span(command.equipmentItems));
 
   constexpr size_t MaxExpiredItemCount = 250;
 
@@ -91,12 +101,8 @@ void LobbyCommandLoginOK::Write(
   if (command.expiredItems.size() > MaxExpiredItemCount)
     throw std::runtime_error("Expired item count is over the limit");
 
-  stream.Write(static_cast<uint8_t>(command.expiredItems.size()));
-  for (size_t idx = 0; idx < command.expiredItems.size(); ++idx)
-  {
-    const auto& item = command.expiredItems[idx];
-    stream.Write(item);
-  }
+  stream.Write(static_cast<uint8_t>(command.expiredItems.size()))
+    .Write(std::span(command.expiredItems));
 
   //
   stream.Write(command.level)
@@ -194,10 +200,129 @@ void LobbyCommandLoginOK::Write(
 }
 
 void LobbyCommandLoginOK::Read(
-  LobbyCommandLoginOK&,
-  SourceStream&)
+  LobbyCommandLoginOK& command,
+  SourceStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Read(command.lobbyTime.dwLowDateTime)
+    .Read(command.lobbyTime.dwHighDateTime)
+    .Read(command.member0);
+
+  // Profile
+  stream.Read(command.uid)
+    .Read(command.name)
+    .Read(command.notice)
+    .Read(reinterpret_cast<uint8_t&>(command.gender))
+    .Read(command.introduction);
+
+  uint8_t equipmentItemCount{};
+  stream.Read(equipmentItemCount);
+  command.equipmentItems.resize(equipmentItemCount);
+  stream.Read(std::span(command.equipmentItems));
+
+  uint8_t expiredItemCount{};
+  stream.Read(expiredItemCount);
+  command.expiredItems.resize(expiredItemCount);
+  stream.Read(std::span(command.expiredItems));
+
+  //
+  stream.Read(command.level)
+    .Read(command.carrots)
+    .Read(command.levelProgress)
+    .Read(command.role)
+    .Read(command.val3);
+
+  //
+  stream.Read(command.settings);
+
+  //
+  uint8_t missionCount{};
+  stream.Read(missionCount);
+  command.missions.resize(missionCount);
+  for (auto& val : command.missions)
+  {
+    stream.Read(val.id);
+
+    uint8_t progressCount{};
+    stream.Read(progressCount);
+    val.progress.resize(progressCount);
+    for (auto& nestedVal : val.progress)
+    {
+      stream.Read(nestedVal.id)
+        .Read(nestedVal.value);
+    }
+  }
+
+  stream.Read(command.val6);
+
+  stream.Read(command.ranchAddress)
+    .Read(command.ranchPort)
+    .Read(command.scramblingConstant);
+
+  stream.Read(command.character)
+    .Read(command.horse);
+
+  stream.Read(command.systemContent)
+    .Read(command.bitfield);
+
+  // Struct2
+  auto& struct1 = command.val9;
+  stream.Read(struct1.val0)
+    .Read(struct1.val1)
+    .Read(struct1.val2);
+
+  stream.Read(command.val10);
+
+  auto& managementSkills = command.managementSkills;
+  stream.Read(managementSkills.val0)
+    .Read(managementSkills.progress)
+    .Read(managementSkills.points);
+
+  auto& skillRanks = command.skillRanks;
+  uint8_t skillRankCount{};
+  stream.Read(skillRankCount);
+  skillRanks.values.resize(skillRankCount);
+  for (auto& value : skillRanks.values)
+  {
+    stream.Read(value.id)
+      .Read(value.rank);
+  }
+
+  uint8_t mapProgressInfoCount{};
+  stream.Read(mapProgressInfoCount);
+  command.trainingProgression.mapProggressInfos.resize(mapProgressInfoCount);
+  for (auto& value : command.trainingProgression.mapProggressInfos)
+  {
+    stream.Read(value.mapBlockId)
+      .Read(value.gameMode)
+      .Read(value.clearStage);
+  }
+
+  stream.Read(command.characterCreationDate);
+
+  // Guild
+  auto& struct5 = command.guild;
+  stream.Read(struct5.uid)
+    .Read(struct5.val1)
+    .Read(struct5.val2)
+    .Read(struct5.name)
+    .Read(struct5.guildRole)
+    .Read(struct5.val5)
+    .Read(struct5.val6);
+
+  stream.Read(command.val16);
+
+  // Rent
+  auto& struct6 = command.val17;
+  stream.Read(struct6.mountUid)
+    .Read(struct6.val1)
+    .Read(struct6.val2);
+
+  stream.Read(command.val18)
+    .Read(command.val19)
+    .Read(command.val20);
+
+  // Pet
+  stream.Read(command.pet);
 }
 
 void AcCmdCLLoginCancel::Write(
@@ -237,11 +362,8 @@ void LobbyCommandShowInventoryOK::Write(
   if (command.horses.size() > 10)
     throw std::runtime_error("Horse count greater than protocol max (10)");
 
-  stream.Write(static_cast<uint8_t>(command.items.size()));
-  for (const auto& item : command.items)
-  {
-    stream.Write(item);
-  }
+  stream.Write(static_cast<uint8_t>(command.items.size()))
+    .Write(std::span(command.items));
 
   stream.Write(static_cast<uint8_t>(command.horses.size()));
   for (const auto& horse : command.horses)
@@ -272,10 +394,12 @@ void LobbyCommandCreateNicknameNotify::Read(
 }
 
 void AcCmdCLCreateNickname::Write(
-  const AcCmdCLCreateNickname&,
-  SinkStream&)
+  const AcCmdCLCreateNickname& command,
+  SinkStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Write(command.nickname)
+    .Write(command.character)
+    .Write(command.requestedHorseTid);
 }
 
 void AcCmdCLCreateNickname::Read(
@@ -536,10 +660,18 @@ void LobbyCommandRoomListOK::Read(
 }
 
 void AcCmdCLMakeRoom::Write(
-  const AcCmdCLMakeRoom&,
-  SinkStream&)
+  const AcCmdCLMakeRoom& command,
+  SinkStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Write(command.name)
+    .Write(command.password)
+    .Write(command.playerCount)
+    .Write(command.gameMode)
+    .Write(command.teamMode)
+    .Write(command.missionId)
+    .Write(command.unk3)
+    .Write(command.bitset)
+    .Write(command.unk4);
 }
 
 void AcCmdCLMakeRoom::Read(
@@ -569,10 +701,16 @@ void AcCmdCLMakeRoomOK::Write(
 }
 
 void AcCmdCLMakeRoomOK::Read(
-  AcCmdCLMakeRoomOK&,
-  SourceStream&)
+  AcCmdCLMakeRoomOK& command,
+  SourceStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Read(command.roomUid)
+    .Read(command.oneTimePassword)
+    .Read(command.raceServerAddress)
+    .Read(command.raceServerPort)
+    .Read(command.unk2);
+
+  command.raceServerAddress = ntohl(command.raceServerAddress);
 }
 
 void AcCmdCLMakeRoomCancel::Write(
@@ -590,10 +728,12 @@ void AcCmdCLMakeRoomCancel::Read(
 }
 
 void AcCmdCLEnterRoom::Write(
-  const AcCmdCLEnterRoom&,
-  SinkStream&)
+  const AcCmdCLEnterRoom& command,
+  SinkStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Write(command.roomUid)
+    .Write(command.password)
+    .Write(command.enterRoomType);
 }
 
 void AcCmdCLEnterRoom::Read(
@@ -617,10 +757,16 @@ void AcCmdCLEnterRoomOK::Write(
 }
 
 void AcCmdCLEnterRoomOK::Read(
-  AcCmdCLEnterRoomOK&,
-  SourceStream&)
+  AcCmdCLEnterRoomOK& command,
+  SourceStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Read(command.roomUid)
+    .Read(command.oneTimePassword)
+    .Read(command.raceServerAddress)
+    .Read(command.raceServerPort)
+    .Read(command.member6);
+
+  command.raceServerAddress = ntohl(command.raceServerAddress);
 }
 
 void AcCmdCLEnterRoomCancel::Write(
@@ -740,10 +886,12 @@ void AcCmdCLRequestDailyQuestListOK::Read(
 }
 
 void AcCmdCLEnterRanch::Write(
-  const AcCmdCLEnterRanch&,
-  SinkStream&)
+  const AcCmdCLEnterRanch& command,
+  SinkStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Write(command.rancherUid)
+    .Write(command.unk1)
+    .Write(command.unk2);
 }
 
 void AcCmdCLEnterRanch::Read(
@@ -766,10 +914,15 @@ void AcCmdCLEnterRanchOK::Write(
 }
 
 void AcCmdCLEnterRanchOK::Read(
-  AcCmdCLEnterRanchOK&,
-  SourceStream&)
+  AcCmdCLEnterRanchOK& command,
+  SourceStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Read(command.rancherUid)
+    .Read(command.otp)
+    .Read(command.ranchAddress)
+    .Read(command.ranchPort);
+
+  command.ranchAddress = ntohl(command.ranchAddress);
 }
 
 void AcCmdCLEnterRanchCancel::Write(
@@ -904,7 +1057,7 @@ void AcCmdCLHeartbeat::Write(
   const AcCmdCLHeartbeat&,
   SinkStream&)
 {
-  throw std::runtime_error("Not implemented.");
+  // Empty.
 }
 
 void AcCmdCLHeartbeat::Read(
@@ -21,20 +21,31 @@
 #include "libserver/network/chatter/ChatterServer.hpp"
 
 #include "libserver/util/Stream.hpp"
+#include "libserver/util/StreamFields.hpp"
 
 #include <cassert>
 
 namespace server::protocol
 {
 
-void WritePlayerRacer(SinkStream& stream, const Avatar& playerRacer)
+namespace
 {
-  stream.Write(static_cast<uint8_t>(playerRacer.equipment.size()));
 
-  for (const Item& item : playerRacer.equipment)
-  {
-    stream.Write(item);
-  }
+using UserRaceUpdatePosFields = StreamFields<
+  STREAM_FIELD(AcCmdUserRaceUpdatePos, oid),
+  STREAM_FIELD(AcCmdUserRaceUpdatePos, position),
+  STREAM_FIELD(AcCmdUserRaceUpdatePos, member3),
+  STREAM_FIELD(AcCmdUserRaceUpdatePos, member4),
+  STREAM_FIELD(AcCmdUserRaceUpdatePos, member5),
+  STREAM_FIELD(AcCmdUserRaceUpdatePos, progress),
+  STREAM_FIELD(AcCmdUserRaceUpdatePos, member7)>;
+
+} // anon namespace
+
+void WritePlayerRacer(SinkStream& stream, const Avatar& playerRacer)
+{
+  stream.Write(static_cast<uint8_t>(playerRacer.equipment.size()))
+    .Write(std::span(playerRacer.equipment));
 
   stream.Write(playerRacer.character)
     .Write(playerRacer.mount)
@@ -97,10 +108,12 @@ void WriteRoomDescription(SinkStream& stream, const RoomDescription& roomDescrip
 }
 
 void AcCmdCREnterRoom::Write(
-  const AcCmdCREnterRoom&,
-  SinkStream&)
+  const AcCmdCREnterRoom& command,
+  SinkStream& stream)
 {
-  throw std::logic_error("Not implemented.");
+  stream.Write(command.characterUid)
+    .Write(command.oneTimePassword)
+    .Write(command.roomUid);
 }
 
 void AcCmdCREnterRoom::Read(
@@ -353,10 +366,14 @@ void AcCmdCRLeaveRoomNotify::Read(
 }
 
 void AcCmdCRStartRace::Write(
-  const AcCmdCRStartRace&,
-  SinkStream&)
+  const AcCmdCRStartRace& command,
+  SinkStream& stream)
 {
-  throw std::logic_error("Not implemented.");
+  stream.Write(static_cast<uint8_t>(command.unk0.size()));
+  for (const auto& element : command.unk0)
+  {
+    stream.Write(element);
+  }
 }
 
 void AcCmdCRStartRace::Read(
@@ -409,10 +426,37 @@ void AcCmdCRStartRaceNotify::RaceRecord::Write(
 }
 
 void AcCmdCRStartRaceNotify::RaceRecord::Read(
-  RaceRecord&,
-  SourceStream&)
+  RaceRecord& command,
+  SourceStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Read(command.mapBlockId)
+   .Read(command.gameMode)
+   .Read(command.teamMode)
+   .Read(command.finalRecordMs);
+
+  constexpr auto SectorsPerLap = 3u;
+
+  uint8_t sectorCount{};
+  stream.Read(sectorCount);
+  command.lapRecords.resize(sectorCount / SectorsPerLap);
+  for (auto& lapRecord : command.lapRecords)
+  {
+    stream.Read(lapRecord.sector1Ms)
+      .Read(lapRecord.sector2Ms)
+      .Read(lapRecord.sector3Ms);
+  }
+
+  if (command.teamMode == protocol::TeamMode::Single)
+  {
+    stream.Read(command.trainingRecord.totalNumberOfSpurs)
+      .Read(command.trainingRecord.maximumContinuousSpurs)
+      .Read(command.trainingRecord.numberOfPerfectSpurs)
+      .Read(command.trainingRecord.perfectJumpMaximumCombo)
+      .Read(command.trainingRecord.numberOfJumpObstacleCollisions)
+      .Read(command.trainingRecord.clearedDifficulty);
+  }
+
+  stream.Read(command.member13);
 }
 
 void AcCmdCRStartRaceNotify::Struct2::Write(
@@ -426,10 +470,13 @@ void AcCmdCRStartRaceNotify::Struct2::Write(
 }
 
 void AcCmdCRStartRaceNotify::Struct2::Read(
-  Struct2&,
-  SourceStream&)
+  Struct2& command,
+  SourceStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Read(command.unk0)
+    .Read(command.unk1)
+    .Read(command.unk2)
+    .Read(command.unk3);
 }
 
 void AcCmdCRStartRaceNotify::ActiveSkillSet::Write(
@@ -448,10 +495,21 @@ void AcCmdCRStartRaceNotify::ActiveSkillSet::Write(
 }
 
 void AcCmdCRStartRaceNotify::ActiveSkillSet::Read(
-  ActiveSkillSet&,
-  SourceStream&)
+  ActiveSkillSet& command,
+  SourceStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Read(command.setId)
+    .Read(command.unk1);
+
+  uint8_t size{};
+  stream.Read(size);
+  if (size > command.skills.size())
+    throw std::runtime_error("Active skill count is over the limit");
+
+  for (std::size_t idx = 0; idx < size; ++idx)
+  {
+    stream.Read(command.skills[idx]);
+  }
 }
 
 void AcCmdCRStartRaceNotify::Write(
@@ -507,10 +565,62 @@ void AcCmdCRStartRaceNotify::Write(
 }
 
 void AcCmdCRStartRaceNotify::Read(
-  AcCmdCRStartRaceNotify&,
-  SourceStream&)
+  AcCmdCRStartRaceNotify& command,
+  SourceStream& stream)
 {
-  throw std::logic_error("Not implemented.");
+  stream.Read(command.raceGameMode)
+    .Read(command.raceTeamMode)
+    .Read(command.hostOid)
+    .Read(command.member4)
+    .Read(command.raceMapBlockId);
+
+  uint8_t racerCount{};
+  stream.Read(racerCount);
+  command.racers.resize(racerCount);
+  for (auto& element : command.racers)
+  {
+    stream.Read(element.oid)
+      .Read(element.name)
+      .Read(element.unk2)
+      .Read(element.unk3)
+      .Read(element.p2dId)
+      .Read(element.teamColor)
+      .Read(element.unk6)
+      .Read(element.unk7);
+  }
+
+  stream.Read(command.p2pRelayAddress)
+    .Read(command.p2pRelayPort)
+    .Read(command.unk6)
+    .Read(command.raceRecord)
+    .Read(command.unk10);
+
+  command.p2pRelayAddress = boost::asio::detail::socket_ops::network_to_host_long(
+    command.p2pRelayAddress);
+
+  stream.Read(command.raceMissionId)
+    .Read(command.unk12)
+    .Read(command.racerActiveSkillSet);
+
+  stream.Read(command.isHorseInjuryEnabled)
+    .Read(command.carnivalType)
+    .Read(command.weatherType)
+    .Read(command.unk17);
+
+  uint8_t unk18Count{};
+  stream.Read(unk18Count);
+  command.unk18.resize(unk18Count);
+  for (auto& element : command.unk18)
+  {
+    uint8_t subElementCount{};
+    stream.Read(element.unk0)
+      .Read(subElementCount);
+    element.unk1.resize(subElementCount);
+    for (auto& subElement : element.unk1)
+    {
+      stream.Read(subElement);
+    }
+  }
 }
 
 void AcCmdCRStartRaceCancel::Write(
@@ -528,10 +638,10 @@ void AcCmdCRStartRaceCancel::Read(
 }
 
 void AcCmdUserRaceTimer::Write(
-  const AcCmdUserRaceTimer&,
-  SinkStream&)
+  const AcCmdUserRaceTimer& command,
+  SinkStream& stream)
 {
-  throw std::logic_error("Not implemented.");
+  stream.Write(command.clientClock);
 }
 
 void AcCmdUserRaceTimer::Read(
@@ -549,18 +659,26 @@ void AcCmdUserRaceTimerOK::Write(
     .Write(command.serverRaceClock);
 }
 
+std::size_t AcCmdUserRaceTimerOK::GetEncodedSize(
+  const AcCmdUserRaceTimerOK& command)
+{
+  return sizeof(command.clientRaceClock)
+    + sizeof(command.serverRaceClock);
+}
+
 void AcCmdUserRaceTimerOK::Read(
-  AcCmdUserRaceTimerOK&,
-  SourceStream&)
+  AcCmdUserRaceTimerOK& command,
+  SourceStream& stream)
 {
-  throw std::logic_error("Not implemented.");
+  stream.Read(command.clientRaceClock)
+    .Read(command.serverRaceClock);
 }
 
 void AcCmdCRLoadingComplete::Write(
   const AcCmdCRLoadingComplete&,
   SinkStream&)
 {
-  throw std::logic_error("Not implemented.");
+  // Empty.
 }
 
 void AcCmdCRLoadingComplete::Read(
@@ -619,7 +737,7 @@ void AcCmdCRReadyRace::Write(
   const AcCmdCRReadyRace&,
   SinkStream&)
 {
-  throw std::runtime_error("Not implemented");
+  // Empty.
 }
 
 void AcCmdCRReadyRace::Read(
@@ -638,10 +756,11 @@ void AcCmdCRReadyRaceNotify::Write(
 }
 
 void AcCmdCRReadyRaceNotify::Read(
-  AcCmdCRReadyRaceNotify&,
-  SourceStream&)
+  AcCmdCRReadyRaceNotify& command,
+  SourceStream& stream)
 {
-  throw std::runtime_error("Not implemented");
+  stream.Read(command.characterUid)
+    .Read(command.isReady);
 }
 
 void AcCmdUserRaceCountdown::Write(
@@ -1085,28 +1204,23 @@ void AcCmdCRRequestMagicItemNotify::Read(
 }
 
 void AcCmdUserRaceUpdatePos::Write(
-  const AcCmdUserRaceUpdatePos&,
-  SinkStream&)
+  const AcCmdUserRaceUpdatePos& command,
+  SinkStream& stream)
 {
-  throw std::runtime_error("Not implemented");
+  UserRaceUpdatePosFields::Write(command, stream);
+}
+
+std::size_t AcCmdUserRaceUpdatePos::GetEncodedSize(
+  const AcCmdUserRaceUpdatePos& command)
+{
+  return UserRaceUpdatePosFields::GetEncodedSize(command);
 }
 
 void AcCmdUserRaceUpdatePos::Read(
   AcCmdUserRaceUpdatePos& command,
   SourceStream& stream)
 {
-  stream.Read(command.oid)
-    .Read(command.position);
-
-  for (auto& element : command.member3)
-  {
-    stream.Read(element);
-  }
-
-  stream.Read(command.member4)
-    .Read(command.member5)
-    .Read(command.progress)
-    .Read(command.member7);
+  UserRaceUpdatePosFields::Read(command, stream);
 }
 
 void AcCmdRCRoomCountdown::Write(
@@ -1118,6 +1232,14 @@ void AcCmdRCRoomCountdown::Write(
     .Write(command.bonusCourseType);
 }
 
+std::size_t AcCmdRCRoomCountdown::GetEncodedSize(
+  const AcCmdRCRoomCountdown& command)
+{
+  return sizeof(command.countdown)
+    + sizeof(command.mapBlockId)
+    + sizeof(command.bonusCourseType);
+}
+
 void AcCmdRCRoomCountdown::Read(
   AcCmdRCRoomCountdown&,
   SourceStream&)
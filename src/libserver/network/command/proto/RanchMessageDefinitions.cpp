@@ -18,6 +18,7 @@
  **/
 
 #include "libserver/network/command/proto/RanchMessageDefinitions.hpp"
+#include "libserver/util/StreamFields.hpp"
 #include "libserver/util/Util.hpp"
 
 #include <cassert>
@@ -27,6 +28,45 @@
 namespace server::protocol
 {
 
+namespace
+{
+
+using FullSpatialFields = StreamFields<
+  STREAM_FIELD(AcCmdCRRanchSnapshot::FullSpatial, ranchIndex),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::FullSpatial, time),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::FullSpatial, action),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::FullSpatial, timer),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::FullSpatial, member4),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::FullSpatial, matrix),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::FullSpatial, velocityX),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::FullSpatial, velocityY),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::FullSpatial, velocityZ)>;
+
+using PartialSpatialFields = StreamFields<
+  STREAM_FIELD(AcCmdCRRanchSnapshot::PartialSpatial, ranchIndex),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::PartialSpatial, time),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::PartialSpatial, action),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::PartialSpatial, timer),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::PartialSpatial, member4),
+  STREAM_FIELD(AcCmdCRRanchSnapshot::PartialSpatial, matrix)>;
+
+//! Returns the size of the spatial of the snapshot type in the stream.
+//! The unknown types have no spatial, their writes fail.
+constexpr std::size_t GetSpatialSize(const AcCmdCRRanchSnapshot::Type type)
+{
+  switch (type)
+  {
+    case AcCmdCRRanchSnapshot::Full:
+      return FullSpatialFields::FixedSize;
+    case AcCmdCRRanchSnapshot::Partial:
+      return PartialSpatialFields::FixedSize;
+    default:
+      return 0;
+  }
+}
+
+} // anon namespace
+
 void AcCmdCRUseItem::Write(
   const AcCmdCRUseItem&,
   SinkStream&)
@@ -137,10 +177,12 @@ void AcCmdCRMountFamilyTreeCancel::Read(
 }
 
 void AcCmdCREnterRanch::Write(
-  const AcCmdCREnterRanch&,
-  SinkStream&)
+  const AcCmdCREnterRanch& command,
+  SinkStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Write(command.characterUid)
+    .Write(command.otp)
+    .Write(command.rancherUid);
 }
 
 void AcCmdCREnterRanch::Read(
@@ -214,10 +256,57 @@ void AcCmdCREnterRanchOK::Write(
 }
 
 void AcCmdCREnterRanchOK::Read(
-  AcCmdCREnterRanchOK&,
-  SourceStream&)
+  AcCmdCREnterRanchOK& command,
+  SourceStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Read(command.rancherUid)
+    .Read(command.rancherName)
+    .Read(command.ranchName);
+
+  // Read the ranch horses
+  uint8_t ranchHorseCount{};
+  stream.Read(ranchHorseCount);
+  command.horses.resize(ranchHorseCount);
+  for (auto& horse : command.horses)
+  {
+    stream.Read(horse);
+  }
+
+  // Read the ranch characters
+  uint8_t ranchCharacterCount{};
+  stream.Read(ranchCharacterCount);
+  command.characters.resize(ranchCharacterCount);
+  for (auto& character : command.characters)
+  {
+    stream.Read(character);
+  }
+
+  stream.Read(command.member6)
+    .Read(command.scramblingConstant)
+    .Read(command.ranchProgress);
+
+  // Read the ranch housing
+  uint8_t housingCount{};
+  stream.Read(housingCount);
+  command.housing.resize(housingCount);
+  for (auto& housing : command.housing)
+  {
+    stream.Read(housing);
+  }
+
+  stream.Read(command.horseSlots)
+    .Read(command.member11)
+    .Read(command.bitset)
+    .Read(command.incubatorSlots)
+    .Read(command.incubatorUseCount);
+
+  for (auto& egg : command.incubator)
+  {
+    stream.Read(egg);
+  }
+
+  stream.Read(command.league)
+    .Read(command.member17);
 }
 
 void RanchCommandEnterRanchCancel::Write(
@@ -252,95 +341,62 @@ void AcCmdCRRanchSnapshot::FullSpatial::Write(
   const FullSpatial& structure,
   SinkStream& stream)
 {
-  stream.Write(structure.ranchIndex)
-    .Write(structure.time)
-    .Write(structure.action)
-    .Write(structure.timer);
-
-  for (const auto& byte : structure.member4)
-  {
-    stream.Write(byte);
-  }
-
-  for (const auto& byte : structure.matrix)
-  {
-    stream.Write(byte);
-  }
-
-  stream.Write(structure.velocityX)
-    .Write(structure.velocityY)
-    .Write(structure.velocityZ);
+  FullSpatialFields::Write(structure, stream);
 }
 
 void AcCmdCRRanchSnapshot::FullSpatial::Read(
   FullSpatial& structure,
   SourceStream& stream)
 {
-  stream.Read(structure.ranchIndex)
-    .Read(structure.time)
-    .Read(structure.action)
-    .Read(structure.timer);
-
-  for (auto& byte : structure.member4)
-  {
-    stream.Read(byte);
-  }
-
-  for (auto& byte : structure.matrix)
-  {
-    stream.Read(byte);
-  }
-
-  stream.Read(structure.velocityX)
-    .Read(structure.velocityY)
-    .Read(structure.velocityZ);
+  FullSpatialFields::Read(structure, stream);
 }
 
 void AcCmdCRRanchSnapshot::PartialSpatial::Write(
   const PartialSpatial& structure,
   SinkStream& stream)
 {
-  stream.Write(structure.ranchIndex)
-    .Write(structure.time)
-    .Write(structure.action)
-    .Write(structure.timer);
-
-  for (const auto& byte : structure.member4)
-  {
-    stream.Write(byte);
-  }
-
-  for (const auto& byte : structure.matrix)
-  {
-    stream.Write(byte);
-  }
+  PartialSpatialFields::Write(structure, stream);
 }
 
 void AcCmdCRRanchSnapshot::PartialSpatial::Read(
   PartialSpatial& structure,
   SourceStream& stream)
 {
-  stream.Read(structure.ranchIndex)
-    .Read(structure.time)
-    .Read(structure.action)
-    .Read(structure.timer);
+  PartialSpatialFields::Read(structure, stream);
+}
 
-  for (auto& byte : structure.member4)
-  {
-    stream.Read(byte);
-  }
+void AcCmdCRRanchSnapshot::Write(
+  const AcCmdCRRanchSnapshot& command,
+  SinkStream& stream)
+{
+  stream.Write(command.type);
 
-  for (auto& byte : structure.matrix)
+  switch (command.type)
   {
-    stream.Read(byte);
+    case Full:
+      {
+        stream.Write(command.full);
+        break;
+      }
+    case Partial:
+      {
+        stream.Write(command.partial);
+        break;
+      }
+    default:
+      {
+        throw std::runtime_error(
+          std::format(
+            "Update type {} not implemented",
+            static_cast<uint32_t>(command.type)));
+      }
   }
 }
 
-void AcCmdCRRanchSnapshot::Write(
-  const AcCmdCRRanchSnapshot&,
-  SinkStream&)
+std::size_t AcCmdCRRanchSnapshot::GetEncodedSize(
+  const AcCmdCRRanchSnapshot& command)
 {
-  throw std::runtime_error("Not implemented.");
+  return sizeof(command.type) + GetSpatialSize(command.type);
 }
 
 void AcCmdCRRanchSnapshot::Read(
@@ -398,11 +454,39 @@ void RanchCommandRanchSnapshotNotify::Write(
   }
 }
 
+std::size_t RanchCommandRanchSnapshotNotify::GetEncodedSize(
+  const RanchCommandRanchSnapshotNotify& command)
+{
+  return sizeof(command.ranchIndex)
+    + sizeof(command.type)
+    + GetSpatialSize(command.type);
+}
+
 void RanchCommandRanchSnapshotNotify::Read(
-  RanchCommandRanchSnapshotNotify&,
-  SourceStream&)
+  RanchCommandRanchSnapshotNotify& command,
+  SourceStream& stream)
 {
-  throw std::runtime_error("Not implemented.");
+  stream.Read(command.ranchIndex)
+    .Read(command.type);
+
+  switch (command.type)
+  {
+    case AcCmdCRRanchSnapshot::Full:
+      {
+        stream.Read(command.full);
+        break;
+      }
+    case AcCmdCRRanchSnapshot::Partial:
+      {
+        stream.Read(command.partial);
+        break;
+      }
+    default:
+      {
+        throw std::runtime_error(
+          std::format("Update type {} not implemented", static_cast<uint32_t>(command.type)));
+      }
+  }
 }
 
 void AcCmdCRRanchCmdAction::Write(
@@ -1273,11 +1357,8 @@ void AcCmdCRGetItemFromStorageOK::Write(
   SinkStream& stream)
 {
   stream.Write(command.storageItemUid);
-  stream.Write(static_cast<uint8_t>(command.items.size()));
-  for (const auto& item : command.items)
-  {
-    stream.Write(item);
-  }
+  stream.Write(static_cast<uint8_t>(command.items.size()))
+    .Write(std::span(command.items));
   stream.Write(command.updatedCarrots);
 }
 
@@ -1336,11 +1417,8 @@ void RanchCommandRequestNpcDressListOK::Write(
   SinkStream& stream)
 {
   stream.Write(command.unk0);
-  stream.Write(static_cast<uint8_t>(command.dressList.size()));
-  for (const auto& item : command.dressList)
-  {
-    stream.Write(item);
-  }
+  stream.Write(static_cast<uint8_t>(command.dressList.size()))
+    .Write(std::span(command.dressList));
 }
 
 void RanchCommandRequestNpcDressListOK::Read(
@@ -1491,17 +1569,11 @@ void AcCmdCRUpdateEquipmentNotify::Write(
 {
   stream.Write(command.characterUid);
 
-  stream.Write(static_cast<uint8_t>(command.characterEquipment.size()));
-  for (const auto& item : command.characterEquipment)
-  {
-    stream.Write(item);
-  }
+  stream.Write(static_cast<uint8_t>(command.characterEquipment.size()))
+    .Write(std::span(command.characterEquipment));
 
-  stream.Write(static_cast<uint8_t>(command.mountEquipment.size()));
-  for (const auto& item : command.mountEquipment)
-  {
-    stream.Write(item);
-  }
+  stream.Write(static_cast<uint8_t>(command.mountEquipment.size()))
+    .Write(std::span(command.mountEquipment));
 
   stream.Write(command.mount);
 }
@@ -0,0 +1,385 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/util/Executor.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace server
+{
+
+namespace
+{
+
+//! Max count of the tasks of a strand executed before the other tasks get a turn.
+constexpr std::size_t StrandBatchSize = 64;
+
+//! The executor of the current worker thread.
+thread_local const Executor* currentExecutor = nullptr;
+//! The index of the current worker thread.
+thread_local std::size_t currentWorkerIdx = 0;
+
+//! Orders the timed tasks so that the heap is a min-heap.
+constexpr auto TimedTaskOrder = [](const auto& lhs, const auto& rhs)
+{
+  return lhs.when > rhs.when;
+};
+
+} // anon namespace
+
+//! A worker thread and its queue of tasks.
+struct Executor::Worker
+{
+  //! A mutex to the queue of the tasks.
+  std::mutex tasksMutex;
+  //! A queue of the tasks, the owner takes them from the front
+  //! and the other workers steal them from the back.
+  std::deque<Task> tasks;
+  //! A thread of the worker.
+  std::thread thread;
+};
+
+struct Executor::Strand::State
+{
+  explicit State(Executor& executor)
+    : executor(executor)
+  {
+  }
+
+  Executor& executor;
+  //! A mutex to the queued tasks.
+  std::mutex tasksMutex;
+  //! Queued tasks.
+  std::deque<Task> tasks;
+  //! Whether a drain of the strand is posted to the executor.
+  bool isScheduled{false};
+};
+
+Executor::Strand::Strand(Executor& executor)
+  : _state(std::make_shared<State>(executor))
+{
+}
+
+void Executor::Strand::Post(Task task)
+{
+  Enqueue(_state, std::move(task));
+}
+
+void Executor::Strand::PostAt(Task task, const Clock::time_point when)
+{
+  _state->executor.PostAt(
+    [state = _state, task = std::move(task)]() mutable
+    {
+      Enqueue(state, std::move(task));
+    },
+    when);
+}
+
+void Executor::Strand::Enqueue(const std::shared_ptr<State>& state, Task task)
+{
+  bool shouldSchedule = false;
+  {
+    std::scoped_lock lock(state->tasksMutex);
+    state->tasks.emplace_back(std::move(task));
+    shouldSchedule = not std::exchange(state->isScheduled, true);
+  }
+
+  if (shouldSchedule)
+  {
+    state->executor.Post([state]()
+    {
+      Drain(state);
+    });
+  }
+}
+
+void Executor::Strand::Drain(const std::shared_ptr<State>& state)
+{
+  for (std::size_t taskIdx = 0; taskIdx < StrandBatchSize; ++taskIdx)
+  {
+    Task task;
+    {
+      std::scoped_lock lock(state->tasksMutex);
+      if (state->tasks.empty())
+      {
+        state->isScheduled = false;
+        return;
+      }
+
+      task = std::move(state->tasks.front());
+      state->tasks.pop_front();
+    }
+
+    try
+    {
+      task();
+    }
+    catch (const std::exception& x)
+    {
+      spdlog::error("Unhandled exception executing a strand task: {}", x.what());
+    }
+  }
+
+  // Let the other tasks execute before the remaining tasks of the strand.
+  {
+    std::scoped_lock lock(state->tasksMutex);
+    if (state->tasks.empty())
+    {
+      state->isScheduled = false;
+      return;
+    }
+  }
+
+  state->executor.Post([state]()
+  {
+    Drain(state);
+  });
+}
+
+Executor::Executor() = default;
+
+Executor::~Executor()
+{
+  End();
+}
+
+void Executor::Begin(uint32_t threadCount)
+{
+  if (_isRunning.load())
+    throw std::runtime_error("Executor is already running");
+
+  if (threadCount == 0)
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+  // The workers are created before the threads start, as the threads steal from each other.
+  _workers.clear();
+  _queuedTaskCount = 0;
+  for (uint32_t workerIdx = 0; workerIdx < threadCount; ++workerIdx)
+    _workers.emplace_back(std::make_unique<Worker>());
+
+  _isRunning.store(true, std::memory_order::release);
+
+  for (std::size_t workerIdx = 0; workerIdx < _workers.size(); ++workerIdx)
+  {
+    _workers[workerIdx]->thread = std::thread([this, workerIdx]()
+    {
+      RunWorker(workerIdx);
+    });
+  }
+}
+
+void Executor::End()
+{
+  if (not _isRunning.exchange(false))
+    return;
+
+  {
+    std::scoped_lock lock(_idleMutex);
+  }
+  _idleCv.notify_all();
+
+  for (const auto& worker : _workers)
+  {
+    if (worker->thread.joinable())
+      worker->thread.join();
+  }
+
+  // The workers are kept until the executor begins again or is destroyed,
+  // as tasks might still be posted to them.
+  {
+    std::scoped_lock lock(_idleMutex);
+    _timedTasks.clear();
+    _nextTimedTaskTime.store(Clock::time_point::max().time_since_epoch().count());
+  }
+}
+
+void Executor::Post(Task task)
+{
+  if (not _isRunning.load(std::memory_order::acquire))
+    return;
+
+  // Tasks posted by the workers stay with them, the others are spread over the workers.
+  const std::size_t workerIdx = currentExecutor == this
+    ? currentWorkerIdx
+    : _nextWorkerIdx.fetch_add(1, std::memory_order::relaxed) % _workers.size();
+
+  Push(workerIdx, std::move(task));
+}
+
+void Executor::PostAt(Task task, const Clock::time_point when)
+{
+  if (not _isRunning.load(std::memory_order::acquire))
+    return;
+
+  bool isEarliest = false;
+  {
+    std::scoped_lock lock(_idleMutex);
+    _timedTasks.emplace_back(TimedTask{
+      .when = when,
+      .task = std::move(task)});
+    std::ranges::push_heap(_timedTasks, TimedTaskOrder);
+
+    isEarliest = _timedTasks.front().when == when;
+    _nextTimedTaskTime.store(_timedTasks.front().when.time_since_epoch().count());
+  }
+
+  // The worker waiting for the timed tasks has to wait for the new earliest one.
+  if (isEarliest)
+    _idleCv.notify_all();
+}
+
+std::size_t Executor::GetThreadCount() const noexcept
+{
+  return _workers.size();
+}
+
+void Executor::RunWorker(const std::size_t workerIdx)
+{
+  currentExecutor = this;
+  currentWorkerIdx = workerIdx;
+
+  while (_isRunning.load(std::memory_order::relaxed))
+  {
+    if (Clock::now().time_since_epoch().count() >= _nextTimedTaskTime.load(std::memory_order::relaxed))
+      PostDueTasks(workerIdx);
+
+    Task task;
+    if (TakeTask(workerIdx, task))
+    {
+      try
+      {
+        task();
+      }
+      catch (const std::exception& x)
+      {
+        spdlog::error("Unhandled exception executing a task: {}", x.what());
+      }
+
+      continue;
+    }
+
+    // Sleep until there are tasks to take. A single worker waits
+    // for the earliest timed task, the others sleep until woken up.
+    std::unique_lock lock(_idleMutex);
+    _sleepingWorkerCount.fetch_add(1);
+
+    while (_isRunning.load(std::memory_order::relaxed) && _queuedTaskCount.load() == 0)
+    {
+      if (not _timedTasks.empty() && _timedTasks.front().when <= Clock::now())
+        break;
+
+      if (_timedTasks.empty() || _hasTimerWaiter)
+      {
+        _idleCv.wait(lock);
+        continue;
+      }
+
+      _hasTimerWaiter = true;
+      _idleCv.wait_until(lock, _timedTasks.front().when);
+      _hasTimerWaiter = false;
+    }
+
+    _sleepingWorkerCount.fetch_sub(1);
+  }
+
+  currentExecutor = nullptr;
+}
+
+bool Executor::TakeTask(const std::size_t workerIdx, Task& task)
+{
+  if (_queuedTaskCount.load() == 0)
+    return false;
+
+  // Take the oldest task of the worker first.
+  {
+    auto& worker = *_workers[workerIdx];
+    std::scoped_lock lock(worker.tasksMutex);
+    if (not worker.tasks.empty())
+    {
+      task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+      _queuedTaskCount.fetch_sub(1);
+      return true;
+    }
+  }
+
+  // Steal the newest task of the other workers.
+  for (std::size_t offset = 1; offset < _workers.size(); ++offset)
+  {
+    auto& victim = *_workers[(workerIdx + offset) % _workers.size()];
+    std::scoped_lock lock(victim.tasksMutex);
+    if (victim.tasks.empty())
+      continue;
+
+    task = std::move(victim.tasks.back());
+    victim.tasks.pop_back();
+    _queuedTaskCount.fetch_sub(1);
+    return true;
+  }
+
+  return false;
+}
+
+void Executor::PostDueTasks(const std::size_t workerIdx)
+{
+  std::vector<Task> dueTasks;
+  {
+    std::scoped_lock lock(_idleMutex);
+    const auto now = Clock::now();
+    while (not _timedTasks.empty() && _timedTasks.front().when <= now)
+    {
+      std::ranges::pop_heap(_timedTasks, TimedTaskOrder);
+      dueTasks.emplace_back(std::move(_timedTasks.back().task));
+      _timedTasks.pop_back();
+    }
+
+    _nextTimedTaskTime.store(_timedTasks.empty()
+      ? Clock::time_point::max().time_since_epoch().count()
+      : _timedTasks.front().when.time_since_epoch().count());
+  }
+
+  for (auto& task : dueTasks)
+    Push(workerIdx, std::move(task));
+}
+
+void Executor::Push(const std::size_t workerIdx, Task task)
+{
+  {
+    auto& worker = *_workers[workerIdx];
+    std::scoped_lock lock(worker.tasksMutex);
+    worker.tasks.emplace_back(std::move(task));
+  }
+
+  // The sleeping workers count themselves before checking for the queued tasks,
+  // so either they see the task or the task sees them.
+  _queuedTaskCount.fetch_add(1);
+  if (_sleepingWorkerCount.load() == 0)
+    return;
+
+  {
+    std::scoped_lock lock(_idleMutex);
+  }
+  _idleCv.notify_one();
+}
+
+} // namespace server
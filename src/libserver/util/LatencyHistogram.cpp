@@ -0,0 +1,97 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/util/LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace server
+{
+
+void LatencyHistogram::Record(const Duration duration) noexcept
+{
+  const auto nanoseconds = static_cast<uint64_t>(
+    std::max(duration.count(), Duration::rep{0}));
+
+  // Bucket 0 holds samples shorter than 1us,
+  // bucket N holds samples from 2^(N-1)us up to 2^N us.
+  const auto bucketIdx = std::min<std::size_t>(
+    std::bit_width(nanoseconds / 1000),
+    BucketCount - 1);
+
+  _buckets[bucketIdx].fetch_add(1, std::memory_order::relaxed);
+  _count.fetch_add(1, std::memory_order::relaxed);
+  _total.fetch_add(nanoseconds, std::memory_order::relaxed);
+
+  uint64_t max = _max.load(std::memory_order::relaxed);
+  while (nanoseconds > max
+    && not _max.compare_exchange_weak(max, nanoseconds, std::memory_order::relaxed))
+  {
+  }
+}
+
+LatencyHistogram::Summary LatencyHistogram::Summarize() const noexcept
+{
+  Summary summary{
+    .count = _count.load(std::memory_order::relaxed),
+    .total = Duration(_total.load(std::memory_order::relaxed)),
+    .max = Duration(_max.load(std::memory_order::relaxed))};
+
+  summary.p50 = std::min(GetPercentile(summary.count, 50), summary.max);
+  summary.p99 = std::min(GetPercentile(summary.count, 99), summary.max);
+
+  return summary;
+}
+
+void LatencyHistogram::Reset() noexcept
+{
+  for (auto& bucket : _buckets)
+    bucket.store(0, std::memory_order::relaxed);
+
+  _count.store(0, std::memory_order::relaxed);
+  _total.store(0, std::memory_order::relaxed);
+  _max.store(0, std::memory_order::relaxed);
+}
+
+LatencyHistogram::Duration LatencyHistogram::GetPercentile(
+  const uint64_t count,
+  const uint64_t percentile) const noexcept
+{
+  if (count == 0)
+    return Duration::zero();
+
+  // Rank of the sample at the percentile.
+  const uint64_t rank = std::max<uint64_t>((count * percentile + 99) / 100, 1);
+
+  uint64_t cumulativeCount = 0;
+  for (std::size_t bucketIdx = 0; bucketIdx < BucketCount; ++bucketIdx)
+  {
+    cumulativeCount += _buckets[bucketIdx].load(std::memory_order::relaxed);
+    if (cumulativeCount >= rank)
+    {
+      // Upper bound of the bucket.
+      return std::chrono::microseconds(uint64_t{1} << bucketIdx);
+    }
+  }
+
+  return Duration::max();
+}
+
+} // namespace server
@@ -13,9 +13,18 @@
 #include <unicode/uregex.h>
 #endif
 
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <format>
+#include <functional>
 #include <stdexcept>
 
+#if defined(__x86_64__) || defined(_M_X64)
+  #define LOCALE_X86_64
+  #include <emmintrin.h>
+#endif
+
 #include <spdlog/spdlog.h>
 
 namespace server
@@ -37,9 +46,77 @@ constexpr std::u16string_view KoreanLettersPattern = u"[가-힣]";
 constexpr std::u16string_view LatinLettersPattern = u"[A-Za-z0-9()\\[\\]{}]";
 constexpr std::u16string_view ValidLettersPattern = u"[^가-힣A-Za-z0-9()\\[\\]{}]";
 
-} // anon namespace
+//! A direct-mapped cache of the recent conversions.
+//! The same names are converted over and over when they are broadcast
+//! in the room lists, the guild lists and the chat, the cache spares the
+//! conversions through ICU for them.
+class ConversionCache
+{
+public:
+  //! Returns the cached conversion of the input.
+  //! @param input Input string.
+  //! @returns Pointer to the output string if the conversion is cached, otherwise `nullptr`.
+  [[nodiscard]] const std::string* Find(const std::string& input) const
+  {
+    if (input.length() > MaxInputLength)
+      return nullptr;
 
-std::string ToUtf8(const std::string& input)
+    const auto& slot = _slots[GetSlotIndex(input)];
+    if (not slot.isOccupied || slot.input != input)
+      return nullptr;
+
+    return &slot.output;
+  }
+
+  //! Caches the conversion of the input, replacing the conversion occupying its slot.
+  //! @param input Input string.
+  //! @param output Output string.
+  void Store(const std::string& input, const std::string& output)
+  {
+    if (input.length() > MaxInputLength)
+      return;
+
+    auto& slot = _slots[GetSlotIndex(input)];
+    slot.input = input;
+    slot.output = output;
+    slot.isOccupied = true;
+  }
+
+private:
+  //! Count of the slots, must be a power of two.
+  static constexpr std::size_t SlotCount = 256;
+  //! Max length of the cached inputs. Longer strings, like chat messages, rarely repeat.
+  static constexpr std::size_t MaxInputLength = 64;
+
+  struct Slot
+  {
+    std::string input;
+    std::string output;
+    bool isOccupied{false};
+  };
+
+  [[nodiscard]] static std::size_t GetSlotIndex(const std::string& input) noexcept
+  {
+    return std::hash<std::string_view>{}(input) & (SlotCount - 1);
+  }
+
+  std::array<Slot, SlotCount> _slots{};
+};
+
+//! Returns the mask of the bytes of the word which are either not ASCII or null.
+//! The mask has the high bit set for such bytes.
+[[nodiscard]] constexpr uint64_t GetNonPlainAsciiMask(const uint64_t word) noexcept
+{
+  constexpr uint64_t LowBits = 0x0101010101010101ull;
+  constexpr uint64_t HighBits = 0x8080808080808080ull;
+
+  // The bytes with the high bit set are not ASCII, the classic zero byte test
+  // finds the null bytes among the remaining ones.
+  return (word | ((word - LowBits) & ~word)) & HighBits;
+}
+
+//! Converts EUC-KR encoded string into a UTF-8 encoded string with ICU.
+std::string ConvertToUtf8(const std::string& input)
 {
   std::string output;
 
@@ -92,7 +169,8 @@ std::string ToUtf8(const std::string& input)
   return {output.data()};
 }
 
-std::string FromUtf8(const std::string& input)
+//! Converts UTF-8 encoded string into a EUC-KR encoded string with ICU.
+std::string ConvertFromUtf8(const std::string& input)
 {
   std::string output;
 
@@ -145,6 +223,70 @@ std::string FromUtf8(const std::string& input)
   return {output.data()};
 }
 
+} // anon namespace
+
+bool IsPlainAscii(const std::string_view input) noexcept
+{
+  const auto* data = reinterpret_cast<const uint8_t*>(input.data());
+  const std::size_t size = input.size();
+  std::size_t idx = 0;
+
+#ifdef LOCALE_X86_64
+  const __m128i zero = _mm_setzero_si128();
+  for (; idx + 16 <= size; idx += 16)
+  {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + idx));
+    const int nonAscii = _mm_movemask_epi8(chunk);
+    const int null = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero));
+    if ((nonAscii | null) != 0)
+      return false;
+  }
+#endif
+
+  for (; idx + sizeof(uint64_t) <= size; idx += sizeof(uint64_t))
+  {
+    uint64_t word;
+    std::memcpy(&word, data + idx, sizeof(word));
+    if (GetNonPlainAsciiMask(word) != 0)
+      return false;
+  }
+
+  for (; idx < size; ++idx)
+  {
+    if (data[idx] == 0 || data[idx] >= 0x80)
+      return false;
+  }
+
+  return true;
+}
+
+std::string ToUtf8(const std::string& input)
+{
+  if (IsPlainAscii(input))
+    return input;
+
+  thread_local ConversionCache cache;
+  if (const auto* cached = cache.Find(input))
+    return *cached;
+
+  std::string output = ConvertToUtf8(input);
+  cache.Store(input, output);
+  return output;
+}
+
+std::string FromUtf8(const std::string& input)
+{
+  if (IsPlainAscii(input))
+    return input;
+
+  thread_local ConversionCache cache;
+  if (const auto* cached = cache.Find(input))
+    return *cached;
+
+  std::string output = ConvertFromUtf8(input);
+  cache.Store(input, output);
+  return output;
+}
 
 bool IsNameValid(
   const std::string& input,
@@ -18,65 +18,289 @@
  **/
 
 #include "libserver/util/Scheduler.hpp"
+#include "libserver/util/TickProfile.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#include <spdlog/spdlog.h>
 
 namespace server
 {
 
+bool Scheduler::JobHandle::Cancel()
+{
+  const auto job = _job.lock();
+  if (not job)
+    return false;
+
+  auto expected = Job::State::Pending;
+  return job->state.compare_exchange_strong(expected, Job::State::Cancelled);
+}
+
+Scheduler::JobHandle::JobHandle(std::weak_ptr<Job> job)
+  : _job(std::move(job))
+{
+}
+
 Scheduler::Scheduler()
+  : _epoch(Clock::now())
 {
-  _jobIterator = _jobs.cend();
 }
 
 void Scheduler::Tick()
 {
-  // Make sure there is jobs to execute.
-  if (_jobs.empty())
-    return;
+  const auto tickStart = Clock::now();
 
-  // If the job iterator is at the end cycle it back to the front,
-  // since the job list is not empty.
-  if (_jobIterator == _jobs.cend())
+  // The ready jobs are taken out, so the jobs queued while ticking
+  // execute in the next tick and jobs re-queueing themselves can not stall the tick.
+  std::deque<JobPtr> jobs;
+  Clock::duration tickBudget{};
   {
-    _jobIterator = _jobs.begin();
+    std::scoped_lock lock(_jobsMutex);
+
+    std::vector<JobPtr> dueJobs;
+    AdvanceWheels((tickStart - _epoch) / Resolution, dueJobs);
+
+    // The jobs of a slot are not ordered and the jobs of several slots
+    // might have become due, execute them in the order of their time points.
+    std::ranges::sort(dueJobs, [](const JobPtr& lhs, const JobPtr& rhs)
+    {
+      if (lhs->when != rhs->when)
+        return lhs->when < rhs->when;
+      return lhs->sequence < rhs->sequence;
+    });
+
+    jobs.swap(_readyJobs);
+    std::ranges::move(dueJobs, std::back_inserter(jobs));
+    tickBudget = _tickBudget;
   }
 
-  // Iterate over the jobs until you find one that can be executed,
-  // execute it and remove it from the job list.
-  while (true)
+  const bool isProfiled = TickProfile::IsActive();
+
+  bool hasExecuted = false;
+  auto jobIter = jobs.begin();
+  for (; jobIter != jobs.end(); ++jobIter)
   {
-    const auto& job = *_jobIterator;
-    if (Clock::now() >= job.when)
+    if (hasExecuted
+      && tickBudget != Clock::duration::zero()
+      && Clock::now() - tickStart >= tickBudget)
     {
-      try
-      {
-        job.task();
-        _jobIterator = _jobs.erase(_jobIterator);
-      }
-      catch (const std::exception& x)
-      {
-        // Executing task for job threw an error, erase the job
-        // and move onto the next one
-        _jobIterator = _jobs.erase(_jobIterator);
-        throw std::runtime_error(std::format("{}", x.what()));
-      }
-
       break;
     }
 
-    if (++_jobIterator == _jobs.cend())
-      break;
+    auto& job = **jobIter;
+
+    // Skip the cancelled jobs.
+    auto expected = Job::State::Pending;
+    if (not job.state.compare_exchange_strong(expected, Job::State::Executed))
+      continue;
+
+    hasExecuted = true;
+    const auto jobStart = isProfiled ? Clock::now() : Clock::time_point{};
+    try
+    {
+      job.task();
+    }
+    catch (const std::exception& x)
+    {
+      // A failing job does not prevent the other due jobs from executing.
+      spdlog::error("Exception executing a scheduled job: {}", x.what());
+    }
+
+    if (isProfiled)
+      TickProfile::Record("job", job.task.target_type(), Clock::now() - jobStart);
+
+    // Release the resources held by the task, the handles might outlive the job.
+    job.task = nullptr;
   }
+
+  if (jobIter == jobs.end())
+    return;
+
+  // The jobs beyond the budget execute first in the next tick.
+  std::scoped_lock lock(_jobsMutex);
+  _readyJobs.insert(
+    _readyJobs.begin(),
+    std::make_move_iterator(jobIter),
+    std::make_move_iterator(jobs.end()));
 }
 
-void Scheduler::Queue(
-  const Task& task,
+Scheduler::JobHandle Scheduler::Queue(
+  Task task,
   const Clock::time_point when)
+{
+  auto job = std::make_shared<Job>();
+  job->when = when;
+  job->task = std::move(task);
+
+  JobHandle handle(job);
+
+  // The wake handler is called outside of the lock, it might tick the scheduler right away.
+  std::shared_ptr<const WakeHandler> wakeHandler;
+  {
+    std::scoped_lock lock(_jobsMutex);
+    job->sequence = _nextSequence++;
+    job->expiry = GetWheelTick(when);
+
+    // The delayed jobs are left to the next ticks, unless due before the owner
+    // expects to tick the scheduler.
+    if (when > Clock::now() && job->expiry > _currentTick)
+    {
+      InsertJob(std::move(job), _currentTick + 1);
+      ++_wheelJobCount;
+
+      if (when >= _wakeDeadline)
+        return handle;
+      _wakeDeadline = when;
+    }
+    else
+    {
+      _readyJobs.emplace_back(std::move(job));
+    }
+
+    wakeHandler = _wakeHandler;
+  }
+
+  if (wakeHandler && *wakeHandler)
+    (*wakeHandler)();
+
+  return handle;
+}
+
+void Scheduler::SetWakeHandler(WakeHandler wakeHandler)
+{
+  auto sharedWakeHandler = std::make_shared<const WakeHandler>(std::move(wakeHandler));
+
+  std::scoped_lock lock(_jobsMutex);
+  _wakeHandler = std::move(sharedWakeHandler);
+}
+
+void Scheduler::SetTickBudget(const Clock::duration budget)
+{
+  std::scoped_lock lock(_jobsMutex);
+  _tickBudget = std::max(budget, Clock::duration::zero());
+}
+
+std::size_t Scheduler::GetJobCount() const
+{
+  std::scoped_lock lock(_jobsMutex);
+  return _wheelJobCount + _readyJobs.size();
+}
+
+Scheduler::Clock::time_point Scheduler::GetNextDueTime()
 {
   std::scoped_lock lock(_jobsMutex);
-  _jobs.emplace_back(Job{
-    .when = when,
-    .task = task});
+
+  if (not _readyJobs.empty())
+  {
+    _wakeDeadline = Clock::time_point::min();
+  }
+  else
+  {
+    const uint64_t nextTick = GetNextWheelTick();
+    _wakeDeadline = nextTick == std::numeric_limits<uint64_t>::max()
+      ? Clock::time_point::max()
+      : _epoch + Resolution * static_cast<Clock::rep>(nextTick);
+  }
+
+  return _wakeDeadline;
 }
 
+uint64_t Scheduler::GetWheelTick(const Clock::time_point when) const
+{
+  if (when <= _epoch)
+    return 0;
+
+  // Rounded up, so that the jobs never execute before their time point.
+  return (when - _epoch + Resolution - Clock::duration(1)) / Resolution;
+}
+
+void Scheduler::InsertJob(JobPtr job, const uint64_t reference)
+{
+  // The job goes to the first wheel whose current revolution contains its expiry,
+  // the slot of the expiry is then ahead of the slot of the reference in that wheel.
+  for (uint32_t wheelIdx = 0; wheelIdx < WheelCount; ++wheelIdx)
+  {
+    const uint32_t revolutionShift = WheelBits * (wheelIdx + 1);
+    if (job->expiry >> revolutionShift != reference >> revolutionShift)
+      continue;
+
+    const auto slotIdx = job->expiry >> (WheelBits * wheelIdx) & (WheelSize - 1);
+    _wheels[wheelIdx][slotIdx].emplace_back(std::move(job));
+    return;
+  }
+
+  _overflow.emplace_back(std::move(job));
+}
+
+uint64_t Scheduler::GetNextWheelTick() const
+{
+  // The slots ahead of the current tick in the current revolution of each wheel
+  // are searched, the first occupied one begins with the earliest jobs. The jobs of the slots
+  // of the next wheels are spread over the whole slot, the slot begins before them.
+  for (uint32_t wheelIdx = 0; wheelIdx < WheelCount; ++wheelIdx)
+  {
+    const uint32_t slotShift = WheelBits * wheelIdx;
+    const uint64_t currentSlot = _currentTick >> slotShift;
+    const uint64_t revolutionEnd = (currentSlot | (WheelSize - 1)) + 1;
+
+    for (uint64_t slot = currentSlot + 1; slot < revolutionEnd; ++slot)
+    {
+      if (not _wheels[wheelIdx][slot & (WheelSize - 1)].empty())
+        return slot << slotShift;
+    }
+  }
+
+  if (_overflow.empty())
+    return std::numeric_limits<uint64_t>::max();
+
+  // The overflow is cascaded at the end of the revolution of the last wheel.
+  const uint32_t revolutionShift = WheelBits * WheelCount;
+  return ((_currentTick >> revolutionShift) + 1) << revolutionShift;
+}
+
+void Scheduler::AdvanceWheels(const uint64_t tick, std::vector<JobPtr>& due)
+{
+  while (_currentTick < tick)
+  {
+    // Skip the ticks of the empty wheels.
+    if (_wheelJobCount == 0)
+    {
+      _currentTick = tick;
+      break;
+    }
+
+    const uint64_t currentTick = ++_currentTick;
+
+    // Every time a wheel completes a revolution the next slot of the following
+    // wheel is cascaded down, starting from the last wheel.
+    const auto cascade = [this, currentTick](Slot& slot)
+    {
+      Slot jobs;
+      jobs.swap(slot);
+      for (auto& job : jobs)
+        InsertJob(std::move(job), currentTick);
+    };
+
+    if ((currentTick & ((uint64_t{1} << WheelBits * WheelCount) - 1)) == 0)
+      cascade(_overflow);
+
+    for (uint32_t wheelIdx = WheelCount - 1; wheelIdx > 0; --wheelIdx)
+    {
+      const uint32_t slotShift = WheelBits * wheelIdx;
+      if ((currentTick & ((uint64_t{1} << slotShift) - 1)) != 0)
+        continue;
+
+      cascade(_wheels[wheelIdx][currentTick >> slotShift & (WheelSize - 1)]);
+    }
+
+    auto& slot = _wheels[0][currentTick & (WheelSize - 1)];
+    _wheelJobCount -= slot.size();
+    std::ranges::move(slot, std::back_inserter(due));
+    slot.clear();
+  }
+}
 
 } // namespace server
@@ -6,6 +6,8 @@
 
 #include "libserver/util/Locale.hpp"
 
+#include <cstring>
+
 namespace server
 {
 
@@ -62,23 +64,44 @@ void SinkStream::Write(const void* data, std::size_t size)
     throw std::overflow_error(std::format("Couldn't write {} bytes to the buffer (cursor: {}, available: {}). Not enough space.", size, _cursor, _storage.size()));
   }
 
-  // Write the bytes.
-  for (std::size_t byteIdx = 0; byteIdx < size; ++byteIdx)
+  if (size == 0)
+    return;
+
+  std::memcpy(_storage.data() + _cursor, data, size);
+  _cursor += size;
+}
+
+SinkStream::ReservedWriter SinkStream::Reserve(std::size_t size)
+{
+  if (_cursor + size > _storage.size())
   {
-    _storage[_cursor++] = static_cast<const std::byte*>(data)[byteIdx];
+    throw std::overflow_error(std::format("Couldn't reserve {} bytes in the buffer (cursor: {}, available: {}). Not enough space.", size, _cursor, _storage.size()));
   }
+
+  return ReservedWriter(_storage.data() + _cursor, size, _cursor);
 }
 
-SinkStream& SinkStream::Write(const std::string& value)
+std::size_t GetEncodedSize(const std::string& value)
 {
-  const std::string buffer = locale::FromUtf8(value);
+  // The string is written with its null terminator.
+  if (locale::IsPlainAscii(value))
+    return value.size() + 1;
 
-  for (char b : buffer)
+  return locale::FromUtf8(value).size() + 1;
+}
+
+SinkStream& SinkStream::Write(const std::string& value)
+{
+  // The string is written with its null terminator.
+  // Plain ASCII strings are the same in EUC-KR and are written without a conversion.
+  if (locale::IsPlainAscii(value))
   {
-    Write(b);
+    Write(value.c_str(), value.size() + 1);
+    return *this;
   }
 
-  Write(static_cast<char>(0x00));
+  const std::string buffer = locale::FromUtf8(value);
+  Write(buffer.c_str(), buffer.size() + 1);
   return *this;
 }
 
@@ -89,35 +112,37 @@ void SourceStream::Read(void* data, std::size_t size)
     throw std::overflow_error(std::format("Couldn't read {} bytes from the buffer (cursor: {}, available: {}). Not enough space.", size, _cursor, _storage.size()));
   }
 
-  // Read the bytes.
-  for (std::size_t byteIdx = 0; byteIdx < size; ++byteIdx)
-  {
-    static_cast<std::byte*>(data)[byteIdx] = _storage[_cursor++];
-  }
+  if (size == 0)
+    return;
+
+  std::memcpy(data, _storage.data() + _cursor, size);
+  _cursor += size;
 }
 
 SourceStream& SourceStream::Read(std::string& value)
 {
-  std::string buffer;
-  buffer.reserve(512);
+  const auto available = _storage.subspan(_cursor);
+  const auto terminator = available.empty()
+    ? nullptr
+    : static_cast<const std::byte*>(std::memchr(available.data(), 0, available.size()));
 
-  bool readNext = true;
-  do
+  if (terminator == nullptr)
   {
-    char read = '\0';
-    Read(read);
-
-    if (read == '\0')
-    {
-      readNext = false;
-    }
-    else
-    {
-      buffer += read;
-    }
-  } while (readNext);
-
-  value = locale::ToUtf8(buffer);
+    throw std::overflow_error(std::format("Couldn't read a string from the buffer (cursor: {}, available: {}). Missing the terminator.", _cursor, _storage.size()));
+  }
+
+  const auto length = static_cast<std::size_t>(terminator - available.data());
+  const std::string_view buffer(reinterpret_cast<const char*>(available.data()), length);
+  _cursor += length + 1;
+
+  // Plain ASCII strings are the same in UTF-8 and are read without a conversion.
+  if (locale::IsPlainAscii(buffer))
+  {
+    value.assign(buffer);
+    return *this;
+  }
+
+  value = locale::ToUtf8(std::string(buffer));
   return *this;
 }
 
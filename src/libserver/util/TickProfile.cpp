@@ -0,0 +1,114 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/util/TickProfile.hpp"
+
+#include <algorithm>
+#include <format>
+
+#include <boost/core/demangle.hpp>
+
+namespace server
+{
+
+namespace
+{
+
+//! Profile current on the thread.
+thread_local TickProfile* currentProfile = nullptr;
+
+} // anon namespace
+
+TickProfile::Scope::Scope(TickProfile& profile) noexcept
+  : _previous(currentProfile)
+{
+  currentProfile = &profile;
+}
+
+TickProfile::Scope::~Scope() noexcept
+{
+  currentProfile = _previous;
+}
+
+bool TickProfile::IsActive() noexcept
+{
+  return currentProfile != nullptr;
+}
+
+void TickProfile::Record(
+  const std::string_view kind,
+  const std::type_info& type,
+  const Clock::duration duration) noexcept
+{
+  if (currentProfile == nullptr)
+    return;
+
+  currentProfile->Add(Sample{
+    .kind = kind,
+    .type = &type,
+    .duration = duration});
+}
+
+std::span<const TickProfile::Sample> TickProfile::GetSlowestSamples() const noexcept
+{
+  return std::span(_samples).first(_sampleCount);
+}
+
+std::string TickProfile::FormatSlowestSamples() const
+{
+  std::string formatted;
+  for (const auto& sample : GetSlowestSamples())
+  {
+    if (not formatted.empty())
+      formatted += ", ";
+
+    // The type names are demangled only here, as the overruns are rare.
+    formatted += std::format(
+      "{} '{}' {}us",
+      sample.kind,
+      boost::core::demangle(sample.type->name()),
+      std::chrono::duration_cast<std::chrono::microseconds>(sample.duration).count());
+  }
+
+  return formatted;
+}
+
+void TickProfile::Add(const Sample& sample) noexcept
+{
+  if (_sampleCount == MaxSampleCount
+    && _samples.back().duration >= sample.duration)
+  {
+    return;
+  }
+
+  if (_sampleCount < MaxSampleCount)
+    ++_sampleCount;
+
+  // Insert the sample in the order of the durations, dropping the fastest one if full.
+  const auto samples = std::span(_samples).first(_sampleCount);
+  const auto position = std::ranges::upper_bound(
+    samples.first(_sampleCount - 1),
+    sample.duration,
+    std::ranges::greater{},
+    &Sample::duration);
+  std::shift_right(position, samples.end(), 1);
+  *position = sample;
+}
+
+} // namespace server
@@ -187,6 +187,8 @@ void Config::LoadFromFile(const std::filesystem::path& filePath)
       general.brand = generalYaml["brand"].as<std::string>("<not set>");
       general.notice = generalYaml["notice"].as<std::string>("");
       general.promotePassphrase = generalYaml["promotePassphrase"].as<std::string>("");
+      general.directorThreads = generalYaml["directorThreads"].as<uint32_t>(0);
+      general.directorTickBudget = generalYaml["directorTickBudget"].as<uint32_t>(20);
     }
     catch (const std::exception& e)
     {
@@ -224,6 +226,7 @@ void Config::LoadFromFile(const std::filesystem::path& filePath)
       const auto lobbyYaml = serverYaml["lobby"];
       lobby.enabled = lobbyYaml["enabled"].as<bool>();
       lobby.listen = parseListenSection(lobbyYaml["listen"]);
+      lobby.ioThreads = lobbyYaml["ioThreads"].as<uint32_t>(1);
 
       const auto lobbyAdvertisementYaml = lobbyYaml["advertisement"];
       lobby.advertisement.ranch = parseListenSection(lobbyAdvertisementYaml["ranch"]);
@@ -244,6 +247,8 @@ void Config::LoadFromFile(const std::filesystem::path& filePath)
       const auto ranchYaml = serverYaml["ranch"];
       ranch.enabled = ranchYaml["enabled"].as<bool>();
       ranch.listen = parseListenSection(ranchYaml["listen"]);
+      ranch.ioThreads = ranchYaml["ioThreads"].as<uint32_t>(1);
+
     }
     catch (const std::exception& e)
     {
@@ -256,6 +261,7 @@ void Config::LoadFromFile(const std::filesystem::path& filePath)
       const auto raceYaml = serverYaml["race"];
       race.enabled = raceYaml["enabled"].as<bool>();
       race.listen = parseListenSection(raceYaml["listen"]);
+      race.ioThreads = raceYaml["ioThreads"].as<uint32_t>(1);
     }
     catch (const std::exception& e)
     {
@@ -268,6 +274,7 @@ void Config::LoadFromFile(const std::filesystem::path& filePath)
       const auto messengerYaml = serverYaml["messenger"];
       messenger.enabled = messengerYaml["enabled"].as<bool>();
       messenger.listen = parseListenSection(messengerYaml["listen"]);
+      messenger.ioThreads = messengerYaml["ioThreads"].as<uint32_t>(1);
     }
     catch (const std::exception& e)
     {
@@ -280,6 +287,7 @@ void Config::LoadFromFile(const std::filesystem::path& filePath)
       const auto allChatYaml = serverYaml["all_chat"];
       allChat.enabled = allChatYaml["enabled"].as<bool>();
       allChat.listen = parseListenSection(allChatYaml["listen"]);
+      allChat.ioThreads = allChatYaml["ioThreads"].as<uint32_t>(1);
     }
     catch (const std::exception& e)
     {
@@ -292,6 +300,7 @@ void Config::LoadFromFile(const std::filesystem::path& filePath)
       const auto privateChatYaml = serverYaml["private_chat"];
       privateChat.enabled = privateChatYaml["enabled"].as<bool>();
       privateChat.listen = parseListenSection(privateChatYaml["listen"]);
+      privateChat.ioThreads = privateChatYaml["ioThreads"].as<uint32_t>(1);
     }
     catch (const std::exception& e)
     {
@@ -303,6 +312,7 @@ void Config::LoadFromFile(const std::filesystem::path& filePath)
     {
       const auto udpYaml = serverYaml["udp_race_relay"];
       udpRaceRelay.enabled = udpYaml["enabled"].as<bool>();
+      udpRaceRelay.inProcess = udpYaml["inProcess"].as<bool>(false);
       udpRaceRelay.listen = parseListenSection(udpYaml["listen"]);
     }
     catch (const std::exception& e)
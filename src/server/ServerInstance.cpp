@@ -19,8 +19,14 @@
 
 #include "server/ServerInstance.hpp"
 
+#include "server/lobby/LobbyNetworkHandler.hpp"
+#include "server/race/RaceNetworkHandler.hpp"
 #include "server/system/QuestSystem.hpp"
 
+#include <libserver/util/TickProfile.hpp>
+
+#include <algorithm>
+#include <ranges>
 #include <stacktrace>
 
 namespace server
@@ -28,6 +34,12 @@ namespace server
 
 namespace
 {
+
+//! Interval of the periodic ticks of the directors.
+constexpr auto DirectorTickInterval = std::chrono::milliseconds(1000 / 50);
+//! Min interval between the logged overruns of a director.
+constexpr auto OverrunLogInterval = std::chrono::seconds(1);
+
 void DumpStackTrace()
 {
   for (const auto& entry : std::stacktrace::current())
@@ -64,24 +76,15 @@ ServerInstance::ServerInstance(
 
 ServerInstance::~ServerInstance()
 {
-  const auto waitForThread = [](const std::string& threadName, std::thread& thread)
+  // Wait for the directors in the reverse order of their start.
+  for (auto& [directorName, terminated] : _directorTerminations | std::views::reverse)
   {
-    if (thread.joinable())
-    {
-      spdlog::debug("Waiting for the '{}' thread to finish...", threadName);
-      thread.join();
-      spdlog::debug("Thread for '{}' finished", threadName);
-    }
-  };
+    spdlog::debug("Waiting for the '{}' to finish...", directorName);
+    terminated.wait();
+    spdlog::debug("The '{}' finished", directorName);
+  }
 
-  waitForThread("race director", _raceDirectorThread);
-  waitForThread("ranch director", _ranchDirectorThread);
-  waitForThread("private chat director", _privateChatDirectorThread);
-  waitForThread("all chat director", _allChatDirectorThread);
-  waitForThread("messenger director", _messengerThread);
-  waitForThread("lobby director", _lobbyDirectorThread);
-  waitForThread("data director", _dataDirectorThread);
-  waitForThread("authentication", _authenticationThread);
+  _executor.End();
 }
 
 void ServerInstance::Initialize()
@@ -92,193 +95,240 @@ void ServerInstance::Initialize()
   LoadConfigurations();
   // Load configurations from environment variables.
   _config.LoadFromEnvironment();
+  if (_settingsOverride)
+    _settingsOverride(_config);
 
-  // Initialize the directors and tick them on their own threads.
-  // Directors will terminate their tick loop once `_shouldRun` flag is set to false.
+  // The directors share the threads of the executor, each of them runs on its own strand.
+  // Directors will terminate once `_shouldRun` flag is set to false.
+  _directorTickBudget = std::chrono::milliseconds(_config.general.directorTickBudget);
+  _executor.Begin(_config.general.directorThreads);
+  spdlog::debug("Running the directors on {} threads", _executor.GetThreadCount());
 
-  // Authentication service
-  _authenticationThread = std::thread([this]()
+  RunDirector("authentication", _authenticationService);
+  RunDirector("data director", _dataDirector);
+  RunDirector("lobby director", _lobbyDirector);
+
+  if (_config.messenger.enabled)
   {
-    try
-    {
-      _authenticationService.Initialize();
-      RunDirectorTaskLoop(_authenticationService);
-      _authenticationService.Terminate();
-    }
-    catch (const std::exception& x)
-    {
-      spdlog::error("Unhandled exception in the authentication: {}", x.what());
-      DumpStackTrace();
+    RunDirector("messenger director", _messengerDirector);
 
-      _shouldRun = false;
-    }
-  });
+    // All chat and private chat depend on messenger.
+    if (_config.allChat.enabled)
+      RunDirector("all chat director", _allChatDirector);
+    if (_config.privateChat.enabled)
+      RunDirector("private chat director", _privateChatDirector);
+  }
 
-  // Data director
-  _dataDirectorThread = std::thread([this]()
+  RunDirector("ranch director", _ranchDirector);
+  RunDirector("race director", _raceDirector);
+
+  if (GetSettings().telemetry.enabled)
   {
-    try
+    RunDirector("telemetry", _telemetry);
+  }
+  else
+  {
+    spdlog::info("Metric collection is disabled");
+  }
+}
+
+bool ServerInstance::WaitForInitialization()
+{
+  bool isInitialized = true;
+  for (auto& [directorName, initialized] : _directorInitializations)
+  {
+    if (not initialized.valid())
+      continue;
+
+    if (not initialized.get())
     {
-      _dataDirector.Initialize();
-      RunDirectorTaskLoop(_dataDirector);
-      _dataDirector.Terminate();
+      spdlog::error("The '{}' failed to initialize", directorName);
+      isInitialized = false;
     }
-    catch (const std::exception& x)
-    {
-      spdlog::error("Unhandled exception in the data director: {}", x.what());
-      DumpStackTrace();
+  }
 
-      _shouldRun = false;
-    }
-  });
+  return isInitialized;
+}
+
+void ServerInstance::Terminate()
+{
+  // Sequentially consistent with the start of the directors, which check the flag
+  // once running, so that a director is either woken up or sees the flag.
+  _shouldRun.store(false, std::memory_order::seq_cst);
+  _breedingMarket.Terminate();
+
+  // The sleeping directors are woken up to terminate.
+  for (const auto& run : _directorRuns)
+    WakeDirector(run);
+}
+
+void ServerInstance::StartDirector(const std::shared_ptr<DirectorRun>& run)
+{
+  _directorTerminations.emplace_back(run->name, run->terminated.get_future());
+  _directorInitializations.emplace_back(run->name, run->initialized.get_future());
+  _directorRuns.emplace_back(run);
 
-  // Lobby director
-  _lobbyDirectorThread = std::thread([this]()
+  run->strand.Post([this, run]()
   {
     try
     {
-      _lobbyDirector.Initialize();
-      RunDirectorTaskLoop(_lobbyDirector);
-      _lobbyDirector.Terminate();
+      run->initialize();
     }
     catch (const std::exception& x)
     {
-      spdlog::error("Unhandled exception in the lobby director: {}", x.what());
+      spdlog::error("Unhandled exception in the {}: {}", run->name, x.what());
       DumpStackTrace();
 
       _shouldRun = false;
+      run->initialized.set_value(false);
+      run->terminated.set_value();
+      return;
     }
+
+    run->isRunning = true;
+    run->initialized.set_value(true);
+    TickDirector(run, std::chrono::steady_clock::now());
   });
+}
 
-  // Messenger director
-  if (_config.messenger.enabled)
+void ServerInstance::WakeDirector(const std::shared_ptr<DirectorRun>& run)
+{
+  // Wake ups are coalesced, the ones before the posted one is handled are redundant.
+  if (not run->isRunning.load(std::memory_order::seq_cst)
+    || run->isWakePending.exchange(true))
   {
-    _messengerThread = std::thread([this]()
-    {
-      try
-      {
-        _messengerDirector.Initialize();
-        RunDirectorTaskLoop(_messengerDirector);
-        _messengerDirector.Terminate();
-      }
-      catch (const std::exception& x)
-      {
-        spdlog::error("Unhandled exception in the messenger director: {}", x.what());
-        DumpStackTrace();
+    return;
+  }
 
-        _shouldRun = false;
-      }
-    });
+  run->strand.Post([this, run]()
+  {
+    using Clock = std::chrono::steady_clock;
 
-    // All chat director
-    if (_config.allChat.enabled) // All chat depends on messenger
-    {
-      _allChatDirectorThread = std::thread([this]()
-      {
-        try
-        {
-          _allChatDirector.Initialize();
-          RunDirectorTaskLoop(_allChatDirector);
-          _allChatDirector.Terminate();
-        }
-        catch (const std::exception& x)
-        {
-          spdlog::error("Unhandled exception in the messenger (all chat) director: {}", x.what());
-          DumpStackTrace();
-
-          _shouldRun = false;
-        }
-      });
-    }
+    run->isWakePending = false;
+    if (not run->isRunning.load(std::memory_order::relaxed))
+      return;
 
-    // Private chat director
-    if (_config.privateChat.enabled) // Private chat depends on messenger
+    // The director is terminated right away when the server should stop.
+    if (not _shouldRun.load(std::memory_order::relaxed))
     {
-      _privateChatDirectorThread = std::thread([this]()
-      {
-        try
-        {
-          _privateChatDirector.Initialize();
-          RunDirectorTaskLoop(_privateChatDirector);
-          _privateChatDirector.Terminate();
-        }
-        catch (const std::exception& x)
-        {
-          spdlog::error("Unhandled exception in the messenger (private chat) director: {}", x.what());
-          DumpStackTrace();
-
-          _shouldRun = false;
-        }
-      });
+      TickDirector(run, Clock::now());
+      return;
     }
+
+    ProfileTick(*run, run->tickQueuedWork);
+
+    // The queued work might bring the next tick of a sleeping director forward,
+    // the ticks of a director with periodic work are kept at the interval.
+    const auto nextTickTime = std::max({
+      run->getNextTickTime(),
+      run->lastTickTime + DirectorTickInterval,
+      Clock::now()});
+    if (nextTickTime < run->scheduledTickTime)
+      ScheduleTick(run, nextTickTime);
+  });
+}
+
+void ServerInstance::ProfileTick(TickMonitor& monitor, const std::function<void()>& tick)
+{
+  using Clock = std::chrono::steady_clock;
+
+  TickProfile profile;
+  const auto tickBegin = Clock::now();
+
+  try
+  {
+    const TickProfile::Scope profileScope(profile);
+    tick();
+  }
+  catch (const std::exception& x)
+  {
+    spdlog::error("Exception in tick loop: {}", x.what());
   }
 
-  // Ranch director
-  _ranchDirectorThread = std::thread([this]()
+  const auto tickDuration = Clock::now() - tickBegin;
+  monitor.tickDurations.Record(tickDuration);
+
+  if (tickDuration <= _directorTickBudget
+    || tickBegin - monitor.lastOverrunLog < OverrunLogInterval)
   {
-    try
-    {
-      _ranchDirector.Initialize();
-      RunDirectorTaskLoop(_ranchDirector);
-      _ranchDirector.Terminate();
-    }
-    catch (const std::exception& x)
-    {
-      spdlog::error("Unhandled exception in the ranch director: {}", x.what());
-      DumpStackTrace();
+    return;
+  }
 
-      _shouldRun = false;
-    }
-  });
+  // The overruns are logged at most once per interval, an overloaded director would flood the log.
+  monitor.lastOverrunLog = tickBegin;
+
+  const auto slowestSamples = profile.FormatSlowestSamples();
+  spdlog::warn(
+    "Tick of the {} took {}ms, over its budget of {}ms. Slowest work: {}",
+    monitor.name,
+    std::chrono::duration_cast<std::chrono::milliseconds>(tickDuration).count(),
+    _directorTickBudget.count(),
+    slowestSamples.empty() ? "<not recorded>" : slowestSamples);
+}
 
-  // Race director
-  _raceDirectorThread = std::thread([this]()
+void ServerInstance::TickDirector(
+  const std::shared_ptr<DirectorRun>& run,
+  const std::chrono::steady_clock::time_point tickTime)
+{
+  using Clock = std::chrono::steady_clock;
+
+  if (not _shouldRun.load(std::memory_order::seq_cst))
   {
+    run->isRunning = false;
     try
     {
-      _raceDirector.Initialize();
-      RunDirectorTaskLoop(_raceDirector);
-      _raceDirector.Terminate();
+      run->terminate();
     }
     catch (const std::exception& x)
     {
-      spdlog::error("Unhandled exception in the race director: {}", x.what());
+      spdlog::error("Unhandled exception in the {}: {}", run->name, x.what());
       DumpStackTrace();
-
-      _shouldRun = false;
     }
-  });
 
-  // Telemetry.
-  if (GetSettings().telemetry.enabled)
-  {
-    _telemetryThread = std::thread([this]()
+    run->terminated.set_value();
+    return;
+  }
+
+  ProfileTick(*run, run->tick);
+  run->lastTickTime = tickTime;
+
+  // The director ticks at the interval while it has periodic work, otherwise it sleeps
+  // until its next periodic work or until the queued work wakes it up.
+  // The ticks missed by an overrunning tick are not caught up with.
+  const auto now = Clock::now();
+  const auto deadline = tickTime + DirectorTickInterval;
+  if (now > deadline)
+    run->missedDeadlineCount.fetch_add(1, std::memory_order::relaxed);
+
+  ScheduleTick(run, std::max({deadline, now, run->getNextTickTime()}));
+}
+
+void ServerInstance::ScheduleTick(
+  const std::shared_ptr<DirectorRun>& run,
+  const std::chrono::steady_clock::time_point tickTime)
+{
+  run->scheduledTickTime = tickTime;
+  if (tickTime == std::chrono::steady_clock::time_point::max())
+    return;
+
+  run->strand.PostAt(
+    [this, run, tickTime]()
     {
-      try
+      // The superseded ticks are dropped.
+      if (not run->isRunning.load(std::memory_order::relaxed)
+        || run->scheduledTickTime != tickTime)
       {
-        _telemetry.Initialize();
-        RunDirectorTaskLoop(_telemetry);
-        _telemetry.Terminate();
+        return;
       }
-      catch (const std::exception& x)
-      {
-        spdlog::error("Unhandled exception in telemetry: {}", x.what());
-        DumpStackTrace();
 
-        _shouldRun = false;
-      }
-    });
-  }
-  else
-  {
-    spdlog::info("Metric collection is disabled");
-  }
+      TickDirector(run, tickTime);
+    },
+    tickTime);
 }
 
-void ServerInstance::Terminate()
+void ServerInstance::SetSettingsOverride(std::function<void(Config&)> settingsOverride)
 {
-  _shouldRun.store(false, std::memory_order::relaxed);
-  _breedingMarket.Terminate();
+  _settingsOverride = std::move(settingsOverride);
 }
 
 void ServerInstance::LoadConfigurations()
@@ -339,6 +389,28 @@ PrivateChatDirector& ServerInstance::GetPrivateChatDirector()
   return _privateChatDirector;
 }
 
+CommandServer* ServerInstance::FindCommandServer(const std::string_view name)
+{
+  if (name == "lobby")
+    return &_lobbyDirector.GetNetworkHandler().GetCommandServer();
+  if (name == "ranch")
+    return &_ranchDirector.GetCommandServer();
+  if (name == "race")
+    return &_raceDirector.GetNetworkHandler().GetCommandServer();
+  return nullptr;
+}
+
+ChatterServer* ServerInstance::FindChatterServer(const std::string_view name)
+{
+  if (name == "messenger")
+    return &_messengerDirector.GetChatterServer();
+  if (name == "allchat")
+    return &_allChatDirector.GetChatterServer();
+  if (name == "privatechat")
+    return &_privateChatDirector.GetChatterServer();
+  return nullptr;
+}
+
 registry::CharacterRegistry& ServerInstance::GetCharacterRegistry()
 {
   return _characterRegistry;
@@ -454,4 +526,24 @@ Config& ServerInstance::GetSettings()
   return _config;
 }
 
+const std::filesystem::path& ServerInstance::GetResourceDirectory() const
+{
+  return _resourceDirectory;
+}
+
+std::vector<ServerInstance::DirectorTickMetrics> ServerInstance::CollectDirectorTickMetrics()
+{
+  std::vector<DirectorTickMetrics> metrics;
+  for (const auto& run : _directorRuns)
+  {
+    metrics.emplace_back(DirectorTickMetrics{
+      .name = run->name,
+      .tickDurations = run->tickDurations.Summarize(),
+      .missedDeadlineCount = run->missedDeadlineCount.exchange(0, std::memory_order::relaxed)});
+    run->tickDurations.Reset();
+  }
+
+  return metrics;
+}
+
 } // namespace server
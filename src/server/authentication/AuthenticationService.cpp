@@ -93,26 +93,60 @@ void AuthenticationService::Tick() noexcept
   if (not result)
     return;
 
+  std::function<void()> verdictHandler;
   {
     std::scoped_lock verdictsLock(_verdictsMutex);
     _verdicts.emplace_back(Verdict{
       .userName = request.userName,
       .isAuthenticated = result.value_or(false)});
+    verdictHandler = _verdictHandler;
   }
 
   _hasVerdicts.store(true, std::memory_order::release);
 
   _queue.pop();
+
+  if (verdictHandler)
+    verdictHandler();
+
+  // The authentications are processed one per tick, keep going through the queue.
+  if (not _queue.empty() && _wakeHandler)
+    _wakeHandler();
+}
+
+std::chrono::steady_clock::time_point AuthenticationService::GetNextTickTime()
+{
+  // The queued authentications are retried until the backend gives a result.
+  std::scoped_lock lock(_queueMutex);
+  return _queue.empty()
+    ? std::chrono::steady_clock::time_point::max()
+    : std::chrono::steady_clock::time_point::min();
+}
+
+void AuthenticationService::SetWakeHandler(std::function<void()> wakeHandler)
+{
+  _wakeHandler = std::move(wakeHandler);
+}
+
+void AuthenticationService::SetVerdictHandler(std::function<void()> verdictHandler)
+{
+  std::scoped_lock lock(_verdictsMutex);
+  _verdictHandler = std::move(verdictHandler);
 }
 
 void AuthenticationService::QueueAuthentication(
   const std::string& userName,
   const std::string& userToken) noexcept
 {
-  std::scoped_lock lock(_queueMutex);
-  _queue.emplace(Authentication{
-    .userName = userName,
-    .userToken = userToken});
+  {
+    std::scoped_lock lock(_queueMutex);
+    _queue.emplace(Authentication{
+      .userName = userName,
+      .userToken = userToken});
+  }
+
+  if (_wakeHandler)
+    _wakeHandler();
 }
 
 bool AuthenticationService::HasAuthenticationVerdicts() noexcept
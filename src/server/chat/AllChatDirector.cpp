@@ -57,7 +57,10 @@ void AllChatDirector::Initialize()
     GetConfig().listen.address.to_string(),
     GetConfig().listen.port);
 
-  _chatterServer.BeginHost(GetConfig().listen.address, GetConfig().listen.port);
+  _chatterServer.BeginHost(
+    GetConfig().listen.address,
+    GetConfig().listen.port,
+    GetConfig().ioThreads);
 }
 
 void AllChatDirector::Terminate()
@@ -84,11 +87,21 @@ void AllChatDirector::Tick()
 {
 }
 
+std::chrono::steady_clock::time_point AllChatDirector::GetNextTickTime() const
+{
+  return std::chrono::steady_clock::time_point::max();
+}
+
 Config::AllChat& AllChatDirector::GetConfig()
 {
   return _serverInstance.GetSettings().allChat;
 }
 
+ChatterServer& AllChatDirector::GetChatterServer()
+{
+  return _chatterServer;
+}
+
 void AllChatDirector::HandleClientConnected(network::ClientId clientId)
 {
   spdlog::debug("Client {} connected to the all chat server from {}",
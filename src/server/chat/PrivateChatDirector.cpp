@@ -57,7 +57,10 @@ void PrivateChatDirector::Initialize()
     GetConfig().listen.address.to_string(),
     GetConfig().listen.port);
 
-  _chatterServer.BeginHost(GetConfig().listen.address, GetConfig().listen.port);
+  _chatterServer.BeginHost(
+    GetConfig().listen.address,
+    GetConfig().listen.port,
+    GetConfig().ioThreads);
 }
 
 void PrivateChatDirector::Terminate()
@@ -80,11 +83,21 @@ void PrivateChatDirector::Tick()
 {
 }
 
+std::chrono::steady_clock::time_point PrivateChatDirector::GetNextTickTime() const
+{
+  return std::chrono::steady_clock::time_point::max();
+}
+
 Config::PrivateChat& PrivateChatDirector::GetConfig()
 {
   return _serverInstance.GetSettings().privateChat;
 }
 
+ChatterServer& PrivateChatDirector::GetChatterServer()
+{
+  return _chatterServer;
+}
+
 const std::optional<network::ClientId> PrivateChatDirector::GetTargetClientIdByContext(
   const ConversationContext& conversationContext) const
 {
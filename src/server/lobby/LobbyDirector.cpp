@@ -80,6 +80,23 @@ void LobbyDirector::Tick()
   _scheduler.Tick();
 }
 
+Scheduler::Clock::time_point LobbyDirector::GetNextTickTime()
+{
+  // The queued logins wait on the authentication and the data, which are polled.
+  if (not _loginRequestQueue.empty() || not _loginResponseQueue.empty())
+    return Scheduler::Clock::time_point::min();
+
+  return _scheduler.GetNextDueTime();
+}
+
+void LobbyDirector::SetWakeHandler(const Scheduler::WakeHandler& wakeHandler)
+{
+  _wakeHandler = wakeHandler;
+  _scheduler.SetWakeHandler(wakeHandler);
+  // The verdicts of the authentication are processed by the director.
+  _serverInstance.GetAuthenticationService().SetVerdictHandler(wakeHandler);
+}
+
 bool LobbyDirector::QueueClientConnect(network::ClientId clientId)
 {
   const auto [iter, inserted] = _clientLogins.try_emplace(clientId);
@@ -102,6 +119,9 @@ size_t LobbyDirector::QueueClientLogin(
 
   _loginRequestQueue.emplace_back(clientId);
 
+  if (_wakeHandler)
+    _wakeHandler();
+
   return _loginRequestQueue.size() + _loginResponseQueue.size();
 }
 
@@ -307,7 +307,10 @@ void LobbyNetworkHandler::Initialize()
     lobbyConfig.listen.address.to_string(),
     lobbyConfig.listen.port);
 
-  _commandServer.BeginHost(lobbyConfig.listen.address, lobbyConfig.listen.port);
+  _commandServer.BeginHost(
+    lobbyConfig.listen.address,
+    lobbyConfig.listen.port,
+    lobbyConfig.ioThreads);
 }
 
 void LobbyNetworkHandler::Terminate()
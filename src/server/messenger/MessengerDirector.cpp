@@ -165,7 +165,10 @@ void MessengerDirector::Initialize()
     GetConfig().listen.address.to_string(),
     GetConfig().listen.port);
 
-  _chatterServer.BeginHost(GetConfig().listen.address, GetConfig().listen.port);
+  _chatterServer.BeginHost(
+    GetConfig().listen.address,
+    GetConfig().listen.port,
+    GetConfig().ioThreads);
 }
 
 void MessengerDirector::Terminate()
@@ -337,11 +340,21 @@ void MessengerDirector::Tick()
 {
 }
 
+std::chrono::steady_clock::time_point MessengerDirector::GetNextTickTime() const
+{
+  return std::chrono::steady_clock::time_point::max();
+}
+
 Config::Messenger& MessengerDirector::GetConfig()
 {
   return _serverInstance.GetSettings().messenger;
 }
 
+ChatterServer& MessengerDirector::GetChatterServer()
+{
+  return _chatterServer;
+}
+
 void MessengerDirector::HandleClientConnected(const network::ClientId clientId)
 {
   spdlog::debug("Client {} connected to the messenger server from {}",
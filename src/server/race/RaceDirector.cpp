@@ -22,6 +22,8 @@
 #include "server/race/RaceNetworkHandler.hpp"
 #include "server/ServerInstance.hpp"
 
+#include <algorithm>
+
 #include <spdlog/spdlog.h>
 
 namespace server
@@ -64,6 +66,31 @@ void RaceDirector::Tick()
   GetNetworkHandler().Tick();
 }
 
+void RaceDirector::TickQueuedWork()
+{
+  try
+  {
+    _scheduler.Tick();
+  }
+  catch (const std::exception& x)
+  {
+    spdlog::error("Exception ticking a race scheduler: {}", x.what());
+  }
+
+  GetNetworkHandler().TickScheduler();
+}
+
+Scheduler::Clock::time_point RaceDirector::GetNextTickTime()
+{
+  return std::min(_scheduler.GetNextDueTime(), GetNetworkHandler().GetNextTickTime());
+}
+
+void RaceDirector::SetWakeHandler(const Scheduler::WakeHandler& wakeHandler)
+{
+  _scheduler.SetWakeHandler(wakeHandler);
+  GetNetworkHandler().SetWakeHandler(wakeHandler);
+}
+
 void RaceDirector::DisconnectCharacter(const data::Uid characterUid)
 {
   GetNetworkHandler().DisconnectCharacter(
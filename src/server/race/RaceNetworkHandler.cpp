@@ -277,24 +277,42 @@ void RaceNetworkHandler::Initialize()
     GetConfig().listen.address.to_string(),
     GetConfig().listen.port);
 
-  _commandServer.BeginHost(GetConfig().listen.address, GetConfig().listen.port);
+  _commandServer.BeginHost(
+    GetConfig().listen.address,
+    GetConfig().listen.port,
+    GetConfig().ioThreads);
+
+  const auto& udpRaceRelayConfig = GetServerInstance().GetSettings().udpRaceRelay;
+  if (udpRaceRelayConfig.enabled && udpRaceRelayConfig.inProcess)
+  {
+    // The race server works without the relay, a failure to bind it does not abort the startup.
+    try
+    {
+      _udpRelay.Begin(
+        udpRaceRelayConfig.listen.address,
+        udpRaceRelayConfig.listen.port);
+
+      spdlog::debug(
+        "UDP race relay listening on {}:{}",
+        udpRaceRelayConfig.listen.address.to_string(),
+        udpRaceRelayConfig.listen.port);
+    }
+    catch (const std::exception& x)
+    {
+      spdlog::error("UDP race relay is not running: {}", x.what());
+    }
+  }
 }
 
 void RaceNetworkHandler::Terminate()
 {
+  _udpRelay.End();
   _commandServer.EndHost();
 }
 
 void RaceNetworkHandler::Tick()
 {
-  try
-  {
-    _scheduler.Tick();
-  }
-  catch (const std::exception& x)
-  {
-    spdlog::error("Exception ticking a race scheduler: {}", x.what());
-  }
+  TickScheduler();
 
   std::scoped_lock lock(_raceInstancesMutex);
   for (auto& raceInstance : _raceInstances | std::views::values)
@@ -310,6 +328,35 @@ void RaceNetworkHandler::Tick()
   }
 }
 
+void RaceNetworkHandler::TickScheduler()
+{
+  try
+  {
+    _scheduler.Tick();
+  }
+  catch (const std::exception& x)
+  {
+    spdlog::error("Exception ticking a race scheduler: {}", x.what());
+  }
+}
+
+Scheduler::Clock::time_point RaceNetworkHandler::GetNextTickTime()
+{
+  {
+    std::scoped_lock lock(_raceInstancesMutex);
+    if (not _raceInstances.empty())
+      return Scheduler::Clock::time_point::min();
+  }
+
+  return _scheduler.GetNextDueTime();
+}
+
+void RaceNetworkHandler::SetWakeHandler(const Scheduler::WakeHandler& wakeHandler)
+{
+  _wakeHandler = wakeHandler;
+  _scheduler.SetWakeHandler(wakeHandler);
+}
+
 void RaceNetworkHandler::NotifySummonCharacter(
     data::Uid characterUid,
     bool force,
@@ -428,6 +475,7 @@ void RaceNetworkHandler::HandleClientDisconnected(ClientId clientId)
     // Erase client P2dId and release it
     const race::P2dId p2dId = _p2dIds.at(clientId);
     _p2dIds.erase(clientId);
+    _udpRelay.GetTable().UnregisterSession(p2dId);
     _p2dIdPool.Release(p2dId);
   }
 
@@ -576,6 +624,7 @@ void RaceNetworkHandler::HandleEnterRoom(
   clientContext.isAuthenticated = _serverInstance.GetOtpSystem().AuthorizeCode(
     identityHash,
     command.oneTimePassword);
+  clientContext.oneTimePassword = command.oneTimePassword;
 
   const bool doesRoomExist = _serverInstance.GetRoomSystem().RoomExists(
     command.roomUid);
@@ -633,6 +682,10 @@ void RaceNetworkHandler::HandleEnterRoom(
       auto& roomDetails = room.GetRoomDetails();
       roomDetails.masterUid = masterUid;
     });
+
+    // The races are ticked periodically, the director might be sleeping.
+    if (_wakeHandler)
+      _wakeHandler();
   }
 
   _serverInstance.GetDataDirector().GetCharacter(clientContext.characterUid).Immutable(
@@ -1170,6 +1223,7 @@ void RaceNetworkHandler::HandleLeaveRoom(ClientId clientId)
     {
       _serverInstance.GetRoomSystem().DeleteRoom(clientContext.roomUid);
       _raceInstances.erase(clientContext.roomUid);
+      _udpRelay.GetTable().UnregisterRoom(clientContext.roomUid);
     }
   }
 
@@ -1327,6 +1381,7 @@ void RaceNetworkHandler::HandleStartRace(
       for (const auto& [characterUid, roomPlayer] : room.GetPlayers())
       {
         auto& racer = raceInstance.GetTracker().AddRacer(characterUid);
+        racer.clientId = roomPlayer.GetClientId();
         racer.state = tracker::RaceTracker::Racer::State::Loading;
         switch (roomPlayer.GetTeam())
         {
@@ -1372,6 +1427,9 @@ void RaceNetworkHandler::HandleStartRace(
         .p2pRelayPort = lobbyConfig.advertisement.udpRaceRelay.port,
         .raceMissionId = parameters.missionId,};
 
+      const auto& udpRaceRelayConfig = GetServerInstance().GetSettings().udpRaceRelay;
+      const bool isUdpRelayInProcess = udpRaceRelayConfig.enabled && udpRaceRelayConfig.inProcess;
+
       // Build the racers.
       for (const auto& [characterUid, racer] : raceInstance.GetTracker().GetRacers())
       {
@@ -1394,6 +1452,22 @@ void RaceNetworkHandler::HandleStartRace(
         const ClientId racerClientId = GetClientIdByCharacterUid(characterUid);
         protocolRacer.p2dId = GetOrCreateP2dId(racerClientId);
 
+        // Bind the P2dId to the room in the in-process UDP relay, the racer is accepted
+        // only from the address of its connection and with its one time password.
+        // A racer whose connection has already dropped is not registered.
+        if (isUdpRelayInProcess)
+        {
+          const auto racerAddress = _commandServer.FindClientAddress(racerClientId);
+          if (racerAddress)
+          {
+            _udpRelay.GetTable().RegisterSession(
+              protocolRacer.p2dId,
+              roomUid,
+              *racerAddress,
+              GetClientContext(racerClientId).oneTimePassword);
+          }
+        }
+
         switch (racer.team)
         {
           case tracker::RaceTracker::Racer::Team::Solo:
@@ -2387,12 +2461,27 @@ void RaceNetworkHandler::HandleRelay(
 
   std::scoped_lock lock(_raceInstancesMutex);
   // Get the room instance for this client
-  const auto& raceInstance = GetRaceInstance(clientContext);
+  auto& raceInstance = GetRaceInstance(clientContext);
 
-  // Relay the command to all other clients in the room
+  // Forward the directed payloads to their recipient only.
+  // The payloads directed to an unknown OID are broadcast, as before.
+  if (command.toOid != 0)
+  {
+    const auto* recipient = raceInstance.GetTracker().FindRacerByOid(command.toOid);
+    if (recipient != nullptr)
+    {
+      if (recipient->state != tracker::RaceTracker::Racer::State::Disconnected
+        && recipient->clientId != clientId)
+      {
+        const std::array recipients{recipient->clientId};
+        _commandServer.Broadcast(recipients, notify);
+      }
 
-  // TODO: potential improvement - instead of blindly broadcasting to room,
-  // forward packet to recepient if `toOid` is non-zero.
+      return;
+    }
+  }
+
+  // Relay the command to all other clients in the room
   this->BroadcastExceptCharacterUid(raceInstance, notify, clientContext.characterUid);
 }
 
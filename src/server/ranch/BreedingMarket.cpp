@@ -103,6 +103,11 @@ void BreedingMarket::Tick()
   _scheduler.Tick();
 }
 
+Scheduler::Clock::time_point BreedingMarket::GetNextTickTime()
+{
+  return _scheduler.GetNextDueTime();
+}
+
 bool BreedingMarket::CanRegisterStallion(data::Uid characterUid) const
 {
   // Enforce stallions per character limitation
@@ -58,10 +58,19 @@ constexpr data::Tid InstantGrowUpItemTid = 43001;
 //! How often the foal maturity sweep runs while players are on their ranch.
 constexpr auto FoalMaturityCheckInterval = std::chrono::seconds(60);
 
-//! How many times a deferred ranch entry is retried while waiting for horse
-//! records to load before giving up and cancelling the entry.
-constexpr uint32_t MaxEnterRanchDeferAttempts = 2;
-constexpr uint32_t MaxTryBreedingDeferAttempts = 4;
+//! How long a deferred ranch entry waits for the horse records
+//! to load before giving up and cancelling the entry.
+constexpr auto MaxEnterRanchDeferDuration = std::chrono::seconds(2);
+//! How long a deferred breeding attempt waits for the ancestry
+//! to load before breeding with the records at hand.
+constexpr auto MaxTryBreedingDeferDuration = std::chrono::seconds(4);
+//! How long a deferred family tree request waits for the ancestor records
+//! to load before responding with the ancestors at hand.
+constexpr auto MaxMountFamilyTreeDeferDuration = std::chrono::seconds(4);
+
+//! Interval of the network ticks of the ranch server, which resume the deferred commands.
+//! Kept short, so that the commands are resumed soon after their data become available.
+constexpr auto NetworkTickInterval = std::chrono::milliseconds(100);
 
 BreedingMarket::SnapshotOrder ConvertProtocolStallionOrderToSnapshotOrder(
   const protocol::AcCmdCRSearchStallion::StallionOrder order)
@@ -117,32 +126,44 @@ RanchDirector::RanchDirector(ServerInstance& serverInstance)
   : _serverInstance(serverInstance)
   , _commandServer(*this)
   , _breedingMarket(serverInstance)
-  , _mountFamilyTreeDeferrer([this](const network::ClientId clientId, const protocol::AcCmdCRMountFamilyTree& command)
-  {
-    HandleMountFamilyTree(clientId, command);
-  })
-  , _enterRanchDeferrer([this](const network::ClientId clientId, const protocol::AcCmdCREnterRanch& command)
-  {
-    // The deferrer erases the command after each tick, so re-queue it here to
-    // keep retrying until the required horse records have loaded. Give up after
-    // a few attempts and cancel the entry so the client isn't stuck forever.
-    const bool deferAgain = HandleEnterRanch(clientId, command);
-    auto& clientContext = GetClientContext(clientId, false);
-
-    if (not deferAgain)
+  , _mountFamilyTreeDeferrer(
+    [this](const network::ClientId clientId, const protocol::AcCmdCRMountFamilyTree& command)
     {
-      clientContext.enterRanchDeferAttempts = 0;
-      return;
-    }
-
-    if (++clientContext.enterRanchDeferAttempts >= MaxEnterRanchDeferAttempts)
+      return HandleMountFamilyTree(clientId, command);
+    },
+    [this]()
+    {
+      return _serverInstance.GetDataDirector().GetRetrieveEpoch();
+    })
+  , _enterRanchDeferrer(
+    [this](const network::ClientId clientId, const protocol::AcCmdCREnterRanch& command)
+    {
+      return HandleEnterRanch(clientId, command);
+    },
+    [this]()
+    {
+      return _serverInstance.GetDataDirector().GetRetrieveEpoch();
+    })
+  , _tryBreedingDeferrer(
+    [this](const network::ClientId clientId, const protocol::AcCmdCRTryBreeding& command)
+    {
+      return HandleTryBreeding(clientId, command);
+    },
+    [this]()
+    {
+      return _serverInstance.GetDataDirector().GetRetrieveEpoch();
+    })
+{
+  // The deferred commands wait for their records only for a while,
+  // so that the clients are not stuck forever.
+  _enterRanchDeferrer.SetMaxWait(
+    MaxEnterRanchDeferDuration,
+    [this](const network::ClientId clientId, const protocol::AcCmdCREnterRanch&)
     {
-      clientContext.enterRanchDeferAttempts = 0;
-
       spdlog::warn(
-        "Ranch entry for client {} gave up after {} deferred attempts; horse records unavailable",
+        "Ranch entry for client {} gave up after {}s deferred; horse records unavailable",
         clientId,
-        MaxEnterRanchDeferAttempts);
+        MaxEnterRanchDeferDuration.count());
 
       protocol::RanchCommandEnterRanchCancel cancel{};
       _commandServer.QueueCommand<decltype(cancel)>(
@@ -151,17 +172,32 @@ RanchDirector::RanchDirector(ServerInstance& serverInstance)
         {
           return cancel;
         });
-      return;
-    }
+    });
+
+  _tryBreedingDeferrer.SetMaxWait(
+    MaxTryBreedingDeferDuration,
+    [this](const network::ClientId clientId, const protocol::AcCmdCRTryBreeding& command)
+    {
+      spdlog::warn(
+        "TryBreeding: ancestry of mare {} and stallion {} still incomplete after {}s, "
+        "breeding with the records at hand",
+        command.mareUid, command.stallionUid, MaxTryBreedingDeferDuration.count());
+
+      HandleTryBreeding(clientId, command, true);
+    });
+
+  _mountFamilyTreeDeferrer.SetMaxWait(
+    MaxMountFamilyTreeDeferDuration,
+    [this](const network::ClientId clientId, const protocol::AcCmdCRMountFamilyTree& command)
+    {
+      spdlog::warn(
+        "MountFamilyTree: ancestors of horse {} still incomplete after {}s, "
+        "responding with the records at hand",
+        command.horseUid, MaxMountFamilyTreeDeferDuration.count());
+
+      HandleMountFamilyTree(clientId, command, true);
+    });
 
-    _enterRanchDeferrer.Defer(clientId, command);
-  })
-  , _tryBreedingDeferrer([this](const network::ClientId clientId, const protocol::AcCmdCRTryBreeding& command)
-  {
-    if (HandleTryBreeding(clientId, command))
-      _tryBreedingDeferrer.Defer(clientId, command);
-  })
-{
   _commandServer.RegisterCommandHandler<protocol::AcCmdCREnterRanch>(
     [this](ClientId clientId, const auto& message)
     {
@@ -411,15 +447,7 @@ RanchDirector::RanchDirector(ServerInstance& serverInstance)
         .characterUid = command.characterUid};
 
       const auto& clientContext = GetClientContext(clientId);
-      for (const ClientId& ranchClientId : _ranches[clientContext.visitingRancherUid].clients)
-      {
-        _commandServer.QueueCommand<decltype(notify)>(
-          ranchClientId,
-          [notify]()
-          {
-            return notify;
-          });
-      }
+      BroadcastToRanch(_ranches[clientContext.visitingRancherUid], notify);
     });
 
   _commandServer.RegisterCommandHandler<protocol::AcCmdCROpCmd>(
@@ -639,7 +667,11 @@ void RanchDirector::Initialize()
     GetConfig().listen.address.to_string(),
     GetConfig().listen.port);
 
-  _commandServer.BeginHost(GetConfig().listen.address, GetConfig().listen.port);
+  _commandServer.SetNetworkTickInterval(NetworkTickInterval);
+  _commandServer.BeginHost(
+    GetConfig().listen.address,
+    GetConfig().listen.port,
+    GetConfig().ioThreads);
 }
 
 void RanchDirector::Terminate()
@@ -654,6 +686,16 @@ void RanchDirector::Tick()
   _scheduler.Tick();
 }
 
+Scheduler::Clock::time_point RanchDirector::GetNextTickTime()
+{
+  return std::min(_breedingMarket.GetNextTickTime(), _scheduler.GetNextDueTime());
+}
+
+void RanchDirector::SetWakeHandler(const Scheduler::WakeHandler& wakeHandler)
+{
+  _scheduler.SetWakeHandler(wakeHandler);
+}
+
 void RanchDirector::RefreshMaturingFoals(
   const data::Uid characterUid,
   ClientContext& clientContext)
@@ -758,15 +800,7 @@ void RanchDirector::AnnounceFoalGrewUp(
   if (clientContext.visitingRancherUid == characterUid)
   {
     // The owner is on their own ranch; broadcast the new idle mount to everyone there.
-    for (const ClientId& ranchClientId : _ranches[characterUid].clients)
-    {
-      _commandServer.QueueCommand<protocol::AcCmdRCAddIdleMountInfoNotify>(
-        ranchClientId,
-        [addNotify]()
-        {
-          return addNotify;
-        });
-    }
+    BroadcastToRanch(_ranches[characterUid], addNotify);
   }
   else
   {
@@ -818,15 +852,7 @@ void RanchDirector::ReturnHorseToNature(
   if (horseOid != tracker::InvalidEntityOid)
   {
     const protocol::AcCmdRCMobDead mobDead{.mobOid = horseOid};
-    for (const ClientId& ranchClientId : ranchInstance.clients)
-    {
-      _commandServer.QueueCommand<protocol::AcCmdRCMobDead>(
-        ranchClientId,
-        [mobDead]()
-        {
-          return mobDead;
-        });
-    }
+    BroadcastToRanch(ranchInstance, mobDead);
   }
 
   // Keep horse record in cache for the family tree
@@ -852,16 +878,37 @@ std::vector<data::Uid> RanchDirector::GetOnlineCharacters()
 
 void RanchDirector::HandleNetworkTick()
 {
-  try
-  {
-    _mountFamilyTreeDeferrer.Tick();
-    _enterRanchDeferrer.Tick();
-    _tryBreedingDeferrer.Tick();
-  }
-  catch (const std::exception& x)
+  // The deferred commands are measured and reported like the ticks of the directors.
+  GetServerInstance().ProfileTick(
+    _networkTickMonitor,
+    [this]()
+    {
+      _mountFamilyTreeDeferrer.Tick();
+      _enterRanchDeferrer.Tick();
+      _tryBreedingDeferrer.Tick();
+    });
+}
+
+CommandDeferrerMetrics RanchDirector::GetDeferredCommandMetrics() const
+{
+  CommandDeferrerMetrics metrics{};
+  for (const auto& deferrerMetrics : {
+    _mountFamilyTreeDeferrer.GetMetrics(),
+    _enterRanchDeferrer.GetMetrics(),
+    _tryBreedingDeferrer.GetMetrics()})
   {
-    spdlog::error("Exception in a network tick of ranch director: {}", x.what());
+    metrics.depth += deferrerMetrics.depth;
+    metrics.resumedCount += deferrerMetrics.resumedCount;
+
+    auto& waitTime = metrics.waitTime;
+    waitTime.count += deferrerMetrics.waitTime.count;
+    waitTime.total += deferrerMetrics.waitTime.total;
+    waitTime.p50 = std::max(waitTime.p50, deferrerMetrics.waitTime.p50);
+    waitTime.p99 = std::max(waitTime.p99, deferrerMetrics.waitTime.p99);
+    waitTime.max = std::max(waitTime.max, deferrerMetrics.waitTime.max);
   }
+
+  return metrics;
 }
 
 void RanchDirector::HandleClientConnected(ClientId clientId)
@@ -883,6 +930,11 @@ void RanchDirector::HandleClientDisconnected(ClientId clientId)
     HandleRanchLeave(clientId);
   }
 
+  // The deferred commands of the client have nobody to answer to.
+  _mountFamilyTreeDeferrer.Discard(clientId);
+  _enterRanchDeferrer.Discard(clientId);
+  _tryBreedingDeferrer.Discard(clientId);
+
   _clients.erase(clientId);
 }
 
@@ -1196,6 +1248,11 @@ Config::Ranch& RanchDirector::GetConfig()
   return GetServerInstance().GetSettings().ranch;
 }
 
+CommandServer& RanchDirector::GetCommandServer()
+{
+  return _commandServer;
+}
+
 RanchDirector::ClientContext& RanchDirector::GetClientContext(
   const ClientId clientId,
   const bool requireAuthentication)
@@ -1569,14 +1626,7 @@ bool RanchDirector::HandleEnterRanch(
 
   // Iterate over all the clients connected
   // to the ranch and broadcast join notification.
-  for (ClientId ranchClient : ranchInstance.clients)
-  {
-    _commandServer.QueueCommand<decltype(ranchJoinNotification)>(
-      ranchClient,
-      [ranchJoinNotification](){
-        return ranchJoinNotification;
-      });
-  }
+  BroadcastToRanch(ranchInstance, ranchJoinNotification);
 
   ranchInstance.clients.emplace(clientId);
 
@@ -1613,18 +1663,7 @@ void RanchDirector::HandleRanchLeave(ClientId clientId)
   protocol::AcCmdCRLeaveRanchNotify notify{
     .characterId = clientContext.characterUid};
 
-  for (const ClientId& ranchClientId : ranchInstance.clients)
-  {
-    if (ranchClientId == clientId)
-      continue;
-
-    _commandServer.QueueCommand<decltype(notify)>(
-      ranchClientId,
-      [notify]()
-      {
-        return notify;
-      });
-  }
+  BroadcastToRanch(ranchInstance, notify, clientId);
 }
 
 void RanchDirector::HandleChat(
@@ -1756,19 +1795,8 @@ void RanchDirector::HandleSnapshot(
     }
   }
 
-  for (const auto& ranchClient : ranchInstance.clients)
-  {
-    // Do not broadcast to the client that sent the snapshot.
-    if (ranchClient == clientId)
-      continue;
-
-    _commandServer.QueueCommand<decltype(notify)>(
-      ranchClient,
-      [notify]()
-      {
-        return notify;
-      });
-  }
+  // Do not broadcast to the client that sent the snapshot.
+  BroadcastToRanch(ranchInstance, notify, clientId);
 }
 
 void RanchDirector::HandleEnterBreedingMarket(
@@ -2107,7 +2135,8 @@ void RanchDirector::HandleCheckStallionCharge(
 
 bool RanchDirector::HandleTryBreeding(
   const ClientId clientId,
-  const protocol::AcCmdCRTryBreeding& command)
+  const protocol::AcCmdCRTryBreeding& command,
+  const bool isWaitOver)
 {
   auto& clientContext = GetClientContext(clientId);
   auto& dataDirector = GetServerInstance().GetDataDirector();
@@ -2129,22 +2158,16 @@ bool RanchDirector::HandleTryBreeding(
     spdlog::warn("TryBreeding: mare {} or stallion {} not found",
       command.mareUid, command.stallionUid);
     sendBreedingCancel(CancelReason::GenericError);
-    clientContext.tryBreedingDeferAttempts = 0;
     return false;
   }
 
-  if (not GetServerInstance().GetGenetics().IsAncestryResident(
-    command.mareUid, command.stallionUid))
+  // Wait for the ancestry to load, unless the wait is over.
+  if (not isWaitOver
+    && not GetServerInstance().GetGenetics().IsAncestryResident(
+      command.mareUid, command.stallionUid))
   {
-    if (++clientContext.tryBreedingDeferAttempts < MaxTryBreedingDeferAttempts)
-      return true;
-
-    spdlog::warn(
-      "TryBreeding: ancestry of mare {} and stallion {} still incomplete after {} attempts, "
-      "breeding with the records at hand",
-      command.mareUid, command.stallionUid, MaxTryBreedingDeferAttempts);
+    return true;
   }
-  clientContext.tryBreedingDeferAttempts = 0;
 
   // The stallion must be registered in the breeding market.
   const auto stallionData = _breedingMarket.GetStallionData(command.stallionUid);
@@ -2409,15 +2432,7 @@ data::Uid RanchDirector::CreateBredFoal(
 
   if (clientContext.visitingRancherUid == clientContext.characterUid)
   {
-    for (const ClientId& ranchClientId : _ranches[clientContext.characterUid].clients)
-    {
-      _commandServer.QueueCommand<protocol::AcCmdRCAddIdleMountInfoNotify>(
-        ranchClientId,
-        [addNotify]()
-        {
-          return addNotify;
-        });
-    }
+    BroadcastToRanch(_ranches[clientContext.characterUid], addNotify);
   }
   else
   {
@@ -2782,19 +2797,7 @@ void RanchDirector::HandleUpdateBusyState(
 
   clientContext.busyState = command.busyState;
 
-  for (auto ranchClientId : ranchInstance.clients)
-  {
-    // Do not broadcast to self.
-    if (ranchClientId == clientId)
-      continue;
-
-    _commandServer.QueueCommand<decltype(response)>(
-      ranchClientId,
-      [response]()
-      {
-        return response;
-      });
-  }
+  BroadcastToRanch(ranchInstance, response, clientId);
 }
 
 
@@ -2916,19 +2919,7 @@ void RanchDirector::HandleUpdateMountNickname(
       return response;
     });
 
-  for (const ClientId& ranchClientId : _ranches[clientContext.visitingRancherUid].clients)
-  {
-    // Prevent broadcast to self.
-    if (ranchClientId == clientId)
-      continue;
-
-    _commandServer.QueueCommand<decltype(notify)>(
-      ranchClientId,
-      [notify]()
-      {
-        return notify;
-      });
-  }
+  BroadcastToRanch(_ranches[clientContext.visitingRancherUid], notify, clientId);
 }
 
 void RanchDirector::SendUpdateMountNicknameCancel(
@@ -3908,19 +3899,7 @@ void RanchDirector::HandleIncubateEgg(
 
   const auto& ranchInstance = _ranches[clientContext.visitingRancherUid];
   // Broadcast the egg incubation to all ranch clients.
-  for (ClientId ranchClient : ranchInstance.clients)
-  {
-    // Prevent broadcasting to self.
-    if (ranchClient == clientId)
-      continue;
-
-    _commandServer.QueueCommand<decltype(notify)>(
-      ranchClient,
-      [notify]()
-      {
-        return notify;
-      });
-  }
+  BroadcastToRanch(ranchInstance, notify, clientId);
 }
 
 void RanchDirector::HandleBoostIncubateEgg(
@@ -4179,19 +4158,7 @@ void RanchDirector::HandleRequestPetBirth(
   
   const auto& ranchInstance = _ranches[clientContext.visitingRancherUid];
   // Broadcast the egg hatching to all ranch clients.
-  for (ClientId ranchClient : ranchInstance.clients)
-  {
-    // Prevent broadcasting to self.
-    if (ranchClient == clientId)
-      continue;
-
-    _commandServer.QueueCommand<decltype(notify)>(
-      ranchClient,
-      [notify]()
-      {
-        return notify;
-      });
-  }
+  BroadcastToRanch(ranchInstance, notify, clientId);
 };
 
 void RanchDirector::HandlePetBornResult(
@@ -4258,19 +4225,7 @@ void RanchDirector::BroadcastEquipmentUpdate(ClientId clientId)
 
   // Broadcast to all the ranch clients.
   const auto& ranchInstance = _ranches[clientContext.visitingRancherUid];
-  for (ClientId ranchClientId : ranchInstance.clients)
-  {
-    // Prevent broadcasting to self.
-    if (ranchClientId == clientId)
-      continue;
-
-    _commandServer.QueueCommand<decltype(notify)>(
-      ranchClientId,
-      [notify]()
-      {
-        return notify;
-      });
-  }
+  BroadcastToRanch(ranchInstance, notify, clientId);
 }
 
 bool RanchDirector::HandleUseFoodItem(
@@ -4612,15 +4567,7 @@ void RanchDirector::HandleUseItem(
     if (clientContext.visitingRancherUid == clientContext.characterUid)
     {
       // The owner is on their own ranch; broadcast the new idle mount to everyone there.
-      for (const ClientId& ranchClientId : _ranches[clientContext.characterUid].clients)
-      {
-        _commandServer.QueueCommand<protocol::AcCmdRCAddIdleMountInfoNotify>(
-          ranchClientId,
-          [addNotify]()
-          {
-            return addNotify;
-          });
-      }
+      BroadcastToRanch(_ranches[clientContext.characterUid], addNotify);
     }
     else
     {
@@ -4761,19 +4708,7 @@ void RanchDirector::HandleHousingBuild(
 
   // Broadcast to all the ranch clients.
   const auto& ranchInstance = _ranches[clientContext.visitingRancherUid];
-  for (ClientId ranchClientId : ranchInstance.clients)
-  {
-    // Prevent broadcasting to self.
-    if (ranchClientId == clientId)
-      continue;
-
-    _commandServer.QueueCommand<decltype(notify)>(
-      ranchClientId,
-      [notify]()
-      {
-        return notify;
-      });
-  }
+  BroadcastToRanch(ranchInstance, notify, clientId);
 }
 
 void RanchDirector::HandleHousingRepair(
@@ -4816,19 +4751,7 @@ void RanchDirector::HandleHousingRepair(
 
   // Broadcast to all the ranch clients.
   const auto& ranchInstance = _ranches[clientContext.visitingRancherUid];
-  for (ClientId ranchClientId : ranchInstance.clients)
-  {
-    // Prevent broadcasting to self.
-    if (ranchClientId == clientId)
-      continue;
-
-    _commandServer.QueueCommand<decltype(notify)>(
-      ranchClientId,
-      [notify]()
-      {
-        return notify;
-      });
-  }
+  BroadcastToRanch(ranchInstance, notify, clientId);
 };
 
 void RanchDirector::HandleOpCmd(
@@ -4973,7 +4896,8 @@ void RanchDirector::HandleRecoverMount(
 
 bool RanchDirector::HandleMountFamilyTree(
   const ClientId clientId,
-  const protocol::AcCmdCRMountFamilyTree& command)
+  const protocol::AcCmdCRMountFamilyTree& command,
+  const bool isWaitOver)
 {
   using HierarchyPosition = protocol::AcCmdCRMountFamilyTreeOK::MountFamilyTreeItem::Position;
 
@@ -5055,7 +4979,8 @@ bool RanchDirector::HandleMountFamilyTree(
   addAncestor(maternal.father, HierarchyPosition::MaternalGrandfather);
   addAncestor(maternal.mother, HierarchyPosition::MaternalGrandmother);
 
-  if (defer)
+  // Wait for the ancestors to load, unless the wait is over.
+  if (defer && not isWaitOver)
     return true;
 
   sendResponse();
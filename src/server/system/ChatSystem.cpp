@@ -2327,6 +2327,133 @@ void ChatSystem::RegisterAdminCommands()
         "Game and server configs"
         "were reloaded"};
     });
+
+  // netstats command
+  _commandManager.RegisterCommand(
+    "netstats",
+    [this](
+      const std::span<const std::string>& arguments,
+      data::Uid characterUid) -> std::vector<std::string>
+    {
+      const auto invokerRank = GetRoleRank(characterUid);
+      if (not invokerRank || *invokerRank != data::Character::RoleRank::Admin)
+        return {};
+
+      if (arguments.size() < 1)
+        return {
+          "Invalid command sub-literal.",
+          "(//netstats <lobby/ranch/race> [count/reset])"};
+
+      const auto& serverLiteral = arguments[0];
+      const auto commandServer = _serverInstance.FindCommandServer(serverLiteral);
+      if (commandServer == nullptr)
+        return {"Unknown server, expected lobby, ranch or race"};
+
+      if (arguments.size() > 1 && arguments[1] == "reset")
+      {
+        commandServer->GetMetrics().Reset();
+        return {std::format("Command metrics of the {} server were reset", serverLiteral)};
+      }
+
+      std::size_t count = 5;
+      if (arguments.size() > 1)
+      {
+        const auto& countLiteral = arguments[1];
+        const auto [ptr, ec] = std::from_chars(
+          countLiteral.data(),
+          countLiteral.data() + countLiteral.size(),
+          count);
+        if (ec != std::errc{})
+          return {"Invalid count"};
+      }
+
+      std::vector<std::string> response{
+        std::format("Busiest commands of the {} server:", serverLiteral)};
+      for (auto& line : commandServer->GetMetrics().Format(count))
+        response.emplace_back(std::move(line));
+
+      return response;
+    });
+
+  // capture command
+  _commandManager.RegisterCommand(
+    "capture",
+    [this](
+      const std::span<const std::string>& arguments,
+      data::Uid characterUid) -> std::vector<std::string>
+    {
+      const auto invokerRank = GetRoleRank(characterUid);
+      if (not invokerRank || *invokerRank != data::Character::RoleRank::Admin)
+        return {};
+
+      if (arguments.size() < 2)
+        return {
+          "Invalid command sub-literal.",
+          "(//capture <server> <start/stop> [name])"};
+
+      const auto& serverLiteral = arguments[0];
+      const auto& actionLiteral = arguments[1];
+
+      network::TrafficRecorder* recorder = nullptr;
+      auto protocol = network::TrafficProtocol::Command;
+      if (const auto commandServer = _serverInstance.FindCommandServer(serverLiteral))
+      {
+        recorder = &commandServer->GetTrafficRecorder();
+      }
+      else if (const auto chatterServer = _serverInstance.FindChatterServer(serverLiteral))
+      {
+        recorder = &chatterServer->GetTrafficRecorder();
+        protocol = network::TrafficProtocol::Chatter;
+      }
+      else
+      {
+        return {"Unknown server, expected lobby, ranch, race, messenger, allchat or privatechat"};
+      }
+
+      if (actionLiteral == "stop")
+      {
+        if (not recorder->IsRecording())
+          return {std::format("Traffic of the {} server is not being captured", serverLiteral)};
+
+        recorder->Stop();
+        return {std::format("Stopped capturing traffic of the {} server", serverLiteral)};
+      }
+
+      if (actionLiteral != "start")
+        return {"Unknown action, expected start or stop"};
+
+      // Only the file name is used so the capture can't be written outside the capture directory.
+      const std::string captureName = arguments.size() > 2
+        ? std::filesystem::path(arguments[2]).filename().string()
+        : std::format(
+          "{}-{}",
+          serverLiteral,
+          std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+      if (captureName.empty())
+        return {"Invalid capture name"};
+
+      const auto capturePath = _serverInstance.GetResourceDirectory()
+        / "captures" / std::format("{}.acap", captureName);
+
+      try
+      {
+        std::filesystem::create_directories(capturePath.parent_path());
+        recorder->Start(capturePath, protocol, serverLiteral);
+      }
+      catch (const std::exception& x)
+      {
+        spdlog::error("Failed to start the traffic capture '{}': {}", capturePath.string(), x.what());
+        return {"Failed to start the capture, check the server log"};
+      }
+
+      return {
+        std::format(
+          "Capturing traffic of the {} server to '{}'",
+          serverLiteral,
+          capturePath.filename().string()),
+        "The capture contains personal data of the players, such as their chat messages"};
+    });
 }
 
 } // namespace server
@@ -20,6 +20,11 @@
 #include "server/telemetry/Telemetry.hpp"
 
 #include "server/ServerInstance.hpp"
+#include "server/lobby/LobbyNetworkHandler.hpp"
+#include "server/race/RaceNetworkHandler.hpp"
+
+#include <algorithm>
+#include <string_view>
 
 namespace server
 {
@@ -33,10 +38,44 @@ void PrepareTables(pqxx::connection& connection)
   tx.exec("create schema if not exists metrics");
   tx.exec("create table if not exists metrics.player_count_time_series(time bigint primary key, value int);");
   tx.exec("create table if not exists metrics.room_count_time_series(time bigint primary key, value int);");
+  tx.exec("create table if not exists metrics.outbound_queue_bytes_time_series(time bigint primary key, value bigint);");
+  tx.exec("create table if not exists metrics.deferred_command_count_time_series(time bigint primary key, value int);");
+  tx.exec("create table if not exists metrics.deferred_command_wait_time_series(time bigint primary key, value bigint);");
+  tx.exec("create table if not exists metrics.director_tick_duration_time_series(time bigint primary key, value bigint);");
+  tx.exec("create table if not exists metrics.director_missed_deadline_time_series(time bigint primary key, value int);");
 
   tx.commit();
 }
 
+//! Streams the data points of the time series to the table and clears them.
+//! @param tx Transaction.
+//! @param table Name of the table.
+//! @param timeSeries Time series data.
+template <typename T, size_t HistorySize>
+void WriteTimeSeries(
+  pqxx::work& tx,
+  std::string_view table,
+  TimeSeriesData<T, HistorySize>& timeSeries)
+{
+  using TimeSeries = TimeSeriesData<T, HistorySize>;
+
+  auto stream = pqxx::stream_to::raw_table(tx, table);
+  timeSeries.GetAndClearData([&stream](auto& data)
+    {
+      for (const auto& [timePoint, value] : data)
+      {
+        if (timePoint == TimeSeries::Clock::time_point::min())
+          continue;
+
+        stream.write_values(
+          std::chrono::duration_cast<std::chrono::seconds>(timePoint.time_since_epoch()).count(),
+          value);
+      }
+    });
+
+  stream.complete();
+}
+
 } // anon namespace
 
 Telemetry::Telemetry(ServerInstance& serverInstance)
@@ -81,6 +120,11 @@ void Telemetry::Tick()
   _scheduler.Tick();
 }
 
+Scheduler::Clock::time_point Telemetry::GetNextTickTime()
+{
+  return _scheduler.GetNextDueTime();
+}
+
 void Telemetry::ConnectPostgresBackend()
 {
   const auto& settings = _serverInstance.GetSettings();
@@ -109,8 +153,53 @@ void Telemetry::CollectData()
   const auto playerCount = _serverInstance.GetLobbyDirector().GetUserCount();
   const auto roomCount = _serverInstance.GetRoomSystem().GetRoomCount();
 
+  // Outbound queue depth of the slowest client of the command servers.
+  size_t outboundQueueBytes = 0;
+  for (auto* commandServer : {
+    &_serverInstance.GetLobbyDirector().GetNetworkHandler().GetCommandServer(),
+    &_serverInstance.GetRanchDirector().GetCommandServer(),
+    &_serverInstance.GetRaceDirector().GetNetworkHandler().GetCommandServer()})
+  {
+    outboundQueueBytes = std::max(
+      outboundQueueBytes,
+      commandServer->GetWriteQueueStats().maxQueuedBytes);
+  }
+
   _playerCountMetric.Collect(playerCount);
   _roomCountMetric.Collect(roomCount);
+  _outboundQueueBytesMetric.Collect(outboundQueueBytes);
+
+  // Mean wait of the deferred commands completed since the previous collection.
+  const auto deferredCommandMetrics = _serverInstance.GetRanchDirector().GetDeferredCommandMetrics();
+  const auto& waitTime = deferredCommandMetrics.waitTime;
+
+  size_t deferredCommandWait = 0;
+  if (waitTime.count > _deferredCommandWaitCount)
+  {
+    const auto meanWait = (waitTime.total - _deferredCommandWaitTotal)
+      / (waitTime.count - _deferredCommandWaitCount);
+    deferredCommandWait = std::chrono::duration_cast<std::chrono::milliseconds>(meanWait).count();
+  }
+
+  _deferredCommandWaitCount = waitTime.count;
+  _deferredCommandWaitTotal = waitTime.total;
+
+  _deferredCommandCountMetric.Collect(deferredCommandMetrics.depth);
+  _deferredCommandWaitMetric.Collect(deferredCommandWait);
+
+  // Slowest and most late of the directors since the previous collection.
+  size_t directorTickDuration = 0;
+  size_t directorMissedDeadlines = 0;
+  for (const auto& directorMetrics : _serverInstance.CollectDirectorTickMetrics())
+  {
+    directorTickDuration = std::max<size_t>(
+      directorTickDuration,
+      std::chrono::duration_cast<std::chrono::microseconds>(directorMetrics.tickDurations.p99).count());
+    directorMissedDeadlines += directorMetrics.missedDeadlineCount;
+  }
+
+  _directorTickDurationMetric.Collect(directorTickDuration);
+  _directorMissedDeadlineMetric.Collect(directorMissedDeadlines);
 }
 
 void Telemetry::ScheduleCollectData()
@@ -140,36 +229,14 @@ void Telemetry::SynchronizeData()
   {
     pqxx::work tx(*_connection);
 
-    auto playerCountStream = pqxx::stream_to::raw_table(tx, "metrics.player_count_time_series");
-    _playerCountMetric.GetAndClearData([&playerCountStream](auto& data)
-      {
-        for (const auto& [timePoint, value] : data)
-        {
-          if (timePoint == decltype(_playerCountMetric)::Clock::time_point::min())
-            continue;
-
-          playerCountStream.write_values(
-            std::chrono::duration_cast<std::chrono::seconds>(timePoint.time_since_epoch()).count(),
-            value);
-        }
-      });
-    playerCountStream.complete();
-
-    auto roomCountStream = pqxx::stream_to::raw_table(tx, "metrics.room_count_time_series");
-    _roomCountMetric.GetAndClearData([&roomCountStream](auto& data)
-      {
-        for (const auto& [timePoint, value] : data)
-        {
-          if (timePoint == decltype(_playerCountMetric)::Clock::time_point::min())
-            continue;
-
-          roomCountStream.write_values(
-            std::chrono::duration_cast<std::chrono::seconds>(timePoint.time_since_epoch()).count(),
-            value);
-        }
-      });
-
-    roomCountStream.complete();
+    WriteTimeSeries(tx, "metrics.player_count_time_series", _playerCountMetric);
+    WriteTimeSeries(tx, "metrics.room_count_time_series", _roomCountMetric);
+    WriteTimeSeries(tx, "metrics.outbound_queue_bytes_time_series", _outboundQueueBytesMetric);
+    WriteTimeSeries(tx, "metrics.deferred_command_count_time_series", _deferredCommandCountMetric);
+    WriteTimeSeries(tx, "metrics.deferred_command_wait_time_series", _deferredCommandWaitMetric);
+    WriteTimeSeries(tx, "metrics.director_tick_duration_time_series", _directorTickDurationMetric);
+    WriteTimeSeries(tx, "metrics.director_missed_deadline_time_series", _directorMissedDeadlineMetric);
+
     tx.commit();
   }
   catch (const pqxx::broken_connection&)
@@ -34,13 +34,19 @@ RaceTracker::Racer& RaceTracker::AddRacer(data::Uid characterUid)
     ++_nextCharacterOid;
 
   racerIter->second.oid = oidIter->second;
+  _racerOids[oidIter->second] = characterUid;
 
   return racerIter->second;
 }
 
 void RaceTracker::RemoveRacer(data::Uid characterUid)
 {
-  _racers.erase(characterUid);
+  const auto racerIter = _racers.find(characterUid);
+  if (racerIter == _racers.cend())
+    return;
+
+  _racerOids.erase(racerIter->second.oid);
+  _racers.erase(racerIter);
 }
 
 bool RaceTracker::IsRacer(data::Uid characterUid) const
@@ -62,6 +68,15 @@ RaceTracker::RacerObjectMap& RaceTracker::GetRacers()
   return _racers;
 }
 
+RaceTracker::Racer* RaceTracker::FindRacerByOid(const Oid oid)
+{
+  const auto oidIter = _racerOids.find(oid);
+  if (oidIter == _racerOids.cend())
+    return nullptr;
+
+  return &_racers.at(oidIter->second);
+}
+
 RaceTracker::ItemDeck& RaceTracker::AddItemDeck()
 {
   const auto [itemIter, created] = _itemDecks.try_emplace(_nextItemDeckOid);
@@ -167,6 +182,7 @@ uint16_t RaceTracker::GetNextEffectInstanceIdAndIncrementBy(uint16_t increment)
 void RaceTracker::Clear()
 {
   _racers.clear();
+  _racerOids.clear();
   _itemDecks.clear();
   _events.clear();
   _nextItemDeckOid = 1;
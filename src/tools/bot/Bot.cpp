@@ -0,0 +1,555 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "Bot.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <format>
+
+namespace bot
+{
+
+namespace
+{
+
+//! Interval of the lobby heartbeats. The lobby disconnects clients silent for a minute.
+constexpr auto HeartbeatInterval = std::chrono::seconds(20);
+
+//! Delay before the leader retries to start a race which was cancelled.
+constexpr auto StartRaceRetryDelay = std::chrono::seconds(1);
+
+//! Constants the lobby expects in the login request.
+constexpr uint16_t LoginConstant0 = 50;
+constexpr uint16_t LoginConstant1 = 281;
+
+//! TID of the horse requested with a new nickname.
+constexpr uint32_t NewCharacterHorseTid = 20001;
+
+//! Epoch of the snapshot timestamps shared by all the bots.
+const Clock::time_point SnapshotEpoch = Clock::now();
+
+//! Returns the snapshot timestamp in microseconds, wrapping around every ~71 minutes.
+uint32_t GetSnapshotTime()
+{
+  return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+    Clock::now() - SnapshotEpoch).count());
+}
+
+} // anon namespace
+
+Bot::Bot(
+  asio::io_context& ioContext,
+  const Options& options,
+  Metrics& metrics,
+  Group& group,
+  const std::size_t index,
+  const bool isLeader)
+  : _options(options)
+  , _metrics(metrics)
+  , _group(group)
+  , _index(index)
+  , _isLeader(isLeader)
+  , _ioContext(ioContext)
+  , _strand(asio::make_strand(ioContext))
+  , _heartbeatTimer(_strand)
+  , _activityTimer(_strand)
+  , _phaseTimer(_strand)
+{
+}
+
+void Bot::Start()
+{
+  asio::dispatch(_strand, [self = shared_from_this()]()
+  {
+    self->ConnectLobby();
+  });
+}
+
+void Bot::Stop()
+{
+  asio::dispatch(_strand, [self = shared_from_this()]()
+  {
+    self->_isStopped = true;
+    self->_heartbeatTimer.cancel();
+    self->_activityTimer.cancel();
+    self->_phaseTimer.cancel();
+
+    for (const auto& connection : {self->_lobby, self->_ranch, self->_race})
+    {
+      if (connection)
+        connection->Close();
+    }
+  });
+}
+
+void Bot::BindFailure(
+  server::CommandConnection& connection,
+  const server::protocol::Command commandId)
+{
+  connection.RegisterCommandHandler(
+    commandId,
+    [self = shared_from_this(), commandId](server::SourceStream&)
+    {
+      asio::dispatch(self->_strand, [self, commandId]()
+      {
+        self->Fail(std::format(
+          "Received the failure command '{}'",
+          server::protocol::GetCommandName(commandId)));
+      });
+    });
+}
+
+void Bot::Fail(const std::string_view reason)
+{
+  if (_isStopped)
+    return;
+
+  spdlog::warn("Bot {} failed: {}", _index, reason);
+  ++_metrics.failures;
+  Stop();
+}
+
+void Bot::ConnectLobby()
+{
+  _lobby = std::make_shared<server::CommandConnection>(_ioContext);
+
+  Bind(*_lobby, &Bot::HandleLoginOK);
+  Bind(*_lobby, &Bot::HandleEnterRanchLobbyOK);
+  Bind(*_lobby, &Bot::HandleMakeRoomOK);
+  Bind(*_lobby, &Bot::HandleEnterRoomLobbyOK);
+  _lobby->RegisterCommandHandler(
+    server::protocol::Command::AcCmdCLCreateNicknameNotify,
+    [self = shared_from_this()](server::SourceStream&)
+    {
+      asio::dispatch(self->_strand, [self]()
+      {
+        self->HandleCreateNicknameNotify();
+      });
+    });
+
+  for (const auto commandId : {
+    server::protocol::Command::AcCmdCLLoginCancel,
+    server::protocol::Command::AcCmdCLCreateNicknameCancel,
+    server::protocol::Command::AcCmdCLEnterRanchCancel,
+    server::protocol::Command::AcCmdCLMakeRoomCancel,
+    server::protocol::Command::AcCmdCLEnterRoomCancel})
+  {
+    BindFailure(*_lobby, commandId);
+  }
+
+  _lobby->SetDisconnectHandler([self = shared_from_this()]()
+  {
+    asio::dispatch(self->_strand, [self]()
+    {
+      self->Fail("Disconnected from the lobby");
+    });
+  });
+
+  _requestTime = Clock::now();
+  _lobby->Connect(
+    _options.lobbyEndpoint,
+    [self = shared_from_this()](const bool isConnected)
+    {
+      asio::dispatch(self->_strand, [self, isConnected]()
+      {
+        if (not isConnected)
+        {
+          self->Fail("Couldn't connect to the lobby");
+          return;
+        }
+
+        const auto now = Clock::now();
+        self->_metrics.connect.Record(now - self->_requestTime);
+        self->_requestTime = now;
+
+        self->_lobby->Send(server::protocol::AcCmdCLLogin{
+          .constant0 = LoginConstant0,
+          .constant1 = LoginConstant1,
+          .loginId = std::format("{}{}", self->_options.namePrefix, self->_index),
+          .authKey = "bot"});
+      });
+    });
+}
+
+void Bot::HandleCreateNicknameNotify()
+{
+  _lobby->Send(server::protocol::AcCmdCLCreateNickname{
+    .nickname = std::format("{}{}", _options.namePrefix, _index),
+    .requestedHorseTid = NewCharacterHorseTid});
+}
+
+void Bot::HandleLoginOK(const server::protocol::LobbyCommandLoginOK& command)
+{
+  // The server resets the code of the connection after the login.
+  _lobby->ResetCode();
+
+  _metrics.login.Record(Clock::now() - _requestTime);
+  ++_metrics.loggedIn;
+
+  _characterUid = command.uid;
+  ScheduleHeartbeat();
+
+  if (_isLeader)
+    _group.rancherUid.Publish(_characterUid);
+
+  _group.rancherUid.Wait([self = shared_from_this()](const uint32_t rancherUid)
+  {
+    asio::dispatch(self->_strand, [self, rancherUid]()
+    {
+      if (not self->_isStopped)
+        self->EnterRanch(rancherUid);
+    });
+  });
+}
+
+void Bot::ScheduleHeartbeat()
+{
+  _heartbeatTimer.expires_after(HeartbeatInterval);
+  _heartbeatTimer.async_wait([self = shared_from_this()](const boost::system::error_code& error)
+  {
+    if (error || self->_isStopped)
+      return;
+
+    self->_lobby->Send(server::protocol::AcCmdCLHeartbeat{});
+    self->ScheduleHeartbeat();
+  });
+}
+
+void Bot::EnterRanch(const uint32_t rancherUid)
+{
+  server::protocol::AcCmdCLEnterRanch command{};
+  command.rancherUid = rancherUid;
+  _lobby->Send(command);
+}
+
+void Bot::HandleEnterRanchLobbyOK(const server::protocol::AcCmdCLEnterRanchOK& command)
+{
+  _ranch = std::make_shared<server::CommandConnection>(_ioContext);
+
+  Bind(*_ranch, &Bot::HandleEnterRanchOK);
+  Bind(*_ranch, &Bot::HandleSnapshotNotify);
+  BindFailure(*_ranch, server::protocol::Command::AcCmdCREnterRanchCancel);
+
+  _ranch->SetDisconnectHandler([self = shared_from_this()]()
+  {
+    asio::dispatch(self->_strand, [self]()
+    {
+      self->Fail("Disconnected from the ranch");
+    });
+  });
+
+  const asio::ip::tcp::endpoint endpoint(
+    asio::ip::address_v4(command.ranchAddress),
+    command.ranchPort);
+
+  _ranch->Connect(
+    endpoint,
+    [self = shared_from_this(), command](const bool isConnected)
+    {
+      asio::dispatch(self->_strand, [self, command, isConnected]()
+      {
+        if (not isConnected)
+        {
+          self->Fail("Couldn't connect to the ranch");
+          return;
+        }
+
+        self->_ranch->Send(server::protocol::AcCmdCREnterRanch{
+          .characterUid = self->_characterUid,
+          .otp = command.otp,
+          .rancherUid = command.rancherUid});
+      });
+    });
+}
+
+void Bot::HandleEnterRanchOK(const server::protocol::AcCmdCREnterRanchOK& command)
+{
+  // The server resets the code of the connection after entering the ranch.
+  _ranch->ResetCode();
+
+  const auto characterIter = std::ranges::find(
+    command.characters,
+    _characterUid,
+    &server::protocol::RanchCharacter::uid);
+  if (characterIter == command.characters.cend())
+  {
+    Fail("The ranch does not list the character of the bot");
+    return;
+  }
+
+  _oid = characterIter->oid;
+  ++_metrics.inRanch;
+
+  ScheduleSnapshot();
+
+  if (_options.ranchOnly)
+    return;
+
+  _phaseTimer.expires_after(_options.ranchDuration);
+  _phaseTimer.async_wait([self = shared_from_this()](const boost::system::error_code& error)
+  {
+    if (error || self->_isStopped)
+      return;
+
+    self->LeaveRanch();
+  });
+}
+
+void Bot::HandleSnapshotNotify(const server::protocol::RanchCommandRanchSnapshotNotify& command)
+{
+  if (command.type != server::protocol::AcCmdCRRanchSnapshot::Full)
+    return;
+
+  // The timestamps are shared by the bots of this process, the unsigned
+  // difference accounts for the wrap around.
+  const uint32_t latency = GetSnapshotTime() - command.full.time;
+  _metrics.snapshotFanOut.Record(std::chrono::microseconds(latency));
+  ++_metrics.snapshotsReceived;
+}
+
+void Bot::ScheduleSnapshot()
+{
+  _activityTimer.expires_after(_options.snapshotInterval);
+  _activityTimer.async_wait([self = shared_from_this()](const boost::system::error_code& error)
+  {
+    if (error || self->_isStopped || not self->_ranch)
+      return;
+
+    server::protocol::AcCmdCRRanchSnapshot snapshot{
+      .type = server::protocol::AcCmdCRRanchSnapshot::Full};
+    snapshot.full.ranchIndex = self->_oid;
+    snapshot.full.time = GetSnapshotTime();
+
+    self->_ranch->Send(snapshot);
+    ++self->_metrics.snapshotsSent;
+
+    self->ScheduleSnapshot();
+  });
+}
+
+void Bot::LeaveRanch()
+{
+  _activityTimer.cancel();
+
+  // The connection is closed without the disconnect handler.
+  _ranch->Close();
+  _ranch.reset();
+  --_metrics.inRanch;
+
+  if (_isLeader)
+  {
+    MakeRoom();
+    return;
+  }
+
+  _group.roomUid.Wait([self = shared_from_this()](const uint32_t roomUid)
+  {
+    asio::dispatch(self->_strand, [self, roomUid]()
+    {
+      if (not self->_isStopped)
+        self->EnterRoom(roomUid);
+    });
+  });
+}
+
+void Bot::MakeRoom()
+{
+  server::protocol::AcCmdCLMakeRoom command{};
+  command.name = std::format("{} {}", _options.namePrefix, _index);
+  command.playerCount = static_cast<uint8_t>(_options.groupSize);
+  command.gameMode = server::protocol::GameMode::Speed;
+  command.teamMode = server::protocol::TeamMode::FFA;
+  _lobby->Send(command);
+}
+
+void Bot::HandleMakeRoomOK(const server::protocol::AcCmdCLMakeRoomOK& command)
+{
+  ConnectRace(
+    asio::ip::tcp::endpoint(
+      asio::ip::address_v4(command.raceServerAddress),
+      command.raceServerPort),
+    command.roomUid,
+    command.oneTimePassword);
+}
+
+void Bot::EnterRoom(const uint32_t roomUid)
+{
+  _lobby->Send(server::protocol::AcCmdCLEnterRoom{
+    .roomUid = roomUid,
+    .enterRoomType = server::protocol::AcCmdCLEnterRoom::EnterRoomType::RoomList});
+}
+
+void Bot::HandleEnterRoomLobbyOK(const server::protocol::AcCmdCLEnterRoomOK& command)
+{
+  ConnectRace(
+    asio::ip::tcp::endpoint(
+      asio::ip::address_v4(command.raceServerAddress),
+      command.raceServerPort),
+    command.roomUid,
+    command.oneTimePassword);
+}
+
+void Bot::ConnectRace(
+  const asio::ip::tcp::endpoint endpoint,
+  const uint32_t roomUid,
+  const uint32_t oneTimePassword)
+{
+  _roomUid = roomUid;
+  _race = std::make_shared<server::CommandConnection>(_ioContext);
+
+  Bind(*_race, &Bot::HandleReadyRaceNotify);
+  Bind(*_race, &Bot::HandleStartRaceNotify);
+  Bind(*_race, &Bot::HandleRaceTimerOK);
+  _race->RegisterCommandHandler(
+    server::protocol::Command::AcCmdCREnterRoomOK,
+    [self = shared_from_this()](server::SourceStream&)
+    {
+      asio::dispatch(self->_strand, [self]()
+      {
+        self->HandleEnterRoomOK();
+      });
+    });
+  _race->RegisterCommandHandler(
+    server::protocol::Command::AcCmdCRStartRaceCancel,
+    [self = shared_from_this()](server::SourceStream&)
+    {
+      asio::dispatch(self->_strand, [self]()
+      {
+        self->HandleStartRaceCancel();
+      });
+    });
+  BindFailure(*_race, server::protocol::Command::AcCmdCREnterRoomCancel);
+
+  _race->SetDisconnectHandler([self = shared_from_this()]()
+  {
+    asio::dispatch(self->_strand, [self]()
+    {
+      self->Fail("Disconnected from the race");
+    });
+  });
+
+  _race->Connect(
+    endpoint,
+    [self = shared_from_this(), roomUid, oneTimePassword](const bool isConnected)
+    {
+      asio::dispatch(self->_strand, [self, roomUid, oneTimePassword, isConnected]()
+      {
+        if (not isConnected)
+        {
+          self->Fail("Couldn't connect to the race");
+          return;
+        }
+
+        self->_race->Send(server::protocol::AcCmdCREnterRoom{
+          .characterUid = self->_characterUid,
+          .oneTimePassword = oneTimePassword,
+          .roomUid = roomUid});
+      });
+    });
+}
+
+void Bot::HandleEnterRoomOK()
+{
+  // The server resets the code of the connection after entering the room.
+  _race->ResetCode();
+
+  if (_isLeader)
+  {
+    // The first client in the room becomes its master,
+    // so the members enter only after the leader.
+    _group.roomUid.Publish(_roomUid);
+
+    // A group of one has nobody to wait for.
+    if (_options.groupSize <= 1)
+      _race->Send(server::protocol::AcCmdCRStartRace{});
+    return;
+  }
+
+  _race->Send(server::protocol::AcCmdCRReadyRace{});
+}
+
+void Bot::HandleReadyRaceNotify(const server::protocol::AcCmdCRReadyRaceNotify& command)
+{
+  if (not _isLeader || command.characterUid == _characterUid)
+    return;
+
+  if (command.isReady)
+    ++_readyMembers;
+  else if (_readyMembers > 0)
+    --_readyMembers;
+
+  if (_readyMembers + 1 >= _options.groupSize)
+    _race->Send(server::protocol::AcCmdCRStartRace{});
+}
+
+void Bot::HandleStartRaceCancel()
+{
+  if (not _isLeader)
+    return;
+
+  // Some of the members are not ready yet, try again later.
+  _phaseTimer.expires_after(StartRaceRetryDelay);
+  _phaseTimer.async_wait([self = shared_from_this()](const boost::system::error_code& error)
+  {
+    if (error || self->_isStopped)
+      return;
+
+    self->_race->Send(server::protocol::AcCmdCRStartRace{});
+  });
+}
+
+void Bot::HandleStartRaceNotify(const server::protocol::AcCmdCRStartRaceNotify& command)
+{
+  // The host is the recipient of the notify.
+  _oid = command.hostOid;
+  ++_metrics.inRace;
+
+  _race->Send(server::protocol::AcCmdCRLoadingComplete{});
+  SchedulePosition();
+}
+
+void Bot::SchedulePosition()
+{
+  _activityTimer.expires_after(_options.positionInterval);
+  _activityTimer.async_wait([self = shared_from_this()](const boost::system::error_code& error)
+  {
+    if (error || self->_isStopped)
+      return;
+
+    self->_race->Send(server::protocol::AcCmdUserRaceUpdatePos{
+      .oid = self->_oid});
+
+    // The position has no response, the timer request following it
+    // measures the round trip of the race connection.
+    self->_race->Send(server::protocol::AcCmdUserRaceTimer{
+      .clientClock = static_cast<uint64_t>(Clock::now().time_since_epoch().count())});
+    ++self->_metrics.positionsSent;
+
+    self->SchedulePosition();
+  });
+}
+
+void Bot::HandleRaceTimerOK(const server::protocol::AcCmdUserRaceTimerOK& command)
+{
+  const auto sentTime = Clock::time_point(Clock::duration(command.clientRaceClock));
+  _metrics.positionRoundTrip.Record(Clock::now() - sentTime);
+}
+
+} // namespace bot
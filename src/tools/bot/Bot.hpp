@@ -0,0 +1,250 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#ifndef ALICIA_BOT_BOT_HPP
+#define ALICIA_BOT_BOT_HPP
+
+#include <libserver/network/command/CommandConnection.hpp>
+#include <libserver/network/command/proto/LobbyMessageDefinitions.hpp>
+#include <libserver/network/command/proto/RaceMessageDefinitions.hpp>
+#include <libserver/network/command/proto/RanchMessageDefinitions.hpp>
+#include <libserver/util/LatencyHistogram.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bot
+{
+
+namespace asio = boost::asio;
+
+using Clock = std::chrono::steady_clock;
+
+//! Options of the load generator.
+struct Options
+{
+  //! Endpoint of the lobby server.
+  asio::ip::tcp::endpoint lobbyEndpoint{asio::ip::make_address_v4("127.0.0.1"), 10030};
+  //! Count of the bots.
+  std::size_t botCount{1};
+  //! Count of the bots spawned per second.
+  std::size_t spawnRate{50};
+  //! Count of the bots sharing a ranch and a room. The first bot of a group leads it.
+  std::size_t groupSize{4};
+  //! Count of the I/O threads.
+  std::size_t threadCount{1};
+  //! Duration the bots spend in the ranch.
+  std::chrono::seconds ranchDuration{10};
+  //! Duration of the whole run.
+  std::chrono::seconds duration{60};
+  //! Interval of the ranch snapshots.
+  std::chrono::milliseconds snapshotInterval{100};
+  //! Interval of the race positions.
+  std::chrono::milliseconds positionInterval{100};
+  //! Prefix of the login IDs and the nicknames of the bots.
+  std::string namePrefix{"bot"};
+  //! Whether the bots stay in the ranch instead of racing.
+  bool ranchOnly{false};
+};
+
+//! Metrics shared by all the bots.
+struct Metrics
+{
+  //! Latency of the connection to the lobby.
+  server::LatencyHistogram connect;
+  //! Latency from the login request to the login response.
+  server::LatencyHistogram login;
+  //! Latency from a ranch snapshot being sent to it being received by another bot.
+  server::LatencyHistogram snapshotFanOut;
+  //! Latency from a race position being sent to the race timer response following it.
+  server::LatencyHistogram positionRoundTrip;
+
+  std::atomic<uint64_t> loggedIn{};
+  std::atomic<uint64_t> inRanch{};
+  std::atomic<uint64_t> inRace{};
+  std::atomic<uint64_t> snapshotsSent{};
+  std::atomic<uint64_t> snapshotsReceived{};
+  std::atomic<uint64_t> positionsSent{};
+  std::atomic<uint64_t> failures{};
+};
+
+//! A value published by the leader of a group to its members.
+template <typename T>
+class GroupValue
+{
+public:
+  using Waiter = std::function<void(T value)>;
+
+  //! Publishes the value and notifies the waiters.
+  //! @param value Value.
+  void Publish(T value)
+  {
+    std::vector<Waiter> waiters;
+    {
+      std::scoped_lock lock(_mutex);
+      _value = value;
+      waiters.swap(_waiters);
+    }
+
+    for (auto& waiter : waiters)
+      waiter(value);
+  }
+
+  //! Calls the waiter once the value is published.
+  //! @param waiter Waiter.
+  void Wait(Waiter waiter)
+  {
+    std::unique_lock lock(_mutex);
+    if (not _value)
+    {
+      _waiters.emplace_back(std::move(waiter));
+      return;
+    }
+
+    const auto value = *_value;
+    lock.unlock();
+    waiter(value);
+  }
+
+private:
+  std::mutex _mutex;
+  std::optional<T> _value;
+  std::vector<Waiter> _waiters;
+};
+
+//! A group of bots sharing a ranch and a room.
+struct Group
+{
+  //! UID of the character of the leader, whose ranch the group visits.
+  GroupValue<uint32_t> rancherUid;
+  //! UID of the room made by the leader.
+  GroupValue<uint32_t> roomUid;
+};
+
+//! A scripted client going through the login, the ranch, the room and the race.
+class Bot final
+  : public std::enable_shared_from_this<Bot>
+{
+public:
+  //! Constructor.
+  //! @param ioContext I/O context of the bot.
+  //! @param options Options of the load generator.
+  //! @param metrics Shared metrics.
+  //! @param group Group of the bot.
+  //! @param index Index of the bot.
+  //! @param isLeader Whether the bot leads its group.
+  Bot(
+    asio::io_context& ioContext,
+    const Options& options,
+    Metrics& metrics,
+    Group& group,
+    std::size_t index,
+    bool isLeader);
+
+  //! Starts the bot.
+  void Start();
+  //! Stops the bot.
+  void Stop();
+
+private:
+  //! Binds a command handler of a connection to the strand of the bot.
+  template <typename C>
+  void Bind(
+    server::CommandConnection& connection,
+    void (Bot::*handler)(const C&))
+  {
+    connection.RegisterCommandHandler<C>(
+      [self = shared_from_this(), handler](const C& command)
+      {
+        asio::dispatch(self->_strand, [self, handler, command]()
+        {
+          if (not self->_isStopped)
+            (self.get()->*handler)(command);
+        });
+      });
+  }
+
+  //! Binds a handler of a failure command of a connection to the strand of the bot.
+  void BindFailure(
+    server::CommandConnection& connection,
+    server::protocol::Command commandId);
+
+  //! Fails the bot.
+  //! @param reason Reason of the failure.
+  void Fail(std::string_view reason);
+
+  void ConnectLobby();
+  void HandleCreateNicknameNotify();
+  void HandleLoginOK(const server::protocol::LobbyCommandLoginOK& command);
+  void ScheduleHeartbeat();
+
+  void EnterRanch(uint32_t rancherUid);
+  void HandleEnterRanchLobbyOK(const server::protocol::AcCmdCLEnterRanchOK& command);
+  void HandleEnterRanchOK(const server::protocol::AcCmdCREnterRanchOK& command);
+  void HandleSnapshotNotify(const server::protocol::RanchCommandRanchSnapshotNotify& command);
+  void ScheduleSnapshot();
+  void LeaveRanch();
+
+  void MakeRoom();
+  void HandleMakeRoomOK(const server::protocol::AcCmdCLMakeRoomOK& command);
+  void EnterRoom(uint32_t roomUid);
+  void HandleEnterRoomLobbyOK(const server::protocol::AcCmdCLEnterRoomOK& command);
+  void ConnectRace(
+    asio::ip::tcp::endpoint endpoint,
+    uint32_t roomUid,
+    uint32_t oneTimePassword);
+  void HandleEnterRoomOK();
+  void HandleReadyRaceNotify(const server::protocol::AcCmdCRReadyRaceNotify& command);
+  void HandleStartRaceCancel();
+  void HandleStartRaceNotify(const server::protocol::AcCmdCRStartRaceNotify& command);
+  void SchedulePosition();
+  void HandleRaceTimerOK(const server::protocol::AcCmdUserRaceTimerOK& command);
+
+  const Options& _options;
+  Metrics& _metrics;
+  Group& _group;
+  const std::size_t _index;
+  const bool _isLeader;
+
+  asio::io_context& _ioContext;
+  //! Strand the state of the bot is accessed on.
+  asio::strand<asio::io_context::executor_type> _strand;
+  asio::steady_timer _heartbeatTimer;
+  asio::steady_timer _activityTimer;
+  asio::steady_timer _phaseTimer;
+
+  std::shared_ptr<server::CommandConnection> _lobby;
+  std::shared_ptr<server::CommandConnection> _ranch;
+  std::shared_ptr<server::CommandConnection> _race;
+
+  Clock::time_point _requestTime{};
+  uint32_t _characterUid{};
+  uint16_t _oid{};
+  uint32_t _roomUid{};
+  std::size_t _readyMembers{};
+  bool _isStopped{false};
+};
+
+} // namespace bot
+
+#endif // ALICIA_BOT_BOT_HPP
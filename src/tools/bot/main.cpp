@@ -0,0 +1,243 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "Bot.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <charconv>
+#include <deque>
+#include <thread>
+
+namespace
+{
+
+//! Interval of the progress reports.
+constexpr auto ReportInterval = std::chrono::seconds(5);
+
+void PrintUsage()
+{
+  spdlog::info("Usage: alicia-bot [options]");
+  spdlog::info("  --host <address>        address of the lobby (default 127.0.0.1)");
+  spdlog::info("  --port <port>           port of the lobby (default 10030)");
+  spdlog::info("  --bots <count>          count of the bots (default 1)");
+  spdlog::info("  --rate <count>          bots spawned per second (default 50)");
+  spdlog::info("  --group <count>         bots sharing a ranch and a room (default 4)");
+  spdlog::info("  --threads <count>       I/O threads (default 1)");
+  spdlog::info("  --ranch-time <seconds>  time spent in the ranch (default 10)");
+  spdlog::info("  --duration <seconds>    duration of the run (default 60)");
+  spdlog::info("  --snapshot-ms <ms>      interval of the ranch snapshots (default 100)");
+  spdlog::info("  --position-ms <ms>      interval of the race positions (default 100)");
+  spdlog::info("  --prefix <name>         prefix of the bot names (default bot)");
+  spdlog::info("  --ranch-only            stay in the ranch instead of racing");
+}
+
+template <typename T>
+bool ParseNumber(const std::string_view literal, T& value)
+{
+  const auto [ptr, ec] = std::from_chars(
+    literal.data(),
+    literal.data() + literal.size(),
+    value);
+  return ec == std::errc{} && ptr == literal.data() + literal.size();
+}
+
+bool ParseOptions(int argc, char** argv, bot::Options& options)
+{
+  std::string host = "127.0.0.1";
+  uint16_t port = options.lobbyEndpoint.port();
+
+  for (int idx = 1; idx < argc; ++idx)
+  {
+    const std::string_view option = argv[idx];
+    if (option == "--ranch-only")
+    {
+      options.ranchOnly = true;
+      continue;
+    }
+
+    if (idx + 1 >= argc)
+      return false;
+    const std::string_view value = argv[++idx];
+
+    uint64_t number{};
+    const bool isNumber = ParseNumber(value, number);
+
+    if (option == "--host")
+      host = value;
+    else if (option == "--prefix")
+      options.namePrefix = value;
+    else if (not isNumber)
+      return false;
+    else if (option == "--port")
+      port = static_cast<uint16_t>(number);
+    else if (option == "--bots")
+      options.botCount = number;
+    else if (option == "--rate")
+      options.spawnRate = std::max<uint64_t>(number, 1);
+    else if (option == "--group")
+      options.groupSize = std::clamp<uint64_t>(number, 1, 8);
+    else if (option == "--threads")
+      options.threadCount = std::max<uint64_t>(number, 1);
+    else if (option == "--ranch-time")
+      options.ranchDuration = std::chrono::seconds(number);
+    else if (option == "--duration")
+      options.duration = std::chrono::seconds(number);
+    else if (option == "--snapshot-ms")
+      options.snapshotInterval = std::chrono::milliseconds(std::max<uint64_t>(number, 1));
+    else if (option == "--position-ms")
+      options.positionInterval = std::chrono::milliseconds(std::max<uint64_t>(number, 1));
+    else
+      return false;
+  }
+
+  boost::system::error_code error;
+  const auto address = boost::asio::ip::make_address_v4(host, error);
+  if (error)
+    return false;
+
+  options.lobbyEndpoint = {address, port};
+  return true;
+}
+
+void ReportHistogram(std::string_view name, const server::LatencyHistogram& histogram)
+{
+  const auto summary = histogram.Summarize();
+  const auto toMs = [](const server::LatencyHistogram::Duration duration)
+  {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  };
+
+  spdlog::info(
+    "  {:<20} count {:>9}  p50 {:>9.3f}ms  p99 {:>9.3f}ms  max {:>9.3f}ms",
+    name,
+    summary.count,
+    toMs(summary.p50),
+    toMs(summary.p99),
+    toMs(summary.max));
+}
+
+void Report(const bot::Metrics& metrics)
+{
+  spdlog::info(
+    "Bots: {} logged in, {} in ranch, {} in race, {} failed."
+    " Snapshots {} sent, {} received. Positions {} sent.",
+    metrics.loggedIn.load(),
+    metrics.inRanch.load(),
+    metrics.inRace.load(),
+    metrics.failures.load(),
+    metrics.snapshotsSent.load(),
+    metrics.snapshotsReceived.load(),
+    metrics.positionsSent.load());
+
+  ReportHistogram("connect", metrics.connect);
+  ReportHistogram("login", metrics.login);
+  ReportHistogram("snapshot fan-out", metrics.snapshotFanOut);
+  ReportHistogram("position round trip", metrics.positionRoundTrip);
+}
+
+} // anon namespace
+
+int main(int argc, char** argv)
+{
+  bot::Options options;
+  if (not ParseOptions(argc, argv, options))
+  {
+    PrintUsage();
+    return 1;
+  }
+
+  spdlog::info(
+    "Running {} bots in groups of {} against {}:{} for {}s",
+    options.botCount,
+    options.groupSize,
+    options.lobbyEndpoint.address().to_string(),
+    options.lobbyEndpoint.port(),
+    options.duration.count());
+
+  boost::asio::io_context ioContext;
+  auto workGuard = boost::asio::make_work_guard(ioContext);
+
+  std::vector<std::thread> threads;
+  for (std::size_t idx = 0; idx < options.threadCount; ++idx)
+  {
+    threads.emplace_back([&ioContext]()
+    {
+      ioContext.run();
+    });
+  }
+
+  bot::Metrics metrics;
+  // The groups must not move while the bots reference them.
+  std::deque<bot::Group> groups;
+  std::vector<std::shared_ptr<bot::Bot>> bots;
+  bots.reserve(options.botCount);
+
+  const auto start = bot::Clock::now();
+  const auto end = start + options.duration;
+  const auto spawnInterval = std::chrono::duration_cast<bot::Clock::duration>(
+    std::chrono::duration<double>(1.0 / static_cast<double>(options.spawnRate)));
+  auto nextReport = start + ReportInterval;
+
+  for (std::size_t idx = 0; idx < options.botCount && bot::Clock::now() < end; ++idx)
+  {
+    const bool isLeader = idx % options.groupSize == 0;
+    if (isLeader)
+      groups.emplace_back();
+
+    auto& bot = bots.emplace_back(std::make_shared<bot::Bot>(
+      ioContext,
+      options,
+      metrics,
+      groups.back(),
+      idx,
+      isLeader));
+    bot->Start();
+
+    std::this_thread::sleep_until(start + spawnInterval * (idx + 1));
+
+    if (bot::Clock::now() >= nextReport)
+    {
+      Report(metrics);
+      nextReport += ReportInterval;
+    }
+  }
+
+  while (bot::Clock::now() < end)
+  {
+    std::this_thread::sleep_until(std::min(nextReport, end));
+    if (bot::Clock::now() >= nextReport)
+    {
+      Report(metrics);
+      nextReport += ReportInterval;
+    }
+  }
+
+  for (const auto& bot : bots)
+    bot->Stop();
+
+  workGuard.reset();
+  for (auto& thread : threads)
+    thread.join();
+
+  spdlog::info("Final report after {} bots:", bots.size());
+  Report(metrics);
+
+  return metrics.failures.load() == 0 ? 0 : 2;
+}
@@ -0,0 +1,316 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "server/ServerInstance.hpp"
+
+#include <libserver/network/TrafficCapture.hpp>
+#include <libserver/network/command/proto/LobbyMessageDefinitions.hpp>
+#include <libserver/util/Stream.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <charconv>
+#include <chrono>
+#include <format>
+#include <functional>
+#include <optional>
+#include <thread>
+#include <unordered_set>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+//! Replayed client IDs are offset so they never collide with the IDs of the network clients.
+constexpr server::network::ClientId ReplayClientIdOffset = 1ull << 48;
+
+//! Max size of a login command, with the login ID and the auth key of their max length.
+constexpr std::size_t MaxLoginCommandSize = 512;
+//! Token of the accounts the logins are replayed with, the local authentication accepts any.
+constexpr std::string_view ReplayAccountToken = "replay";
+
+//! Replay target abstracting over the command and the chatter server.
+struct ReplayTarget
+{
+  std::function<void(server::network::ClientId)> connect;
+  std::function<void(server::network::ClientId)> disconnect;
+  std::function<void(server::network::ClientId, uint16_t, std::span<const std::byte>)> dispatch;
+};
+
+//! Isolates the replayed server from the production services.
+//! The servers listen on ephemeral ports of the loopback interface,
+//! the users are authenticated locally and no telemetry is collected.
+//! @param config Config to adjust.
+void IsolateSettings(server::Config& config)
+{
+  for (auto* listen : {
+    &config.lobby.listen,
+    &config.ranch.listen,
+    &config.race.listen,
+    &config.messenger.listen,
+    &config.allChat.listen,
+    &config.privateChat.listen,
+    &config.udpRaceRelay.listen})
+  {
+    listen->address = boost::asio::ip::address_v4::loopback();
+    listen->port = 0;
+  }
+
+  config.udpRaceRelay.inProcess = false;
+  config.authentication.backend = "local";
+  config.telemetry.enabled = false;
+}
+
+//! Rewrites a login, whose credentials were redacted from the capture,
+//! to log in to the replay account of the captured client.
+//! @param payload Payload of the captured login.
+//! @param accountName Name of the replay account.
+//! @returns Payload of the rewritten login.
+std::vector<std::byte> ReauthenticateLogin(
+  const std::span<const std::byte> payload,
+  const std::string& accountName)
+{
+  server::protocol::AcCmdCLLogin command;
+  server::SourceStream source(payload);
+  server::protocol::AcCmdCLLogin::Read(command, source);
+
+  command.loginId = accountName;
+  command.authKey = ReplayAccountToken;
+
+  std::vector<std::byte> rewritten(MaxLoginCommandSize);
+  server::SinkStream sink(rewritten);
+  server::protocol::AcCmdCLLogin::Write(command, sink);
+  rewritten.resize(sink.GetCursor());
+
+  return rewritten;
+}
+
+void PrintUsage()
+{
+  spdlog::info("Usage: alicia-replay <capture> [speed] [resource directory]");
+  spdlog::info("  speed - multiplier of the capture timing, 1 replays in real time,");
+  spdlog::info("          0 replays as fast as possible (default)");
+  spdlog::info("The replay modifies the data in the resource directory, replay against a copy.");
+  spdlog::info("The logins are replayed with the local accounts 'replay<client>', created on demand.");
+}
+
+} // anon namespace
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    PrintUsage();
+    return 1;
+  }
+
+  const std::filesystem::path capturePath = argv[1];
+
+  double speed = 0.0;
+  if (argc > 2)
+  {
+    const std::string_view speedLiteral = argv[2];
+    const auto [ptr, ec] = std::from_chars(
+      speedLiteral.data(),
+      speedLiteral.data() + speedLiteral.size(),
+      speed);
+    if (ec != std::errc{} || speed < 0.0)
+    {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  const std::filesystem::path resourceDirectory = argc > 3
+    ? std::filesystem::path(argv[3])
+    : std::filesystem::path();
+
+  std::optional<server::network::TrafficCaptureReader> reader;
+  try
+  {
+    reader.emplace(capturePath);
+  }
+  catch (const std::exception& x)
+  {
+    spdlog::error("Failed to open the capture: {}", x.what());
+    return 1;
+  }
+
+  const auto& header = reader->GetHeader();
+
+  server::ServerInstance serverInstance(resourceDirectory);
+  serverInstance.SetSettingsOverride(IsolateSettings);
+
+  ReplayTarget target;
+  if (header.protocol == server::network::TrafficProtocol::Command)
+  {
+    const auto commandServer = serverInstance.FindCommandServer(header.source);
+    if (commandServer == nullptr)
+    {
+      spdlog::error("Unknown command server '{}' in the capture", header.source);
+      return 1;
+    }
+
+    target.connect = [commandServer](const server::network::ClientId clientId)
+    {
+      commandServer->ReplayClientConnected(clientId);
+    };
+    target.disconnect = [commandServer](const server::network::ClientId clientId)
+    {
+      commandServer->ReplayClientDisconnected(clientId);
+    };
+    target.dispatch = [commandServer](
+      const server::network::ClientId clientId,
+      const uint16_t commandId,
+      const std::span<const std::byte> payload)
+    {
+      commandServer->ReplayCommand(
+        clientId,
+        static_cast<server::protocol::Command>(commandId),
+        payload);
+    };
+  }
+  else
+  {
+    const auto chatterServer = serverInstance.FindChatterServer(header.source);
+    if (chatterServer == nullptr)
+    {
+      spdlog::error("Unknown chatter server '{}' in the capture", header.source);
+      return 1;
+    }
+
+    target.connect = [chatterServer](const server::network::ClientId clientId)
+    {
+      chatterServer->ReplayClientConnected(clientId);
+    };
+    target.disconnect = [chatterServer](const server::network::ClientId clientId)
+    {
+      chatterServer->ReplayClientDisconnected(clientId);
+    };
+    target.dispatch = [chatterServer](
+      const server::network::ClientId clientId,
+      const uint16_t commandId,
+      const std::span<const std::byte> payload)
+    {
+      chatterServer->ReplayCommand(clientId, commandId, payload);
+    };
+  }
+
+  spdlog::info(
+    "Replaying the capture of the {} server from '{}'",
+    header.source,
+    capturePath.string());
+
+  serverInstance.Initialize();
+  // The directors initialize on their own threads.
+  if (not serverInstance.WaitForInitialization())
+  {
+    spdlog::error("Failed to initialize the server");
+    serverInstance.Terminate();
+    return 1;
+  }
+
+  const bool isLobbyCapture = header.protocol == server::network::TrafficProtocol::Command
+    && header.source == "lobby";
+
+  std::unordered_set<server::network::ClientId> connectedClients;
+  std::size_t replayedClients = 0;
+  std::size_t replayedCommands = 0;
+  std::size_t failedCommands = 0;
+
+  const auto replayStart = Clock::now();
+  try
+  {
+    while (auto record = reader->Next())
+    {
+      const auto clientId = record->clientId + ReplayClientIdOffset;
+
+      if (speed > 0.0)
+      {
+        const auto recordTime = std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double, std::micro>(record->timestamp / speed));
+        std::this_thread::sleep_until(replayStart + recordTime);
+      }
+
+      if (record->kind == server::network::TrafficRecordKind::Disconnect)
+      {
+        if (connectedClients.erase(clientId) > 0)
+          target.disconnect(clientId);
+        continue;
+      }
+
+      // The clients connected before the capture started have no connection record.
+      if (connectedClients.emplace(clientId).second)
+      {
+        target.connect(clientId);
+        ++replayedClients;
+      }
+
+      if (record->kind == server::network::TrafficRecordKind::Connect)
+        continue;
+
+      try
+      {
+        if (isLobbyCapture
+          && record->commandId == static_cast<uint16_t>(server::protocol::Command::AcCmdCLLogin))
+        {
+          record->payload = ReauthenticateLogin(
+            record->payload,
+            std::format("replay{}", record->clientId));
+        }
+
+        target.dispatch(clientId, record->commandId, record->payload);
+      }
+      catch (const std::exception& x)
+      {
+        spdlog::debug("Replayed command 0x{:x} failed: {}", record->commandId, x.what());
+        ++failedCommands;
+      }
+
+      ++replayedCommands;
+    }
+  }
+  catch (const std::exception& x)
+  {
+    spdlog::error("Failed to read the capture: {}", x.what());
+  }
+
+  for (const auto clientId : connectedClients)
+    target.disconnect(clientId);
+
+  const auto replayDuration = std::chrono::duration<double>(Clock::now() - replayStart);
+
+  spdlog::info(
+    "Replayed {} commands ({} failed) of {} clients in {:.3f}s, {:.0f} commands/s",
+    replayedCommands,
+    failedCommands,
+    replayedClients,
+    replayDuration.count(),
+    replayDuration.count() > 0.0 ? replayedCommands / replayDuration.count() : 0.0);
+
+  if (const auto commandServer = serverInstance.FindCommandServer(header.source))
+  {
+    for (const auto& line : commandServer->GetMetrics().Format(20))
+      spdlog::info("{}", line);
+  }
+
+  serverInstance.Terminate();
+  return failedCommands == 0 ? 0 : 2;
+}
@@ -0,0 +1,196 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#ifndef ALICIA_SERVER_BENCHMARK_HPP
+#define ALICIA_SERVER_BENCHMARK_HPP
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace benchmark
+{
+
+//! Prevents the compiler from optimizing away the value.
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  const volatile auto* pointer = &value;
+  (void)pointer;
+#endif
+}
+
+//! Runs benchmarks and reports their results.
+//!
+//! Every benchmark is run in batches of doubling iteration counts until
+//! a batch takes at least the minimal time, the last batch is reported.
+class Runner
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  //! Result of a benchmark.
+  struct Result
+  {
+    std::string name;
+    uint64_t iterations{};
+    double nanosecondsPerOperation{};
+    //! Bytes processed by a single operation, zero if not applicable.
+    std::size_t bytesPerOperation{};
+  };
+
+  //! Parses the command line options.
+  //! Supports `--json` for the machine-readable output, `--min-time-ms <ms>`
+  //! for the minimal time of a batch and `--filter <text>` to run only
+  //! the benchmarks whose name contains the text.
+  //! @returns `true` if the options were parsed, `false` otherwise.
+  bool ParseOptions(int argc, char** argv)
+  {
+    for (int idx = 1; idx < argc; ++idx)
+    {
+      const std::string_view option = argv[idx];
+      if (option == "--json")
+      {
+        _isJson = true;
+      }
+      else if (option == "--min-time-ms" && idx + 1 < argc)
+      {
+        _minTime = std::chrono::milliseconds(std::stoul(argv[++idx]));
+      }
+      else if (option == "--filter" && idx + 1 < argc)
+      {
+        _filter = argv[++idx];
+      }
+      else
+      {
+        std::fprintf(
+          stderr,
+          "Usage: %s [--json] [--min-time-ms <ms>] [--filter <text>]\n",
+          argv[0]);
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  //! Runs a benchmark.
+  //! @param name Name of the benchmark.
+  //! @param bytesPerOperation Bytes processed by a single operation.
+  //! @param operation Operation to measure.
+  template <typename Operation>
+  void Run(
+    const std::string_view name,
+    const std::size_t bytesPerOperation,
+    Operation&& operation)
+  {
+    if (not _filter.empty() && name.find(_filter) == std::string_view::npos)
+      return;
+
+    uint64_t iterations = 1;
+    Clock::duration elapsed{};
+
+    while (true)
+    {
+      const auto start = Clock::now();
+      for (uint64_t iteration = 0; iteration < iterations; ++iteration)
+        operation();
+      elapsed = Clock::now() - start;
+
+      if (elapsed >= _minTime || iterations >= MaxIterations)
+        break;
+      iterations *= 2;
+    }
+
+    auto& result = _results.emplace_back(Result{
+      .name = std::string(name),
+      .iterations = iterations,
+      .nanosecondsPerOperation =
+        std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations),
+      .bytesPerOperation = bytesPerOperation});
+
+    if (not _isJson)
+      std::puts(FormatResult(result).c_str());
+  }
+
+  //! Reports the results of the benchmarks.
+  //! The JSON report is printed once all the benchmarks ran.
+  void Report() const
+  {
+    if (not _isJson)
+      return;
+
+    auto report = nlohmann::json::array();
+    for (const auto& result : _results)
+    {
+      report.push_back({
+        {"name", result.name},
+        {"iterations", result.iterations},
+        {"ns_per_op", result.nanosecondsPerOperation},
+        {"bytes_per_op", result.bytesPerOperation},
+        {"mb_per_s", GetThroughput(result)}});
+    }
+
+    std::puts(report.dump(2).c_str());
+  }
+
+private:
+  //! Max count of the iterations of a batch.
+  static constexpr uint64_t MaxIterations = 1ull << 32;
+
+  //! Returns the throughput in megabytes per second.
+  static double GetThroughput(const Result& result)
+  {
+    if (result.bytesPerOperation == 0 || result.nanosecondsPerOperation <= 0.0)
+      return 0.0;
+    return static_cast<double>(result.bytesPerOperation) * 1e3 / result.nanosecondsPerOperation;
+  }
+
+  static std::string FormatResult(const Result& result)
+  {
+    std::string line = std::format(
+      "{:<48} {:>12} iterations {:>12.2f} ns/op",
+      result.name,
+      result.iterations,
+      result.nanosecondsPerOperation);
+
+    if (result.bytesPerOperation > 0)
+      line += std::format(" {:>10.1f} MB/s", GetThroughput(result));
+
+    return line;
+  }
+
+  bool _isJson{false};
+  std::chrono::nanoseconds _minTime{std::chrono::milliseconds(200)};
+  std::string _filter;
+  std::vector<Result> _results;
+};
+
+} // namespace benchmark
+
+#endif // ALICIA_SERVER_BENCHMARK_HPP
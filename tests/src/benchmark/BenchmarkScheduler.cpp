@@ -0,0 +1,196 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "Benchmark.hpp"
+
+#include "libserver/util/Scheduler.hpp"
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+
+using Clock = server::Scheduler::Clock;
+
+//! Count of the jobs of a benchmark operation.
+constexpr uint32_t JobCount = 1000;
+//! Delay of the jobs which should not become due while benchmarking.
+constexpr auto FarDelay = std::chrono::hours(1);
+
+//! The previous scheduler, a job list scanned from a saved iterator
+//! executing at most one due job per tick. Kept for comparison.
+class LegacyScheduler
+{
+public:
+  using Task = std::function<void()>;
+
+  void Tick()
+  {
+    if (_jobs.empty())
+      return;
+
+    if (_jobIterator == _jobs.cend())
+      _jobIterator = _jobs.begin();
+
+    while (true)
+    {
+      const auto& job = *_jobIterator;
+      if (Clock::now() >= job.when)
+      {
+        job.task();
+        _jobIterator = _jobs.erase(_jobIterator);
+        break;
+      }
+
+      if (++_jobIterator == _jobs.cend())
+        break;
+    }
+  }
+
+  void Queue(const Task& task, Clock::time_point when = Clock::now())
+  {
+    std::scoped_lock lock(_jobsMutex);
+    _jobs.emplace_back(Job{
+      .when = when,
+      .task = task});
+  }
+
+  [[nodiscard]] bool IsEmpty() const
+  {
+    return _jobs.empty();
+  }
+
+private:
+  struct Job
+  {
+    Clock::time_point when{};
+    Task task{};
+  };
+
+  std::mutex _jobsMutex;
+  std::list<Job> _jobs;
+  decltype(_jobs)::const_iterator _jobIterator{_jobs.cend()};
+};
+
+void BenchmarkDrain(benchmark::Runner& runner)
+{
+  uint64_t executions = 0;
+  const auto task = [&executions]()
+  {
+    ++executions;
+  };
+
+  // Queues the immediate jobs and ticks until all of them executed,
+  // the legacy scheduler takes a tick per job, twenty seconds at the director rate.
+  runner.Run("scheduler/legacy/drain_1000_due", 0, [&]()
+  {
+    LegacyScheduler scheduler;
+    for (uint32_t jobIdx = 0; jobIdx < JobCount; ++jobIdx)
+      scheduler.Queue(task);
+    while (not scheduler.IsEmpty())
+      scheduler.Tick();
+    benchmark::DoNotOptimize(executions);
+  });
+
+  runner.Run("scheduler/wheel/drain_1000_due", 0, [&]()
+  {
+    server::Scheduler scheduler;
+    scheduler.SetTickBudget(Clock::duration::zero());
+    for (uint32_t jobIdx = 0; jobIdx < JobCount; ++jobIdx)
+      scheduler.Queue(task);
+    while (scheduler.GetJobCount() > 0)
+      scheduler.Tick();
+    benchmark::DoNotOptimize(executions);
+  });
+}
+
+void BenchmarkPendingTick(benchmark::Runner& runner)
+{
+  // Ticks with jobs queued, none of them due.
+  LegacyScheduler legacyScheduler;
+  server::Scheduler scheduler;
+  for (uint32_t jobIdx = 0; jobIdx < JobCount; ++jobIdx)
+  {
+    const auto when = Clock::now() + FarDelay + std::chrono::milliseconds(jobIdx);
+    legacyScheduler.Queue([](){}, when);
+    scheduler.Queue([](){}, when);
+  }
+
+  runner.Run("scheduler/legacy/tick_1000_pending", 0, [&]()
+  {
+    legacyScheduler.Tick();
+  });
+
+  runner.Run("scheduler/wheel/tick_1000_pending", 0, [&]()
+  {
+    scheduler.Tick();
+  });
+}
+
+void BenchmarkQueue(benchmark::Runner& runner)
+{
+  // Queues the delayed jobs, and cancels them for the wheel.
+  runner.Run("scheduler/legacy/queue_1000_delayed", 0, [&]()
+  {
+    LegacyScheduler scheduler;
+    const auto now = Clock::now();
+    for (uint32_t jobIdx = 0; jobIdx < JobCount; ++jobIdx)
+      scheduler.Queue([](){}, now + FarDelay + std::chrono::milliseconds(jobIdx));
+    benchmark::DoNotOptimize(scheduler);
+  });
+
+  runner.Run("scheduler/wheel/queue_1000_delayed", 0, [&]()
+  {
+    server::Scheduler scheduler;
+    const auto now = Clock::now();
+    for (uint32_t jobIdx = 0; jobIdx < JobCount; ++jobIdx)
+      scheduler.Queue([](){}, now + FarDelay + std::chrono::milliseconds(jobIdx));
+    benchmark::DoNotOptimize(scheduler);
+  });
+
+  std::vector<server::Scheduler::JobHandle> handles(JobCount);
+  runner.Run("scheduler/wheel/queue_cancel_1000_delayed", 0, [&]()
+  {
+    server::Scheduler scheduler;
+    const auto now = Clock::now();
+    for (uint32_t jobIdx = 0; jobIdx < JobCount; ++jobIdx)
+      handles[jobIdx] = scheduler.Queue([](){}, now + FarDelay + std::chrono::milliseconds(jobIdx));
+    for (auto& handle : handles)
+      handle.Cancel();
+    benchmark::DoNotOptimize(scheduler);
+  });
+}
+
+} // anon namespace
+
+int main(int argc, char** argv)
+{
+  benchmark::Runner runner;
+  if (not runner.ParseOptions(argc, argv))
+    return 1;
+
+  BenchmarkDrain(runner);
+  BenchmarkPendingTick(runner);
+  BenchmarkQueue(runner);
+
+  runner.Report();
+}
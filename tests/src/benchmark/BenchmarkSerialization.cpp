@@ -0,0 +1,325 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "Benchmark.hpp"
+
+#include "libserver/network/XorCodec.hpp"
+#include "libserver/network/command/CommandProtocol.hpp"
+#include "libserver/network/command/proto/LobbyMessageDefinitions.hpp"
+#include "libserver/network/command/proto/RaceMessageDefinitions.hpp"
+#include "libserver/network/command/proto/RanchMessageDefinitions.hpp"
+#include "libserver/util/Locale.hpp"
+#include "libserver/util/Stream.hpp"
+
+#include <array>
+
+namespace
+{
+
+//! Size of the buffer the messages are serialized to.
+constexpr std::size_t BufferSize = 16384;
+
+void BenchmarkStreams(benchmark::Runner& runner)
+{
+  std::array<std::byte, BufferSize> buffer{};
+
+  constexpr std::size_t ValueCount = 256;
+
+  runner.Run("stream/write_u32", ValueCount * sizeof(uint32_t), [&]()
+  {
+    server::SinkStream sink(buffer);
+    for (uint32_t value = 0; value < ValueCount; ++value)
+      sink.Write(value);
+    benchmark::DoNotOptimize(buffer);
+  });
+
+  runner.Run("stream/read_u32", ValueCount * sizeof(uint32_t), [&]()
+  {
+    server::SourceStream source(buffer);
+    uint32_t value{};
+    for (std::size_t idx = 0; idx < ValueCount; ++idx)
+    {
+      source.Read(value);
+      benchmark::DoNotOptimize(value);
+    }
+  });
+
+  runner.Run("stream/write_mixed", ValueCount * 15, [&]()
+  {
+    server::SinkStream sink(buffer);
+    for (std::size_t idx = 0; idx < ValueCount; ++idx)
+    {
+      sink.Write(static_cast<uint8_t>(idx))
+        .Write(static_cast<uint16_t>(idx))
+        .Write(static_cast<uint32_t>(idx))
+        .Write(static_cast<uint64_t>(idx));
+    }
+    benchmark::DoNotOptimize(buffer);
+  });
+
+  const std::string text = "The quick brown fox jumps over the lazy horse";
+  constexpr std::size_t StringCount = 64;
+  const std::size_t stringBytes = StringCount * (text.size() + 1);
+
+  runner.Run("stream/write_string", stringBytes, [&]()
+  {
+    server::SinkStream sink(buffer);
+    for (std::size_t idx = 0; idx < StringCount; ++idx)
+      sink.Write(text);
+    benchmark::DoNotOptimize(buffer);
+  });
+
+  runner.Run("stream/read_string", stringBytes, [&]()
+  {
+    server::SourceStream source(buffer);
+    std::string value;
+    for (std::size_t idx = 0; idx < StringCount; ++idx)
+    {
+      source.Read(value);
+      benchmark::DoNotOptimize(value);
+    }
+  });
+}
+
+void BenchmarkLocale(benchmark::Runner& runner)
+{
+  const std::string asciiName = "Rider(1)";
+  // A name in Korean, in UTF-8 and in EUC-KR.
+  const std::string utfName = "\xea\xb5\xac" "\xea\xb5\xac" "Rider";
+  const std::string eucName = "\xb1\xb8" "\xb1\xb8" "Rider";
+
+  runner.Run("locale/from_utf8_ascii", asciiName.size(), [&]()
+  {
+    benchmark::DoNotOptimize(server::locale::FromUtf8(asciiName));
+  });
+
+  runner.Run("locale/from_utf8_korean", utfName.size(), [&]()
+  {
+    benchmark::DoNotOptimize(server::locale::FromUtf8(utfName));
+  });
+
+  runner.Run("locale/to_utf8_ascii", asciiName.size(), [&]()
+  {
+    benchmark::DoNotOptimize(server::locale::ToUtf8(asciiName));
+  });
+
+  runner.Run("locale/to_utf8_korean", eucName.size(), [&]()
+  {
+    benchmark::DoNotOptimize(server::locale::ToUtf8(eucName));
+  });
+}
+
+void BenchmarkMagic(benchmark::Runner& runner)
+{
+  constexpr uint16_t MagicCount = 256;
+
+  runner.Run("magic/encode_x256", 0, [&]()
+  {
+    for (uint16_t idx = 0; idx < MagicCount; ++idx)
+    {
+      const auto magic = server::protocol::encode_message_magic({
+        .id = idx,
+        .length = static_cast<uint16_t>(idx + 4)});
+      benchmark::DoNotOptimize(magic);
+    }
+  });
+
+  std::array<uint32_t, MagicCount> magics{};
+  for (uint16_t idx = 0; idx < MagicCount; ++idx)
+  {
+    magics[idx] = server::protocol::encode_message_magic({
+      .id = idx,
+      .length = static_cast<uint16_t>(idx + 4)});
+  }
+
+  runner.Run("magic/decode_x256", 0, [&]()
+  {
+    for (const auto magicValue : magics)
+    {
+      const auto magic = server::protocol::decode_message_magic(magicValue);
+      benchmark::DoNotOptimize(magic);
+    }
+  });
+}
+
+void BenchmarkXorCodec(benchmark::Runner& runner)
+{
+  constexpr server::network::XorKey Key{
+    std::byte{0x2B}, std::byte{0xFE}, std::byte{0xB8}, std::byte{0x02}};
+
+  constexpr std::array Kernels{
+    std::pair{server::network::XorKernel::Byte, "byte"},
+    std::pair{server::network::XorKernel::Scalar64, "scalar64"},
+    std::pair{server::network::XorKernel::Sse2, "sse2"},
+    std::pair{server::network::XorKernel::Avx2, "avx2"}};
+
+  // Sizes of a small command, a typical command and the max command.
+  for (const std::size_t size : {32, 512, 4092})
+  {
+    std::vector<std::byte> data(size);
+
+    for (const auto& [kernel, kernelName] : Kernels)
+    {
+      if (not server::network::IsXorKernelSupported(kernel))
+        continue;
+
+      runner.Run(std::format("xor/{}/{}", kernelName, size), size, [&]()
+      {
+        server::network::XorInPlace(data, Key, kernel);
+        benchmark::DoNotOptimize(data);
+      });
+    }
+  }
+}
+
+//! Benchmarks the writing and the reading of a message.
+template <typename Message>
+void BenchmarkMessage(
+  benchmark::Runner& runner,
+  const std::string_view name,
+  const Message& message)
+{
+  std::array<std::byte, BufferSize> buffer{};
+
+  server::SinkStream sizeSink(buffer);
+  Message::Write(message, sizeSink);
+  const std::size_t messageSize = sizeSink.GetCursor();
+
+  runner.Run(std::format("message/{}/write", name), messageSize, [&]()
+  {
+    server::SinkStream sink(buffer);
+    Message::Write(message, sink);
+    benchmark::DoNotOptimize(buffer);
+  });
+
+  runner.Run(std::format("message/{}/read", name), messageSize, [&]()
+  {
+    server::SourceStream source({buffer.data(), messageSize});
+    Message decoded;
+    Message::Read(decoded, source);
+    benchmark::DoNotOptimize(decoded);
+  });
+}
+
+server::protocol::Horse MakeHorse(const uint32_t uid)
+{
+  server::protocol::Horse horse{};
+  horse.uid = uid;
+  horse.tid = 20001;
+  horse.name = std::format("Horse {}", uid);
+  return horse;
+}
+
+server::protocol::LobbyCommandLoginOK MakeLoginOK()
+{
+  server::protocol::LobbyCommandLoginOK message{};
+  message.uid = 1;
+  message.name = "Rider";
+  message.notice = "Welcome to the server of the benchmark";
+  message.introduction = "Introduction of the rider";
+  message.horse = MakeHorse(1);
+
+  for (uint32_t idx = 0; idx < 16; ++idx)
+  {
+    message.equipmentItems.emplace_back(server::protocol::Item{
+      .uid = idx,
+      .tid = 10000 + idx,
+      .count = 1});
+  }
+
+  for (uint16_t idx = 0; idx < 8; ++idx)
+  {
+    auto& mission = message.missions.emplace_back();
+    mission.id = idx;
+    mission.progress.emplace_back(
+      server::protocol::LobbyCommandLoginOK::Mission::Progress{.id = idx, .value = idx});
+  }
+
+  return message;
+}
+
+server::protocol::AcCmdCREnterRanchOK MakeEnterRanchOK()
+{
+  server::protocol::AcCmdCREnterRanchOK message{};
+  message.rancherUid = 1;
+  message.rancherName = "Rider";
+  message.ranchName = "Ranch of the rider";
+
+  // Max count of the characters and of the horses.
+  for (uint16_t idx = 0; idx < 20; ++idx)
+  {
+    auto& character = message.characters.emplace_back();
+    character.uid = idx;
+    character.name = std::format("Rider {}", idx);
+    character.oid = idx;
+    character.mount = MakeHorse(idx);
+  }
+
+  for (uint16_t idx = 0; idx < 10; ++idx)
+  {
+    message.horses.emplace_back(server::protocol::RanchHorse{
+      .horseOid = static_cast<uint16_t>(100 + idx),
+      .horse = MakeHorse(100 + idx)});
+  }
+
+  return message;
+}
+
+server::protocol::AcCmdCRStartRaceNotify MakeStartRaceNotify()
+{
+  server::protocol::AcCmdCRStartRaceNotify message{};
+  message.raceGameMode = server::protocol::GameMode::Speed;
+  message.raceTeamMode = server::protocol::TeamMode::FFA;
+
+  // Max count of the racers.
+  for (uint16_t idx = 0; idx < 10; ++idx)
+  {
+    message.racers.emplace_back(server::protocol::AcCmdCRStartRaceNotify::Player{
+      .oid = idx,
+      .name = std::format("Rider {}", idx),
+      .p2dId = idx});
+  }
+
+  return message;
+}
+
+} // anon namespace
+
+int main(int argc, char** argv)
+{
+  benchmark::Runner runner;
+  if (not runner.ParseOptions(argc, argv))
+    return 1;
+
+  BenchmarkStreams(runner);
+  BenchmarkLocale(runner);
+  BenchmarkMagic(runner);
+  BenchmarkXorCodec(runner);
+
+  BenchmarkMessage(runner, "lobby_login_ok", MakeLoginOK());
+  BenchmarkMessage(runner, "ranch_enter_ranch_ok", MakeEnterRanchOK());
+  BenchmarkMessage(runner, "race_start_race_notify", MakeStartRaceNotify());
+  BenchmarkMessage(runner, "race_update_pos", server::protocol::AcCmdUserRaceUpdatePos{});
+  BenchmarkMessage(
+    runner,
+    "ranch_snapshot",
+    server::protocol::AcCmdCRRanchSnapshot{.type = server::protocol::AcCmdCRRanchSnapshot::Full});
+
+  runner.Report();
+}
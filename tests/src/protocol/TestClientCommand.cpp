@@ -0,0 +1,103 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/network/command/CommandConnection.hpp"
+#include "libserver/network/XorCodec.hpp"
+
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+
+//! Decodes a client command frame the way the command server does.
+std::vector<std::byte> DecodeFrame(
+  std::vector<std::byte> frame,
+  server::CommandClient& serverCode,
+  uint16_t& commandId)
+{
+  uint32_t magicValue{};
+  std::memcpy(&magicValue, frame.data(), sizeof(magicValue));
+
+  const auto magic = server::protocol::decode_message_magic(magicValue);
+  assert(magic.length == frame.size());
+  commandId = magic.id;
+
+  const auto commandData = std::span(frame).subspan(sizeof(magicValue));
+  if (commandData.empty())
+    return {};
+
+  serverCode.RollCode();
+  const auto padding = static_cast<uint32_t>(serverCode.GetRollingCodeInt()) & 7;
+  assert(padding < commandData.size());
+
+  server::network::XorInPlace(commandData, serverCode.GetRollingCode());
+
+  const auto payload = commandData.first(commandData.size() - padding);
+  return {payload.begin(), payload.end()};
+}
+
+//! Tests that the frames encoded by the client are decoded by the server,
+//! with the codes of both sides rolling in lockstep.
+void TestRoundTrip()
+{
+  server::CommandClient clientCode;
+  server::CommandClient serverCode;
+
+  for (std::size_t size = 0; size < 64; ++size)
+  {
+    std::vector<std::byte> payload(size);
+    for (std::size_t idx = 0; idx < size; ++idx)
+      payload[idx] = static_cast<std::byte>(idx * 7 + size);
+
+    const auto frame = server::EncodeClientCommand(
+      server::protocol::Command::AcCmdCLLogin,
+      payload,
+      clientCode);
+
+    uint16_t commandId{};
+    const auto decoded = DecodeFrame(frame, serverCode, commandId);
+
+    assert(commandId == static_cast<uint16_t>(server::protocol::Command::AcCmdCLLogin));
+    assert(decoded == payload);
+    assert(clientCode.GetRollingCodeInt() == serverCode.GetRollingCodeInt());
+  }
+}
+
+//! Tests that a command without payload does not roll the code.
+void TestEmptyPayload()
+{
+  server::CommandClient clientCode;
+
+  const auto frame = server::EncodeClientCommand(
+    server::protocol::Command::AcCmdCLHeartbeat,
+    {},
+    clientCode);
+
+  assert(frame.size() == sizeof(uint32_t));
+  assert(clientCode.GetRollingCodeInt() == 0);
+}
+
+} // anon namespace
+
+int main()
+{
+  TestRoundTrip();
+  TestEmptyPayload();
+}
@@ -0,0 +1,294 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/network/command/CommandDeferrer.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using server::CommandDeferrer;
+using server::network::ClientId;
+
+struct Command
+{
+  uint32_t value{};
+};
+
+//! Tests all the ready commands are resumed in a single tick.
+void TestBulkResume()
+{
+  std::vector<uint32_t> handled;
+  CommandDeferrer<Command> deferrer([&handled](ClientId, const Command& command)
+  {
+    handled.emplace_back(command.value);
+    return false;
+  });
+
+  for (uint32_t value = 0; value < 200; ++value)
+    deferrer.Defer(value, Command{.value = value});
+  assert(deferrer.GetMetrics().depth == 200);
+
+  deferrer.Tick();
+  assert(handled.size() == 200);
+  // The commands are resumed in the order they were deferred.
+  for (uint32_t value = 0; value < 200; ++value)
+    assert(handled[value] == value);
+
+  const auto metrics = deferrer.GetMetrics();
+  assert(metrics.depth == 0);
+  assert(metrics.resumedCount == 200);
+  assert(metrics.waitTime.count == 200);
+}
+
+//! Tests the parked commands are resumed only once the readiness epoch advances.
+void TestReadiness()
+{
+  uint64_t epoch = 0;
+  bool isReady = false;
+  uint32_t handleCount = 0;
+
+  CommandDeferrer<Command> deferrer(
+    [&](ClientId, const Command&)
+    {
+      ++handleCount;
+      return not isReady;
+    },
+    [&epoch]()
+    {
+      return epoch;
+    });
+  deferrer.SetRetryInterval(std::chrono::hours(1));
+
+  deferrer.Defer(1, {});
+  deferrer.Defer(2, {});
+
+  // Freshly deferred commands are resumed once.
+  deferrer.Tick();
+  assert(handleCount == 2);
+
+  // Without an advance of the epoch, the parked commands are not resumed.
+  deferrer.Tick();
+  deferrer.Tick();
+  assert(handleCount == 2);
+  assert(deferrer.GetMetrics().depth == 2);
+
+  // Advance of the epoch resumes the commands, which are still not ready.
+  ++epoch;
+  deferrer.Tick();
+  assert(handleCount == 4);
+  deferrer.Tick();
+  assert(handleCount == 4);
+
+  isReady = true;
+  ++epoch;
+  deferrer.Tick();
+  assert(handleCount == 6);
+  assert(deferrer.GetMetrics().depth == 0);
+}
+
+//! Tests the parked commands are retried even without an advance of the readiness epoch.
+void TestRetryInterval()
+{
+  uint32_t handleCount = 0;
+  CommandDeferrer<Command> deferrer(
+    [&handleCount](ClientId, const Command&)
+    {
+      return ++handleCount < 2;
+    },
+    []()
+    {
+      return uint64_t{0};
+    });
+  deferrer.SetRetryInterval(std::chrono::milliseconds(10));
+
+  deferrer.Defer(1, {});
+  deferrer.Tick();
+  deferrer.Tick();
+  assert(handleCount == 1);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  deferrer.Tick();
+  assert(handleCount == 2);
+  assert(deferrer.GetMetrics().depth == 0);
+}
+
+//! Tests the tick is bounded by its budget and the rest of the commands are kept.
+void TestTickBudget()
+{
+  uint32_t handleCount = 0;
+  CommandDeferrer<Command> deferrer([&handleCount](ClientId, const Command&)
+  {
+    ++handleCount;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return false;
+  });
+  deferrer.SetTickBudget(std::chrono::milliseconds(5));
+
+  for (uint32_t value = 0; value < 10; ++value)
+    deferrer.Defer(value, {});
+
+  deferrer.Tick();
+  assert(handleCount >= 1 && handleCount < 10);
+  assert(deferrer.GetMetrics().depth == 10 - handleCount);
+
+  while (deferrer.GetMetrics().depth > 0)
+    deferrer.Tick();
+  assert(handleCount == 10);
+}
+
+//! Tests the commands deferred from a handler and throwing handlers.
+void TestHandlerDefer()
+{
+  CommandDeferrer<Command>* deferrerPtr = nullptr;
+  std::vector<uint32_t> handled;
+
+  CommandDeferrer<Command> deferrer([&](ClientId clientId, const Command& command)
+  {
+    handled.emplace_back(command.value);
+    if (command.value == 1)
+      throw std::runtime_error("Handler failure");
+    if (command.value == 2)
+      deferrerPtr->Defer(clientId, Command{.value = 3});
+    return false;
+  });
+  deferrerPtr = &deferrer;
+
+  deferrer.Defer(1, Command{.value = 1});
+  deferrer.Defer(2, Command{.value = 2});
+
+  // The throwing command is dropped and the rest are still resumed,
+  // the command deferred during the tick waits for the next one.
+  deferrer.Tick();
+  assert((handled == std::vector<uint32_t>{1, 2}));
+  assert(deferrer.GetMetrics().depth == 1);
+
+  deferrer.Tick();
+  assert((handled == std::vector<uint32_t>{1, 2, 3}));
+  assert(deferrer.GetMetrics().depth == 0);
+}
+
+//! Tests the commands of a client are discarded.
+void TestDiscard()
+{
+  std::vector<ClientId> handled;
+  CommandDeferrer<Command> deferrer([&handled](ClientId clientId, const Command&)
+  {
+    handled.emplace_back(clientId);
+    return false;
+  });
+
+  deferrer.Defer(1, {});
+  deferrer.Defer(2, {});
+  deferrer.Defer(1, {});
+
+  deferrer.Discard(1);
+  assert(deferrer.GetMetrics().depth == 1);
+
+  deferrer.Tick();
+  assert((handled == std::vector<ClientId>{2}));
+  assert(deferrer.GetMetrics().depth == 0);
+}
+
+//! Tests the commands of a client discarded during a tick are not parked again.
+void TestDiscardDuringTick()
+{
+  CommandDeferrer<Command>* deferrerPtr = nullptr;
+  uint32_t handleCount = 0;
+
+  CommandDeferrer<Command> deferrer([&](ClientId clientId, const Command&)
+  {
+    ++handleCount;
+    // The first client disconnects while its commands are being resumed.
+    if (clientId == 2)
+      deferrerPtr->Discard(1);
+    return true;
+  });
+  deferrerPtr = &deferrer;
+
+  deferrer.Defer(1, {});
+  deferrer.Defer(2, {});
+  deferrer.Defer(1, {});
+
+  deferrer.Tick();
+  assert(handleCount == 3);
+  assert(deferrer.GetMetrics().depth == 1);
+
+  deferrer.Tick();
+  assert(handleCount == 4);
+  assert(deferrer.GetMetrics().depth == 1);
+}
+
+//! Tests the commands still not ready after the max wait are passed to the expiry handler.
+void TestMaxWait()
+{
+  uint32_t handleCount = 0;
+  std::vector<uint32_t> expired;
+
+  CommandDeferrer<Command> deferrer([&handleCount](ClientId, const Command& command)
+  {
+    ++handleCount;
+    return command.value != 0;
+  });
+  deferrer.SetMaxWait(
+    std::chrono::milliseconds(20),
+    [&expired](ClientId, const Command& command)
+    {
+      expired.emplace_back(command.value);
+    });
+
+  deferrer.Defer(1, Command{.value = 1});
+  deferrer.Defer(2, Command{.value = 2});
+
+  // The commands keep waiting within the max wait.
+  deferrer.Tick();
+  assert(handleCount == 2);
+  assert(expired.empty());
+  assert(deferrer.GetMetrics().depth == 2);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+  deferrer.Defer(3, Command{.value = 0});
+  deferrer.Tick();
+  assert(handleCount == 5);
+  assert((expired == std::vector<uint32_t>{1, 2}));
+
+  const auto metrics = deferrer.GetMetrics();
+  assert(metrics.depth == 0);
+  assert(metrics.waitTime.count == 3);
+}
+
+} // anon namespace
+
+int main()
+{
+  TestBulkResume();
+  TestReadiness();
+  TestRetryInterval();
+  TestTickBudget();
+  TestHandlerDefer();
+  TestDiscard();
+  TestDiscardDuringTick();
+  TestMaxWait();
+}
@@ -0,0 +1,63 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/network/command/CommandProtocol.hpp"
+
+#include <cassert>
+
+namespace
+{
+
+//! Perform test of the command traits table.
+void TestCommandTraits()
+{
+  using server::protocol::Command;
+
+  // Names of the known commands.
+  assert(server::protocol::GetCommandName(Command::AcCmdCLLogin) == "AcCmdCLLogin");
+  assert(server::protocol::GetCommandName(Command::AcCmdUserRaceItemGet) == "AcCmdUserRaceItemGet");
+
+  // Unknown commands, within and out of the range of the table.
+  assert(server::protocol::GetCommandName(static_cast<Command>(0x0)) == "n/a");
+  assert(server::protocol::GetCommandName(Command::Count) == "n/a");
+  assert(server::protocol::GetCommandName(static_cast<Command>(0xFFFF)) == "n/a");
+
+  // Flags of the commands.
+  const auto& heartbeat = server::protocol::GetCommandTraits(Command::AcCmdCLHeartbeat);
+  assert(heartbeat.isMuted);
+  assert(heartbeat.priority == server::protocol::CommandPriority::Reliable);
+  assert(heartbeat.rateClass == server::protocol::CommandRateClass::Stream);
+
+  const auto& snapshotNotify = server::protocol::GetCommandTraits(
+    Command::AcCmdCRRanchSnapshotNotify);
+  assert(snapshotNotify.isMuted);
+  assert(snapshotNotify.priority == server::protocol::CommandPriority::Droppable);
+
+  const auto& login = server::protocol::GetCommandTraits(Command::AcCmdCLLogin);
+  assert(not login.isMuted);
+  assert(login.priority == server::protocol::CommandPriority::Reliable);
+  assert(login.rateClass == server::protocol::CommandRateClass::Event);
+}
+
+} // namespace
+
+int main()
+{
+  TestCommandTraits();
+}
@@ -0,0 +1,83 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/network/chatter/proto/ChatterMessageDefinitions.hpp"
+#include "libserver/network/command/proto/RaceMessageDefinitions.hpp"
+#include "libserver/network/command/proto/RanchMessageDefinitions.hpp"
+#include "libserver/util/Stream.hpp"
+
+#include <array>
+#include <cassert>
+
+namespace
+{
+
+//! Asserts that the size reported by the command is the size it writes.
+template <server::SizedStruct C>
+void AssertEncodedSize(const C& command)
+{
+  std::array<std::byte, 4096> buffer{};
+  server::SinkStream sink(buffer);
+  C::Write(command, sink);
+
+  assert(C::GetEncodedSize(command) == sink.GetCursor());
+}
+
+void TestFixedSize()
+{
+  AssertEncodedSize(server::protocol::AcCmdUserRaceUpdatePos{});
+  AssertEncodedSize(server::protocol::AcCmdUserRaceTimerOK{});
+  AssertEncodedSize(server::protocol::AcCmdRCRoomCountdown{});
+}
+
+void TestSnapshots()
+{
+  using Snapshot = server::protocol::AcCmdCRRanchSnapshot;
+
+  for (const auto type : {Snapshot::Full, Snapshot::Partial})
+  {
+    AssertEncodedSize(Snapshot{.type = type});
+
+    server::protocol::RanchCommandRanchSnapshotNotify notify{};
+    notify.type = type;
+    AssertEncodedSize(notify);
+  }
+}
+
+void TestStrings()
+{
+  assert(server::GetEncodedSize(std::string{}) == 1);
+  assert(server::GetEncodedSize(std::string{"Rider"}) == 6);
+  // The Korean characters take three bytes in UTF-8 and two bytes in EUC-KR.
+  assert(server::GetEncodedSize(std::string{"\xea\xb5\xac" "A"}) == 4);
+
+  AssertEncodedSize(server::protocol::ChatCmdChannelChatTrs{
+    .messageAuthor = "Rider",
+    .message = "Hello \xea\xb5\xac\xea\xb5\xac",
+    .role = server::protocol::ChatCmdChat::Role::User});
+}
+
+} // anon namespace
+
+int main()
+{
+  TestFixedSize();
+  TestSnapshots();
+  TestStrings();
+}
@@ -0,0 +1,239 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/network/FramedTransport.hpp"
+#include "libserver/network/chatter/ChatterServer.hpp"
+#include "libserver/network/command/CommandConnection.hpp"
+#include "libserver/network/command/CommandServer.hpp"
+#include "libserver/network/command/proto/LobbyMessageDefinitions.hpp"
+
+#include <cassert>
+#include <vector>
+
+namespace
+{
+
+//! Returns a payload of the size.
+std::vector<std::byte> MakePayload(const std::size_t size)
+{
+  std::vector<std::byte> payload(size);
+  for (std::size_t idx = 0; idx < size; ++idx)
+    payload[idx] = static_cast<std::byte>(idx * 13 + size);
+  return payload;
+}
+
+//! Tests that the chatter frames encoded by the transport are read back
+//! whole, however the received data are split.
+void TestChatterRoundTrip()
+{
+  using Transport = server::network::FramedTransport<server::ChatterFraming>;
+
+  Transport transport;
+  transport.debugCommands = false;
+  transport.debugIncomingCommandData = false;
+  transport.debugOutgoingCommandData = false;
+
+  constexpr auto CommandId = static_cast<uint16_t>(server::protocol::ChatterCommand::ChatCmdChannelChatTrs);
+
+  std::vector<std::vector<std::byte>> received;
+  transport.RegisterHandler(CommandId, [&received](server::network::ClientId, server::SourceStream& source)
+  {
+    std::vector<std::byte> payload(source.Size());
+    source.Read(payload.data(), payload.size());
+    received.emplace_back(std::move(payload));
+  });
+
+  // Frames of various sizes, the sized ones written directly to the frame.
+  std::vector<std::vector<std::byte>> payloads;
+  std::vector<std::byte> data;
+  for (std::size_t size = 0; size < 24; ++size)
+  {
+    const auto& payload = payloads.emplace_back(MakePayload(size));
+    const auto writer = [&payload](server::SinkStream& sink)
+    {
+      sink.Write(payload.data(), payload.size());
+    };
+
+    const auto frame = size % 2 == 0
+      ? transport.EncodeFrame(CommandId, writer, payload.size())
+      : transport.EncodeFrame(CommandId, writer, std::nullopt);
+    assert(frame.size() == server::ChatterFraming::HeaderSize + size);
+
+    data.insert(data.end(), frame.begin(), frame.end());
+  }
+
+  for (const std::size_t chunkSize : {1, 3, 7, 64, 4096})
+  {
+    received.clear();
+
+    // Copy of the data, the frames are decoded in place.
+    auto encoded = data;
+    std::vector<std::byte> buffer;
+    server::ChatterFraming::ClientState state;
+
+    for (std::size_t offset = 0; offset < encoded.size(); offset += chunkSize)
+    {
+      const auto chunkEnd = std::min(offset + chunkSize, encoded.size());
+      buffer.insert(buffer.end(), encoded.begin() + offset, encoded.begin() + chunkEnd);
+
+      server::network::DecodedCommands decoded;
+      const auto consumed = transport.ReadFrames(state, buffer, decoded);
+      buffer.erase(buffer.begin(), buffer.begin() + consumed);
+      transport.Dispatch(1, decoded);
+    }
+
+    assert(buffer.empty());
+    assert(received == payloads);
+  }
+}
+
+//! Tests that the command frames encoded by the client are read back
+//! with the code of the server rolling in lockstep.
+void TestCommandRoundTrip()
+{
+  using Transport = server::network::FramedTransport<server::CommandFraming>;
+
+  Transport transport;
+  transport.debugCommands = false;
+  transport.debugIncomingCommandData = false;
+
+  constexpr auto CommandId = server::protocol::Command::AcCmdCLLogin;
+
+  std::vector<std::vector<std::byte>> received;
+  transport.RegisterHandler(
+    static_cast<uint16_t>(CommandId),
+    [&received](server::network::ClientId, server::SourceStream& source)
+    {
+      std::vector<std::byte> payload(source.Size());
+      source.Read(payload.data(), payload.size());
+      received.emplace_back(std::move(payload));
+    });
+
+  server::CommandClient clientCode;
+  server::CommandClient serverCode;
+
+  std::vector<std::vector<std::byte>> payloads;
+  std::vector<std::byte> data;
+  for (std::size_t size = 0; size < 24; ++size)
+  {
+    const auto& payload = payloads.emplace_back(MakePayload(size));
+    const auto frame = server::EncodeClientCommand(CommandId, payload, clientCode);
+    data.insert(data.end(), frame.begin(), frame.end());
+  }
+
+  // The frames are read in two halves, the first one ending within a frame.
+  const std::size_t split = data.size() / 2 + 1;
+  server::network::DecodedCommands decoded;
+  const auto consumed = transport.ReadFrames(serverCode, std::span(data).first(split), decoded);
+  assert(consumed < split);
+
+  std::vector<std::byte> rest(data.begin() + consumed, data.end());
+  assert(transport.ReadFrames(serverCode, rest, decoded) == rest.size());
+
+  // The commands are dispatched only once they are read.
+  assert(received.empty());
+  transport.Dispatch(1, decoded);
+  assert(received == payloads);
+  assert(clientCode.GetRollingCodeInt() == serverCode.GetRollingCodeInt());
+}
+
+//! Tests that the credentials of the login command are redacted from the captures.
+void TestRedactCredentials()
+{
+  const server::protocol::AcCmdCLLogin login{
+    .loginId = "rider",
+    .memberNo = 1234,
+    .authKey = "secret-auth-key",
+    .val0 = 7};
+
+  std::vector<std::byte> data(64);
+  server::SinkStream sink(data);
+  server::protocol::AcCmdCLLogin::Write(login, sink);
+  data.resize(sink.GetCursor());
+
+  constexpr auto CommandId = static_cast<uint16_t>(server::protocol::Command::AcCmdCLLogin);
+  assert(server::CommandFraming::HasCredentials(CommandId));
+
+  const auto redactedData = server::CommandFraming::RedactCredentials(CommandId, data);
+  assert(redactedData.size() < data.size());
+
+  server::protocol::AcCmdCLLogin redacted;
+  server::SourceStream source(redactedData);
+  server::protocol::AcCmdCLLogin::Read(redacted, source);
+  assert(redacted.loginId == "rider");
+  assert(redacted.memberNo == 0);
+  assert(redacted.authKey.empty());
+  assert(redacted.val0 == 7);
+
+  // Other commands are kept as they are.
+  constexpr auto OtherCommandId = static_cast<uint16_t>(server::protocol::Command::AcCmdCLLoginCancel);
+  assert(not server::CommandFraming::HasCredentials(OtherCommandId));
+}
+
+//! Tests that the malformed frames are rejected.
+void TestMalformedFrames()
+{
+  server::network::FramedTransport<server::ChatterFraming> transport;
+  server::ChatterFraming::ClientState state;
+
+  // A frame shorter than its header.
+  std::vector<std::byte> frame(server::ChatterFraming::HeaderSize);
+  server::ChatterFraming::WriteHeader(frame, {.commandId = 1, .frameSize = 2});
+  server::ChatterFraming::EncodeFrame(frame);
+
+  bool isRejected = false;
+  try
+  {
+    server::network::DecodedCommands decoded;
+    (void)transport.ReadFrames(state, frame, decoded);
+  }
+  catch (const std::runtime_error&)
+  {
+    isRejected = true;
+  }
+  assert(isRejected);
+
+  // A command of a size other than the reported one.
+  isRejected = false;
+  try
+  {
+    (void)transport.EncodeFrame(
+      1,
+      [](server::SinkStream& sink)
+      {
+        sink.Write(uint32_t{});
+      },
+      2);
+  }
+  catch (const std::runtime_error&)
+  {
+    isRejected = true;
+  }
+  assert(isRejected);
+}
+
+} // anon namespace
+
+int main()
+{
+  TestChatterRoundTrip();
+  TestCommandRoundTrip();
+  TestRedactCredentials();
+  TestMalformedFrames();
+}
@@ -0,0 +1,192 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/network/UdpRelay.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+namespace asio = boost::asio;
+
+using server::network::RelayDatagramHeader;
+using server::network::UdpRelay;
+using server::network::UdpRelayTable;
+
+const auto Loopback = asio::ip::address_v4::loopback();
+
+asio::ip::udp::endpoint MakeEndpoint(const asio::ip::address_v4& address, const uint16_t port)
+{
+  return {address, port};
+}
+
+void TestHeader()
+{
+  const std::array<std::byte, 5> datagram{
+    std::byte{0x01}, std::byte{0x02}, std::byte{0xFF}, std::byte{0xFF}, std::byte{0x42}};
+
+  const auto header = RelayDatagramHeader::Read(datagram);
+  assert(header.has_value());
+  assert(header->source == 0x0201);
+  assert(header->target == RelayDatagramHeader::BroadcastSession);
+
+  // Datagrams shorter than the header are rejected.
+  assert(not RelayDatagramHeader::Read(std::span(datagram).first(3)).has_value());
+
+  // The token follows the header.
+  assert(not RelayDatagramHeader::ReadToken(datagram).has_value());
+  const std::array<std::byte, 8> bindDatagram{
+    std::byte{0x01}, std::byte{0x02}, std::byte{0xFF}, std::byte{0xFF},
+    std::byte{0x78}, std::byte{0x56}, std::byte{0x34}, std::byte{0x12}};
+  assert(RelayDatagramHeader::ReadToken(bindDatagram) == 0x12345678);
+}
+
+void TestRouting()
+{
+  UdpRelayTable table;
+  assert(table.RegisterSession(1, 100, Loopback, 0x1001));
+  assert(table.RegisterSession(2, 100, Loopback, 0x1002));
+  assert(table.RegisterSession(3, 100, Loopback, 0x1003));
+  assert(table.RegisterSession(4, 200, Loopback, 0x1004));
+  // The broadcast ID is reserved.
+  assert(not table.RegisterSession(RelayDatagramHeader::BroadcastSession, 100, Loopback, 0));
+
+  std::vector<asio::ip::udp::endpoint> recipients;
+
+  // Sessions are not bound without their token.
+  assert(not table.Route(MakeEndpoint(Loopback, 5001), {1, 2}, std::nullopt, recipients));
+  assert(not table.Route(MakeEndpoint(Loopback, 5001), {1, 2}, 0x1002, recipients));
+
+  // Sessions are bound by the binding datagrams, which are not forwarded.
+  assert(not table.Route(MakeEndpoint(Loopback, 5001), {1, RelayDatagramHeader::BroadcastSession}, 0x1001, recipients));
+  assert(not table.Route(MakeEndpoint(Loopback, 5002), {2, 1}, 0x1002, recipients));
+  assert(not table.Route(MakeEndpoint(Loopback, 5004), {4, RelayDatagramHeader::BroadcastSession}, 0x1004, recipients));
+  assert(recipients.empty());
+
+  // Broadcasts reach the bound sessions of the room except the sender.
+  assert(table.Route(MakeEndpoint(Loopback, 5001), {1, RelayDatagramHeader::BroadcastSession}, std::nullopt, recipients));
+  assert(recipients.size() == 1);
+  assert(recipients[0].port() == 5002);
+
+  // Unicasts reach only the sessions of the same room.
+  recipients.clear();
+  assert(table.Route(MakeEndpoint(Loopback, 5002), {2, 1}, std::nullopt, recipients));
+  assert(recipients.size() == 1 && recipients[0].port() == 5001);
+  recipients.clear();
+  assert(not table.Route(MakeEndpoint(Loopback, 5002), {2, 4}, std::nullopt, recipients));
+  assert(recipients.empty());
+
+  // Sessions can not be claimed from other addresses, even with their token.
+  const auto otherAddress = asio::ip::make_address_v4("10.0.0.1");
+  assert(not table.Route(MakeEndpoint(otherAddress, 5001), {1, 2}, 0x1001, recipients));
+  assert(not table.Route(MakeEndpoint(Loopback, 5001), {9, 2}, 0x1001, recipients));
+
+  // Sessions can not be taken over by other hosts sharing their address.
+  assert(not table.Route(MakeEndpoint(Loopback, 6001), {1, 2}, std::nullopt, recipients));
+  assert(not table.Route(MakeEndpoint(Loopback, 6001), {1, 2}, 0x1003, recipients));
+  assert(table.Route(MakeEndpoint(Loopback, 5002), {2, 1}, std::nullopt, recipients));
+  assert(recipients.size() == 1 && recipients[0].port() == 5001);
+
+  // Sessions are rebound when their token is presented from another port.
+  recipients.clear();
+  assert(not table.Route(MakeEndpoint(Loopback, 6001), {1, 2}, 0x1001, recipients));
+  assert(table.Route(MakeEndpoint(Loopback, 5002), {2, 1}, std::nullopt, recipients));
+  assert(recipients.size() == 1 && recipients[0].port() == 6001);
+
+  // Moving a session to another room takes it out of the previous one.
+  assert(table.RegisterSession(2, 200, Loopback, 0x1002));
+  recipients.clear();
+  assert(table.Route(MakeEndpoint(Loopback, 5004), {4, RelayDatagramHeader::BroadcastSession}, std::nullopt, recipients) == false);
+
+  table.UnregisterSession(3);
+  assert(table.GetSessionCount() == 3);
+  table.UnregisterRoom(200);
+  assert(table.GetSessionCount() == 1);
+  assert(not table.Route(MakeEndpoint(Loopback, 5004), {4, 1}, std::nullopt, recipients));
+}
+
+//! Tests the datagrams are relayed between the sockets of a room.
+void TestRelay()
+{
+  UdpRelay relay;
+  relay.Begin(Loopback, 0);
+
+  auto& table = relay.GetTable();
+  table.RegisterSession(1, 100, Loopback, 0x44332211);
+  table.RegisterSession(2, 100, Loopback, 0x88776655);
+
+  asio::io_context ioContext;
+  asio::ip::udp::socket first(ioContext, MakeEndpoint(Loopback, 0));
+  asio::ip::udp::socket second(ioContext, MakeEndpoint(Loopback, 0));
+  const auto relayEndpoint = MakeEndpoint(Loopback, relay.GetPort());
+
+  const std::array<std::byte, 8> firstBindDatagram{
+    std::byte{0x01}, std::byte{0x00}, std::byte{0xFF}, std::byte{0xFF},
+    std::byte{0x11}, std::byte{0x22}, std::byte{0x33}, std::byte{0x44}};
+  const std::array<std::byte, 8> secondBindDatagram{
+    std::byte{0x02}, std::byte{0x00}, std::byte{0xFF}, std::byte{0xFF},
+    std::byte{0x55}, std::byte{0x66}, std::byte{0x77}, std::byte{0x88}};
+  const std::array<std::byte, 6> datagram{
+    std::byte{0x01}, std::byte{0x00}, std::byte{0xFF}, std::byte{0xFF}, std::byte{0xAB}, std::byte{0xCD}};
+
+  // The sessions bind themselves, the binding datagrams are not forwarded.
+  first.send_to(asio::buffer(firstBindDatagram), relayEndpoint);
+  second.send_to(asio::buffer(secondBindDatagram), relayEndpoint);
+
+  // Wait for the relay to bind the sessions.
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (relay.GetStats().received < 2)
+  {
+    assert(std::chrono::steady_clock::now() < deadline);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  first.send_to(asio::buffer(datagram), relayEndpoint);
+
+  std::array<std::byte, 64> received{};
+  asio::ip::udp::endpoint sender;
+  const std::size_t receivedSize = second.receive_from(asio::buffer(received), sender);
+
+  // The datagram is forwarded unchanged.
+  assert(receivedSize == datagram.size());
+  assert(std::equal(datagram.cbegin(), datagram.cend(), received.cbegin()));
+  assert(sender == relayEndpoint);
+
+  relay.End();
+
+  const auto stats = relay.GetStats();
+  assert(stats.received == 3);
+  assert(stats.forwarded == 1);
+  assert(stats.dropped == 2);
+}
+
+} // anon namespace
+
+int main()
+{
+  TestHeader();
+  TestRouting();
+  TestRelay();
+}
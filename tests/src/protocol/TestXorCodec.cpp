@@ -0,0 +1,100 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/network/XorCodec.hpp"
+
+#include <cassert>
+#include <vector>
+
+namespace
+{
+
+//! Reference XOR byte loop.
+void XorReference(
+  std::span<std::byte> data,
+  const server::network::XorKey& key)
+{
+  for (std::size_t idx = 0; idx < data.size(); ++idx)
+  {
+    data[idx] ^= key[idx % 4];
+  }
+}
+
+//! Perform test of every supported kernel against the reference byte loop.
+void TestXorKernels()
+{
+  constexpr std::array Kernels{
+    server::network::XorKernel::Byte,
+    server::network::XorKernel::Scalar64,
+    server::network::XorKernel::Sse2,
+    server::network::XorKernel::Avx2};
+
+  const std::array Keys{
+    server::network::XorKey{
+      std::byte{0x2B}, std::byte{0xFE}, std::byte{0xB8}, std::byte{0x02}},
+    server::network::XorKey{
+      std::byte{0xA2}, std::byte{0x0F}, std::byte{0x30}, std::byte{0x00}},
+    server::network::XorKey{
+      std::byte{0xFF}, std::byte{0x00}, std::byte{0xFF}, std::byte{0x00}}};
+
+  // The best kernel must always be supported.
+  assert(server::network::IsXorKernelSupported(
+    server::network::GetBestXorKernel()));
+
+  for (const auto& key : Keys)
+  {
+    // Lengths around the widths of every kernel.
+    for (std::size_t length = 0; length <= 200; ++length)
+    {
+      std::vector<std::byte> expected(length);
+      for (std::size_t idx = 0; idx < length; ++idx)
+      {
+        expected[idx] = static_cast<std::byte>(idx * 31 + 7);
+      }
+
+      const std::vector<std::byte> original = expected;
+      XorReference(expected, key);
+
+      for (const auto kernel : Kernels)
+      {
+        if (not server::network::IsXorKernelSupported(kernel))
+          continue;
+
+        std::vector<std::byte> actual = original;
+        server::network::XorInPlace(actual, key, kernel);
+        assert(actual == expected);
+
+        // Applying the key again restores the original data.
+        server::network::XorInPlace(actual, key, kernel);
+        assert(actual == original);
+      }
+
+      std::vector<std::byte> actual = original;
+      server::network::XorInPlace(actual, key);
+      assert(actual == expected);
+    }
+  }
+}
+
+} // namespace
+
+int main()
+{
+  TestXorKernels();
+}
@@ -0,0 +1,73 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "server/tracker/RaceTracker.hpp"
+
+#include <cassert>
+
+namespace
+{
+
+using server::tracker::RaceTracker;
+
+void TestFindRacerByOid()
+{
+  RaceTracker tracker;
+
+  auto& first = tracker.AddRacer(1001);
+  first.clientId = 10;
+  auto& second = tracker.AddRacer(1002);
+  second.clientId = 20;
+
+  // Racers are found by their OIDs.
+  auto* found = tracker.FindRacerByOid(second.oid);
+  assert(found != nullptr);
+  assert(found->clientId == 20);
+  assert(tracker.FindRacerByOid(first.oid)->clientId == 10);
+  assert(tracker.FindRacerByOid(0xFFFF) == nullptr);
+
+  // Removed racers are not found.
+  const auto secondOid = second.oid;
+  tracker.RemoveRacer(1002);
+  assert(tracker.FindRacerByOid(secondOid) == nullptr);
+}
+
+void TestOidsPersistAcrossRaces()
+{
+  RaceTracker tracker;
+
+  const auto oid = tracker.AddRacer(1001).oid;
+  tracker.Clear();
+
+  // The index is cleared with the racers.
+  assert(tracker.FindRacerByOid(oid) == nullptr);
+
+  // The character keeps its OID in the next race.
+  auto& racer = tracker.AddRacer(1001);
+  assert(racer.oid == oid);
+  assert(tracker.FindRacerByOid(oid) == &racer);
+}
+
+} // anon namespace
+
+int main()
+{
+  TestFindRacerByOid();
+  TestOidsPersistAcrossRaces();
+}
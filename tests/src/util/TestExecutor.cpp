@@ -0,0 +1,168 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include <libserver/util/Executor.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using server::Executor;
+
+//! Waits until a condition holds or until a timeout.
+template <typename Condition>
+bool WaitFor(Condition&& condition)
+{
+  const auto timeout = Executor::Clock::now() + std::chrono::seconds(5);
+  while (not condition())
+  {
+    if (Executor::Clock::now() > timeout)
+      return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+void TestTasks()
+{
+  constexpr uint32_t TaskCount = 10000;
+
+  Executor executor;
+  executor.Begin(4);
+  assert(executor.GetThreadCount() == 4);
+
+  // Tasks posted from the outside and by the tasks themselves all execute.
+  std::atomic_uint32_t executions = 0;
+  for (uint32_t taskIdx = 0; taskIdx < TaskCount; ++taskIdx)
+  {
+    executor.Post([&executor, &executions]()
+    {
+      executor.Post([&executions]()
+      {
+        ++executions;
+      });
+    });
+  }
+
+  assert(WaitFor([&executions]() { return executions == TaskCount; }));
+  executor.End();
+}
+
+void TestStrand()
+{
+  constexpr uint32_t ThreadCount = 4;
+  constexpr uint32_t TaskCount = 2000;
+
+  Executor executor;
+  executor.Begin(4);
+
+  Executor::Strand strand(executor);
+
+  // The tasks of a strand never execute concurrently and execute in order.
+  std::atomic_bool isExecuting = false;
+  uint32_t executions = 0;
+  std::vector<uint32_t> order;
+
+  std::vector<std::thread> threads;
+  for (uint32_t threadIdx = 0; threadIdx < ThreadCount; ++threadIdx)
+  {
+    threads.emplace_back([&, threadIdx]()
+    {
+      for (uint32_t taskIdx = 0; taskIdx < TaskCount; ++taskIdx)
+      {
+        strand.Post([&, threadIdx, taskIdx]()
+        {
+          assert(not isExecuting.exchange(true));
+          ++executions;
+          if (threadIdx == 0)
+            order.emplace_back(taskIdx);
+          isExecuting = false;
+        });
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+    thread.join();
+
+  std::promise<uint32_t> result;
+  strand.Post([&executions, &result]()
+  {
+    result.set_value(executions);
+  });
+
+  assert(result.get_future().get() == ThreadCount * TaskCount);
+  assert(std::ranges::is_sorted(order) && order.size() == TaskCount);
+  executor.End();
+}
+
+void TestTimedTasks()
+{
+  using Clock = Executor::Clock;
+
+  Executor executor;
+  executor.Begin(2);
+
+  Executor::Strand strand(executor);
+
+  // Timed tasks execute at their time points, the earlier ones first.
+  const auto start = Clock::now();
+  std::promise<Clock::time_point> laterTask;
+  std::promise<Clock::time_point> earlierTask;
+
+  strand.PostAt([&laterTask]()
+  {
+    laterTask.set_value(Clock::now());
+  }, start + std::chrono::milliseconds(50));
+  executor.PostAt([&earlierTask]()
+  {
+    earlierTask.set_value(Clock::now());
+  }, start + std::chrono::milliseconds(10));
+
+  const auto earlierTime = earlierTask.get_future().get();
+  const auto laterTime = laterTask.get_future().get();
+  assert(earlierTime >= start + std::chrono::milliseconds(10));
+  assert(laterTime >= start + std::chrono::milliseconds(50));
+  assert(earlierTime < laterTime);
+
+  // Timed tasks not yet due are discarded when the executor ends.
+  bool executed = false;
+  executor.PostAt([&executed]()
+  {
+    executed = true;
+  }, Clock::now() + std::chrono::hours(1));
+  executor.End();
+  assert(not executed);
+}
+
+} // anon namespace
+
+int main()
+{
+  TestTasks();
+  TestStrand();
+  TestTimedTasks();
+}
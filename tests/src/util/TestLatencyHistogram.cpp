@@ -0,0 +1,78 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include <libserver/util/LatencyHistogram.hpp>
+
+#include <cassert>
+
+namespace
+{
+
+void TestNoSamples()
+{
+  server::LatencyHistogram histogram;
+  const auto summary = histogram.Summarize();
+  assert(summary.count == 0 && "Count should be zero with no samples");
+  assert(summary.p50.count() == 0 && "Median should be zero with no samples");
+  assert(summary.max.count() == 0 && "Max should be zero with no samples");
+}
+
+void TestPercentiles()
+{
+  using namespace std::chrono_literals;
+
+  server::LatencyHistogram histogram;
+
+  // 98 fast samples and 2 slow samples.
+  for (int idx = 0; idx < 98; ++idx)
+    histogram.Record(3us);
+  histogram.Record(900us);
+  histogram.Record(1500us);
+
+  const auto summary = histogram.Summarize();
+  assert(summary.count == 100 && "Count should match the recorded samples");
+  assert(summary.total == 98 * 3us + 900us + 1500us && "Total should be the sum of the samples");
+  assert(summary.max == 1500us && "Max should be the longest sample");
+
+  // The percentiles are the upper bounds of their buckets.
+  assert(summary.p50 >= 3us && summary.p50 <= 4us && "Median should be in the bucket of the fast samples");
+  assert(summary.p99 >= 900us && summary.p99 <= 1024us && "99th percentile should be in the bucket of the slow sample");
+}
+
+void TestReset()
+{
+  using namespace std::chrono_literals;
+
+  server::LatencyHistogram histogram;
+  histogram.Record(10us);
+  histogram.Reset();
+
+  const auto summary = histogram.Summarize();
+  assert(summary.count == 0 && "Count should be zero after reset");
+  assert(summary.max.count() == 0 && "Max should be zero after reset");
+}
+
+} // namespace
+
+int main()
+{
+  TestNoSamples();
+  TestPercentiles();
+  TestReset();
+}
@@ -24,6 +24,7 @@
 #include <locale>
 #include <regex>
 #include <cstdio>
+#include <string>
 
 namespace
 {
@@ -39,6 +40,71 @@ void TestLocale()
   assert(eucOutput == eucSource);
 }
 
+void TestPlainAscii()
+{
+  assert(server::locale::IsPlainAscii(""));
+  assert(server::locale::IsPlainAscii("Rider"));
+  assert(server::locale::IsPlainAscii("The quick brown fox jumps over the lazy horse"));
+
+  // Non-ASCII and null characters at every position of the SIMD and the word loops.
+  for (std::size_t length = 1; length <= 40; ++length)
+  {
+    for (std::size_t position = 0; position < length; ++position)
+    {
+      std::string text(length, 'a');
+      assert(server::locale::IsPlainAscii(text));
+
+      text[position] = '\x80';
+      assert(not server::locale::IsPlainAscii(text));
+      text[position] = '\xff';
+      assert(not server::locale::IsPlainAscii(text));
+      text[position] = '\0';
+      assert(not server::locale::IsPlainAscii(text));
+    }
+  }
+
+  // Plain ASCII strings are converted as they are.
+  const std::string ascii = "Rider(1)";
+  assert(server::locale::ToUtf8(ascii) == ascii);
+  assert(server::locale::FromUtf8(ascii) == ascii);
+
+  // Mixed strings are converted through ICU.
+  const std::string eucMixed = "Rider\xb1\xb8";
+  const std::string utfMixed = "Rider\xea\xb5\xac";
+  assert(server::locale::ToUtf8(eucMixed) == utfMixed);
+  assert(server::locale::FromUtf8(utfMixed) == eucMixed);
+}
+
+void TestConversionCache()
+{
+  // Repeated conversions are served from the cache and must stay the same.
+  for (std::size_t idx = 0; idx < 4; ++idx)
+  {
+    assert(server::locale::ToUtf8("\xb1\xb8") == "\xea\xb5\xac");
+    assert(server::locale::FromUtf8("\xea\xb5\xac") == "\xb1\xb8");
+  }
+
+  // Enough distinct strings to evict the cached conversions.
+  for (uint32_t idx = 0; idx < 1024; ++idx)
+  {
+    const std::string suffix = std::to_string(idx);
+    assert(server::locale::ToUtf8("\xb1\xb8" + suffix) == "\xea\xb5\xac" + suffix);
+    assert(server::locale::FromUtf8("\xea\xb5\xac" + suffix) == "\xb1\xb8" + suffix);
+  }
+
+  assert(server::locale::ToUtf8("\xb1\xb8") == "\xea\xb5\xac");
+  assert(server::locale::FromUtf8("\xea\xb5\xac") == "\xb1\xb8");
+
+  // Strings too long to be cached are converted every time.
+  const std::string eucLong = std::string(100, 'a') + "\xb1\xb8";
+  const std::string utfLong = std::string(100, 'a') + "\xea\xb5\xac";
+  for (std::size_t idx = 0; idx < 2; ++idx)
+  {
+    assert(server::locale::ToUtf8(eucLong) == utfLong);
+    assert(server::locale::FromUtf8(utfLong) == eucLong);
+  }
+}
+
 void TestNameValidation()
 {
   constexpr std::array validNames = {
@@ -92,5 +158,7 @@ void TestNameValidation()
 int main()
 {
   TestLocale();
+  TestPlainAscii();
+  TestConversionCache();
   TestNameValidation();
 }
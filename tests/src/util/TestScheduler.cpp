@@ -19,8 +19,14 @@
 
 #include <libserver/util/Scheduler.hpp>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 namespace
 {
@@ -87,10 +93,294 @@ void TestScheduledTasks()
   assert(delayedTaskExecuted && "Task queued for execution with a delay not executed within a timeout");
 }
 
+
+void TestDrainedTasks()
+{
+  server::Scheduler scheduler;
+
+  // Every due task executes in a single tick, even the failing ones
+  // do not prevent the others from executing.
+  std::vector<uint32_t> order;
+  for (uint32_t taskIdx = 0; taskIdx < 100; ++taskIdx)
+  {
+    scheduler.Queue([&order, taskIdx]()
+    {
+      order.emplace_back(taskIdx);
+      if (taskIdx == 50)
+        throw std::runtime_error("Failing task");
+    });
+  }
+
+  scheduler.Tick();
+  assert(order.size() == 100);
+  assert(std::ranges::is_sorted(order));
+  assert(scheduler.GetJobCount() == 0);
+
+  // Tasks queued by an executing task execute in the next tick.
+  uint32_t executions = 0;
+  std::function<void()> requeue;
+  requeue = [&scheduler, &executions, &requeue]()
+  {
+    ++executions;
+    scheduler.Queue(requeue);
+  };
+  scheduler.Queue(requeue);
+
+  scheduler.Tick();
+  assert(executions == 1);
+  scheduler.Tick();
+  assert(executions == 2);
+}
+
+void TestCancelledTasks()
+{
+  server::Scheduler scheduler;
+
+  bool immediateTaskExecuted = false;
+  bool delayedTaskExecuted = false;
+
+  auto immediateHandle = scheduler.Queue([&immediateTaskExecuted]()
+  {
+    immediateTaskExecuted = true;
+  });
+  auto delayedHandle = scheduler.Queue([&delayedTaskExecuted]()
+  {
+    delayedTaskExecuted = true;
+  }, server::Scheduler::Clock::now() + std::chrono::milliseconds(5));
+
+  assert(immediateHandle.Cancel());
+  // Jobs can be cancelled only once.
+  assert(not immediateHandle.Cancel());
+  assert(delayedHandle.Cancel());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  scheduler.Tick();
+  assert(not immediateTaskExecuted);
+  assert(not delayedTaskExecuted);
+
+  // Executed jobs can not be cancelled.
+  auto executedHandle = scheduler.Queue([](){});
+  scheduler.Tick();
+  assert(not executedHandle.Cancel());
+
+  // Default handles do not refer to any job.
+  assert(not server::Scheduler::JobHandle{}.Cancel());
+}
+
+void TestTickBudget()
+{
+  server::Scheduler scheduler;
+  scheduler.SetTickBudget(std::chrono::milliseconds(1));
+
+  // Each task takes the whole budget, so one executes per tick.
+  uint32_t executions = 0;
+  for (uint32_t taskIdx = 0; taskIdx < 3; ++taskIdx)
+  {
+    scheduler.Queue([&executions]()
+    {
+      ++executions;
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    });
+  }
+
+  scheduler.Tick();
+  assert(executions == 1);
+  assert(scheduler.GetJobCount() == 2);
+
+  // Without a budget the remaining tasks execute at once.
+  scheduler.SetTickBudget(server::Scheduler::Clock::duration::zero());
+  scheduler.Tick();
+  assert(executions == 3);
+}
+
+void TestWheelDelays()
+{
+  using Clock = server::Scheduler::Clock;
+
+  server::Scheduler scheduler;
+
+  // Delays in the ranges of the first three wheels.
+  const std::array delays{
+    std::chrono::milliseconds(3),
+    std::chrono::milliseconds(70),
+    std::chrono::milliseconds(130),
+    std::chrono::milliseconds(4200)};
+
+  const auto start = Clock::now();
+  std::array<Clock::time_point, delays.size()> executedAt{};
+  for (std::size_t delayIdx = 0; delayIdx < delays.size(); ++delayIdx)
+  {
+    scheduler.Queue([&executedAt, delayIdx]()
+    {
+      executedAt[delayIdx] = Clock::now();
+    }, start + delays[delayIdx]);
+  }
+
+  const auto timeout = start + delays.back() + std::chrono::seconds(1);
+  while (scheduler.GetJobCount() > 0 && Clock::now() < timeout)
+  {
+    scheduler.Tick();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // The tasks execute in time, never before their time point.
+  for (std::size_t delayIdx = 0; delayIdx < delays.size(); ++delayIdx)
+  {
+    assert(executedAt[delayIdx] >= start + delays[delayIdx]);
+    assert(executedAt[delayIdx] < start + delays[delayIdx] + std::chrono::milliseconds(500));
+  }
+}
+
+void TestWakeHandler()
+{
+  server::Scheduler scheduler;
+
+  uint32_t wakeCount = 0;
+  scheduler.SetWakeHandler([&wakeCount]()
+  {
+    ++wakeCount;
+  });
+
+  // Only the jobs due immediately wake the owner up, the delayed ones are left to the ticks.
+  scheduler.Queue([](){});
+  assert(wakeCount == 1);
+  scheduler.Queue([](){}, server::Scheduler::Clock::now() + std::chrono::seconds(10));
+  assert(wakeCount == 1);
+}
+
+//! Tests an owner sleeping until the next due time of the scheduler.
+void TestNextDueTime()
+{
+  using Clock = server::Scheduler::Clock;
+
+  server::Scheduler scheduler;
+  assert(scheduler.GetNextDueTime() == Clock::time_point::max());
+
+  uint32_t wakeCount = 0;
+  scheduler.SetWakeHandler([&wakeCount]()
+  {
+    ++wakeCount;
+  });
+
+  const auto start = Clock::now();
+  const std::array delays{
+    std::chrono::milliseconds(130),
+    std::chrono::milliseconds(70),
+    std::chrono::milliseconds(3)};
+
+  std::array<Clock::time_point, delays.size()> executedAt{};
+  for (std::size_t delayIdx = 0; delayIdx < delays.size(); ++delayIdx)
+  {
+    const auto when = start + delays[delayIdx];
+    scheduler.Queue([&executedAt, delayIdx]()
+    {
+      executedAt[delayIdx] = Clock::now();
+    }, when);
+
+    // The next due time never follows the earliest job and the jobs queued
+    // before the previous next due time wake the owner up.
+    assert(wakeCount == delayIdx + 1);
+    assert(scheduler.GetNextDueTime() < when + std::chrono::milliseconds(1));
+  }
+
+  // The later jobs do not wake the owner up.
+  scheduler.Queue([](){}, start + std::chrono::seconds(10));
+  assert(wakeCount == delays.size());
+
+  uint32_t tickCount = 0;
+  while (executedAt[0] == Clock::time_point{})
+  {
+    std::this_thread::sleep_until(scheduler.GetNextDueTime());
+    scheduler.Tick();
+    ++tickCount;
+  }
+
+  // The jobs execute in time with a few ticks only.
+  for (std::size_t delayIdx = 0; delayIdx < delays.size(); ++delayIdx)
+    assert(executedAt[delayIdx] >= start + delays[delayIdx]);
+  assert(tickCount < 20);
+
+  // The jobs due immediately are due right away.
+  scheduler.Queue([](){});
+  assert(scheduler.GetNextDueTime() == Clock::time_point::min());
+}
+
+//! Tests the wake handler set while the jobs are queued from another thread.
+void TestConcurrentWakeHandler()
+{
+  server::Scheduler scheduler;
+  std::atomic_uint32_t wakeCount = 0;
+  std::atomic_bool isHandlerSet = false;
+
+  std::thread queueThread([&scheduler, &isHandlerSet]()
+  {
+    // Keep queueing until a few jobs are queued after the handler is set.
+    for (uint32_t jobIdx = 0; jobIdx < 100; )
+    {
+      scheduler.Queue([](){});
+      if (isHandlerSet)
+        ++jobIdx;
+    }
+  });
+
+  scheduler.SetWakeHandler([&wakeCount]()
+  {
+    ++wakeCount;
+  });
+  isHandlerSet = true;
+
+  queueThread.join();
+  assert(wakeCount >= 100);
+}
+
+void TestConcurrentQueue()
+{
+  constexpr uint32_t ThreadCount = 4;
+  constexpr uint32_t TaskCount = 1000;
+
+  server::Scheduler scheduler;
+  std::atomic_uint32_t executions = 0;
+  std::atomic_uint32_t finishedThreads = 0;
+
+  std::vector<std::thread> threads;
+  for (uint32_t threadIdx = 0; threadIdx < ThreadCount; ++threadIdx)
+  {
+    threads.emplace_back([&scheduler, &executions, &finishedThreads]()
+    {
+      for (uint32_t taskIdx = 0; taskIdx < TaskCount; ++taskIdx)
+      {
+        scheduler.Queue([&executions]()
+        {
+          ++executions;
+        });
+      }
+      ++finishedThreads;
+    });
+  }
+
+  // Tick while the tasks are being queued.
+  while (finishedThreads < ThreadCount)
+    scheduler.Tick();
+
+  for (auto& thread : threads)
+    thread.join();
+
+  scheduler.Tick();
+  assert(executions == ThreadCount * TaskCount);
+}
+
 } // namespace
 
 int main()
 {
   TestSequencedTasks();
   TestScheduledTasks();
+  TestDrainedTasks();
+  TestCancelledTasks();
+  TestTickBudget();
+  TestWheelDelays();
+  TestWakeHandler();
+  TestNextDueTime();
+  TestConcurrentWakeHandler();
+  TestConcurrentQueue();
 }
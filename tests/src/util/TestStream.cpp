@@ -21,7 +21,9 @@
 
 #include <boost/asio/streambuf.hpp>
 
+#include <array>
 #include <cassert>
+#include <vector>
 
 namespace
 {
@@ -48,6 +50,15 @@ struct Datum
   }
 };
 
+struct Position
+{
+  float x{};
+  float y{};
+  float z{};
+
+  static constexpr bool IsBulkCopyable = true;
+};
+
 //! Perform test of magic encoding/decoding.
 void TestStreams()
 {
@@ -88,9 +99,138 @@ void TestStreams()
   assert(source.GetCursor() == 4 * sizeof(uint32_t) + 1);
 }
 
+//! Perform test of the bulk copies of the contiguous values.
+void TestBulkCopy()
+{
+  static_assert(server::BulkCopyable<uint32_t>);
+  static_assert(server::BulkCopyable<Position>);
+  static_assert(not server::BulkCopyable<Datum>);
+
+  const std::array<Position, 3> positions{
+    Position{1.0f, 2.0f, 3.0f},
+    Position{4.0f, 5.0f, 6.0f},
+    Position{7.0f, 8.0f, 9.0f}};
+  const std::vector<uint32_t> uids{1, 2, 3, 4};
+
+  std::array<std::byte, 64> buffer{};
+  server::SinkStream sink(buffer);
+  sink.Write(std::span(positions))
+    .Write(std::span(uids));
+  assert(sink.GetCursor() == sizeof(positions) + uids.size() * sizeof(uint32_t));
+
+  // The values must be laid out the same as when written one by one.
+  std::array<std::byte, 64> expectedBuffer{};
+  server::SinkStream expectedSink(expectedBuffer);
+  for (const auto& position : positions)
+    expectedSink.Write(position.x).Write(position.y).Write(position.z);
+  for (const auto uid : uids)
+    expectedSink.Write(uid);
+  assert(buffer == expectedBuffer);
+
+  std::array<Position, 3> readPositions{};
+  std::vector<uint32_t> readUids(uids.size());
+  server::SourceStream source({buffer.data(), sink.GetCursor()});
+  source.Read(std::span(readPositions))
+    .Read(std::span(readUids));
+
+  assert(readUids == uids);
+  for (std::size_t idx = 0; idx < positions.size(); ++idx)
+  {
+    assert(readPositions[idx].x == positions[idx].x);
+    assert(readPositions[idx].z == positions[idx].z);
+  }
+
+  // Reading past the end fails without reading.
+  bool failed = false;
+  try
+  {
+    source.Read(std::span(readUids));
+  }
+  catch (const std::overflow_error&)
+  {
+    failed = true;
+  }
+  assert(failed);
+  assert(source.GetCursor() == sink.GetCursor());
+}
+
+//! Perform test of the writes to a reserved region.
+void TestReserve()
+{
+  std::array<std::byte, 16> buffer{};
+  server::SinkStream sink(buffer);
+  sink.Write(static_cast<uint8_t>(0xAA));
+
+  const std::array<uint16_t, 2> values{0x1122, 0x3344};
+  sink.Reserve(sizeof(uint32_t) + sizeof(values))
+    .Write(static_cast<uint32_t>(0xCAFEBABE))
+    .Write(std::span(values));
+  assert(sink.GetCursor() == 1 + sizeof(uint32_t) + sizeof(values));
+
+  // The reservation over the end of the buffer fails.
+  bool failed = false;
+  try
+  {
+    std::ignore = sink.Reserve(buffer.size());
+  }
+  catch (const std::overflow_error&)
+  {
+    failed = true;
+  }
+  assert(failed);
+
+  uint8_t byte{};
+  uint32_t word{};
+  std::array<uint16_t, 2> readValues{};
+  server::SourceStream source(buffer);
+  source.Read(byte)
+    .Read(word)
+    .Read(std::span(readValues));
+
+  assert(byte == 0xAA);
+  assert(word == 0xCAFEBABE);
+  assert(readValues == values);
+}
+
+//! Perform test of the string reading and writing.
+void TestStrings()
+{
+  std::array<std::byte, 32> buffer{};
+  server::SinkStream sink(buffer);
+  sink.Write(std::string("alicia"))
+    .Write(std::string());
+  assert(sink.GetCursor() == 8);
+
+  std::string first;
+  std::string second = "not empty";
+  server::SourceStream source({buffer.data(), sink.GetCursor()});
+  source.Read(first)
+    .Read(second);
+
+  assert(first == "alicia");
+  assert(second.empty());
+  assert(source.GetCursor() == 8);
+
+  // A string without the terminator fails.
+  server::SourceStream unterminatedSource({buffer.data(), 3});
+  bool failed = false;
+  try
+  {
+    unterminatedSource.Read(first);
+  }
+  catch (const std::overflow_error&)
+  {
+    failed = true;
+  }
+  assert(failed);
+}
+
 } // namespace
 
 int main()
 {
   TestStreams();
+  TestBulkCopy();
+  TestReserve();
+  TestStrings();
 }
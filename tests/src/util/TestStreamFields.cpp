@@ -0,0 +1,170 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include <libserver/util/StreamFields.hpp>
+
+#include <cassert>
+
+namespace
+{
+
+//! A structure with the padding between some of its fields.
+struct Padded
+{
+  uint16_t val0{};
+  // Padding of two bytes.
+  uint32_t val1{};
+  uint64_t val2{};
+  uint16_t val3{};
+  std::array<std::byte, 5> val4{};
+  // Padding of one byte.
+  float val5{};
+};
+
+using PaddedFields = server::StreamFields<
+  STREAM_FIELD(Padded, val0),
+  STREAM_FIELD(Padded, val1),
+  STREAM_FIELD(Padded, val2),
+  STREAM_FIELD(Padded, val3),
+  STREAM_FIELD(Padded, val4),
+  STREAM_FIELD(Padded, val5)>;
+
+//! A structure with the fields which are not bulk copyable.
+struct Mixed
+{
+  uint32_t val0{};
+  uint32_t val1{};
+  std::string val2{};
+  uint8_t val3{};
+};
+
+using MixedFields = server::StreamFields<
+  STREAM_FIELD(Mixed, val0),
+  STREAM_FIELD(Mixed, val1),
+  STREAM_FIELD(Mixed, val2),
+  STREAM_FIELD(Mixed, val3)>;
+
+//! A structure with the fields listed out of their memory order.
+using ReorderedFields = server::StreamFields<
+  STREAM_FIELD(Padded, val2),
+  STREAM_FIELD(Padded, val1),
+  STREAM_FIELD(Padded, val0)>;
+
+//! Perform test of the runs of the fields.
+void TestRuns()
+{
+  // The padding splits the fields into three runs.
+  static_assert(PaddedFields::CopyCount == 3);
+  static_assert(PaddedFields::FixedSize == 2 + 4 + 8 + 2 + 5 + 4);
+
+  // The string is not bulk copyable, the structure has no fixed size.
+  static_assert(MixedFields::CopyCount == 3);
+  static_assert(MixedFields::FixedSize == 0);
+
+  // The runs follow the order of the list, not of the memory.
+  static_assert(ReorderedFields::CopyCount == 3);
+}
+
+//! Perform test of the stream representation, which must be the same
+//! as when the fields are written one by one.
+void TestPadded()
+{
+  const Padded value{
+    .val0 = 0x1122,
+    .val1 = 0x33445566,
+    .val2 = 0x778899AABBCCDDEE,
+    .val3 = 0xF00D,
+    .val4 = {std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}, std::byte{5}},
+    .val5 = 1.5f};
+
+  std::array<std::byte, 64> buffer{};
+  server::SinkStream sink(buffer);
+  PaddedFields::Write(value, sink);
+  assert(sink.GetCursor() == PaddedFields::FixedSize);
+
+  std::array<std::byte, 64> expectedBuffer{};
+  server::SinkStream expectedSink(expectedBuffer);
+  expectedSink.Write(value.val0)
+    .Write(value.val1)
+    .Write(value.val2)
+    .Write(value.val3)
+    .Write(std::span(value.val4))
+    .Write(value.val5);
+  assert(buffer == expectedBuffer);
+
+  Padded readValue{};
+  server::SourceStream source({buffer.data(), sink.GetCursor()});
+  PaddedFields::Read(readValue, source);
+
+  assert(source.GetCursor() == PaddedFields::FixedSize);
+  assert(readValue.val0 == value.val0);
+  assert(readValue.val1 == value.val1);
+  assert(readValue.val2 == value.val2);
+  assert(readValue.val3 == value.val3);
+  assert(readValue.val4 == value.val4);
+  assert(readValue.val5 == value.val5);
+
+  // The fixed size structure does not fit.
+  std::array<std::byte, PaddedFields::FixedSize - 1> smallBuffer{};
+  server::SinkStream smallSink(smallBuffer);
+  bool failed = false;
+  try
+  {
+    PaddedFields::Write(value, smallSink);
+  }
+  catch (const std::overflow_error&)
+  {
+    failed = true;
+  }
+  assert(failed);
+  assert(smallSink.GetCursor() == 0);
+}
+
+//! Perform test of the structure with the fields which are not bulk copyable.
+void TestMixed()
+{
+  const Mixed value{
+    .val0 = 0xCAFE,
+    .val1 = 0xBABE,
+    .val2 = "alicia",
+    .val3 = 0xAA};
+
+  std::array<std::byte, 64> buffer{};
+  server::SinkStream sink(buffer);
+  MixedFields::Write(value, sink);
+  assert(sink.GetCursor() == 4 + 4 + 7 + 1);
+
+  Mixed readValue{};
+  server::SourceStream source({buffer.data(), sink.GetCursor()});
+  MixedFields::Read(readValue, source);
+
+  assert(readValue.val0 == value.val0);
+  assert(readValue.val1 == value.val1);
+  assert(readValue.val2 == value.val2);
+  assert(readValue.val3 == value.val3);
+}
+
+} // anon namespace
+
+int main()
+{
+  TestRuns();
+  TestPadded();
+  TestMixed();
+}
@@ -0,0 +1,118 @@
+/**
+ * Alicia Server - dedicated server software
+ * Copyright (C) 2026 Story Of Alicia
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ **/
+
+#include "libserver/util/Scheduler.hpp"
+#include "libserver/util/TickProfile.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+
+using server::Scheduler;
+using server::TickProfile;
+
+struct FastWork {};
+struct SlowWork {};
+
+//! Tests only the slowest work items are kept, the slowest first.
+void TestSlowestSamples()
+{
+  TickProfile profile;
+
+  // Without a current profile, the samples are dropped.
+  assert(not TickProfile::IsActive());
+  TickProfile::Record("job", typeid(SlowWork), std::chrono::seconds(1));
+  assert(profile.GetSlowestSamples().empty());
+
+  {
+    const TickProfile::Scope scope(profile);
+    assert(TickProfile::IsActive());
+
+    for (int64_t duration = 1; duration <= 10; ++duration)
+      TickProfile::Record("job", typeid(FastWork), std::chrono::milliseconds(duration));
+    TickProfile::Record("deferred command", typeid(SlowWork), std::chrono::milliseconds(7));
+  }
+  assert(not TickProfile::IsActive());
+
+  const auto samples = profile.GetSlowestSamples();
+  assert(samples.size() == TickProfile::MaxSampleCount);
+  assert(samples[0].duration == std::chrono::milliseconds(10));
+  assert(samples[1].duration == std::chrono::milliseconds(9));
+  assert(samples[2].duration == std::chrono::milliseconds(8));
+  // Equal durations keep the earlier work item first.
+  assert(samples[3].duration == std::chrono::milliseconds(7) && *samples[3].type == typeid(FastWork));
+  assert(samples[4].duration == std::chrono::milliseconds(7) && *samples[4].type == typeid(SlowWork));
+  assert(samples[4].kind == "deferred command");
+
+  const auto formatted = profile.FormatSlowestSamples();
+  assert(formatted.find("SlowWork") != std::string::npos);
+  assert(formatted.find("10000us") != std::string::npos);
+}
+
+//! Tests the nested profiles restore the outer one.
+void TestNestedScopes()
+{
+  TickProfile outer;
+  TickProfile inner;
+
+  const TickProfile::Scope outerScope(outer);
+  {
+    const TickProfile::Scope innerScope(inner);
+    TickProfile::Record("job", typeid(FastWork), std::chrono::milliseconds(1));
+  }
+  TickProfile::Record("job", typeid(SlowWork), std::chrono::milliseconds(2));
+
+  assert(inner.GetSlowestSamples().size() == 1);
+  assert(outer.GetSlowestSamples().size() == 1);
+  assert(*outer.GetSlowestSamples()[0].type == typeid(SlowWork));
+}
+
+//! Tests the jobs of a scheduler are recorded into the current profile.
+void TestSchedulerJobs()
+{
+  Scheduler scheduler;
+  scheduler.Queue([]()
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  });
+  scheduler.Queue([]() {});
+
+  TickProfile profile;
+  {
+    const TickProfile::Scope scope(profile);
+    scheduler.Tick();
+  }
+
+  const auto samples = profile.GetSlowestSamples();
+  assert(samples.size() == 2);
+  assert(samples[0].kind == "job");
+  assert(samples[0].duration >= std::chrono::milliseconds(5));
+}
+
+} // anon namespace
+
+int main()
+{
+  TestSlowestSamples();
+  TestNestedScopes();
+  TestSchedulerJobs();
+}